@@ -0,0 +1,60 @@
+/*
+ * coherence_metrics_table.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef COHERENCE_METRICS_TABLE_H
+#define COHERENCE_METRICS_TABLE_H
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+
+#include "variation_unit.h"
+#include "textual_flow.h"
+#include "textual_flow_builder.h"
+#include "json_writer.h"
+
+/**
+ * Data structure representing the coherence of the attestation of a single reading.
+ */
+struct reading_coherence {
+	std::string rdg; //ID of the reading
+	int wits; //number of witnesses with this reading
+	int roots; //number of witnesses with this reading whose textual flow ancestor does not have it (1 if the attestation is coherent)
+};
+
+/**
+ * Data structure representing a row of the coherence metrics table.
+ */
+struct coherence_metrics_table_row {
+	std::string id; //ID of the variation unit
+	std::string label; //label of the variation unit
+	int connectivity; //connectivity limit of the textual flow diagram
+	int change; //number of CHANGE edges in the textual flow diagram
+	int loss; //number of LOSS edges in the textual flow diagram
+	int max_con; //maximum connectivity rank of any edge in the textual flow diagram (-1 if it has no edges)
+	std::list<reading_coherence> rdgs; //coherence of the attestation of each reading, in the variation unit's reading order
+};
+
+class coherence_metrics_table {
+private:
+	std::list<coherence_metrics_table_row> rows;
+	static coherence_metrics_table_row get_row(const variation_unit & vu, const textual_flow & tf);
+public:
+	coherence_metrics_table();
+	coherence_metrics_table(const textual_flow_builder & tfb, const std::vector<variation_unit> & vus, int connectivity);
+	coherence_metrics_table(const textual_flow_builder & tfb, const std::vector<variation_unit> & vus);
+	virtual ~coherence_metrics_table();
+	std::list<coherence_metrics_table_row> get_rows() const;
+	void to_fixed_width(std::ostream & out);
+	void to_csv(std::ostream & out);
+	void to_tsv(std::ostream & out);
+	void to_json(json_writer & writer);
+	void to_json(std::ostream & out);
+};
+
+#endif /* COHERENCE_METRICS_TABLE_H */
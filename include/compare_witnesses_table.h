@@ -14,6 +14,7 @@
 #include <set>
 
 #include "witness.h"
+#include "json_writer.h"
 
  /**
  * Data structure representing a row of the witness comparison table.
@@ -40,7 +41,8 @@ private:
 	std::list<compare_witnesses_table_row> rows;
 public:
 	compare_witnesses_table();
-	compare_witnesses_table(const witness & wit, const std::list<std::string> list_wit, const std::set<std::string> & filter_wits);
+	compare_witnesses_table(const witness & wit, const std::list<std::string> & list_wit, const std::set<std::string> & filter_wits);
+	compare_witnesses_table(const std::string & _id, int _primary_extant, const std::list<compare_witnesses_table_row> & _rows);
 	virtual ~compare_witnesses_table();
     std::string get_id() const;
     int get_primary_extant() const;
@@ -48,6 +50,7 @@ public:
     void to_fixed_width(std::ostream & out);
 	void to_csv(std::ostream & out);
     void to_tsv(std::ostream & out);
+    void to_json(json_writer & writer);
     void to_json(std::ostream & out);
 };
 
@@ -0,0 +1,64 @@
+/*
+ * comparison_matrix.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef COMPARISON_MATRIX_H
+#define COMPARISON_MATRIX_H
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+#include <set>
+#include <cstdint>
+
+#include "witness.h"
+#include "compare_witnesses_table.h"
+
+/**
+ * Matrix of the genealogical comparison metrics of the witness comparison table for every ordered pair of witnesses,
+ * stored column by column, with each column holding one metric for all pairs in row-major order (primary witness, then secondary witness).
+ * The diagonal holds each witness's comparison with itself, so its PASS value is the number of passages where the witness is extant.
+ *
+ * The binary export consists of a header followed by one typed block per column, all in little-endian byte order:
+ * the 8-byte magic string "OCBGMCMP", then the format version, the number of witnesses W, and the number of columns (each a uint32);
+ * then each witness ID (a uint32 byte length followed by its bytes);
+ * then for each column, its name and its NumPy-style type string ("<i4" or "<f4"; each a uint32 byte length followed by its bytes),
+ * followed by the uint64 offset of its block from the start of the file and the uint64 byte length of its block.
+ * Each block holds W * W values and starts at an offset that is a multiple of 8 bytes.
+ * Individual columns can also be written as NumPy .npy files, with the witness IDs written to a sidecar text file.
+ */
+class comparison_matrix {
+private:
+	std::vector<std::string> ids;
+	std::vector<int32_t> dir; //-1 if the primary witness is prior; 1 if posterior; 0 otherwise
+	std::vector<int32_t> nr; //rank of the secondary witness as a potential ancestor of the primary witness (0 if neither is prior, -1 if the primary witness is prior)
+	std::vector<int32_t> pass;
+	std::vector<int32_t> eq;
+	std::vector<float> perc;
+	std::vector<int32_t> prior;
+	std::vector<int32_t> posterior;
+	std::vector<int32_t> norel;
+	std::vector<int32_t> uncl;
+	std::vector<int32_t> expl;
+	std::vector<float> cost; //-1 if the secondary witness is not a potential ancestor of the primary witness
+	std::string get_column_data(unsigned int col_ind) const;
+public:
+	comparison_matrix();
+	comparison_matrix(const std::list<witness> & witnesses, unsigned int threads=1);
+	comparison_matrix(std::istream & in);
+	virtual ~comparison_matrix();
+	std::vector<std::string> get_ids() const;
+	unsigned int size() const;
+	compare_witnesses_table_row get_entry(unsigned int primary_ind, unsigned int secondary_ind) const;
+	std::vector<compare_witnesses_table> get_compare_witnesses_tables(const std::set<std::string> & filter_wits=std::set<std::string>(), unsigned int top_k=0, unsigned int threads=1) const;
+	void to_binary(std::ostream & out) const;
+	void to_npy(std::ostream & out, const std::string & column) const;
+	void ids_to_txt(std::ostream & out) const;
+	void to_npy_files(const std::string & prefix) const;
+};
+
+#endif /* COMPARISON_MATRIX_H */
@@ -0,0 +1,77 @@
+/*
+ * dense_bitset.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef DENSE_BITSET_H
+#define DENSE_BITSET_H
+
+#include <cstdint>
+
+/**
+ * Fixed-width dense bitset consisting of W 64-bit words.
+ * Since the width is known at compile time, all operations are simple word loops that the compiler can unroll and vectorize,
+ * which makes this faster than a Roaring bitmap for unions and subset checks over small, dense universes
+ * (e.g., columns ranked within a set cover target).
+ */
+template <unsigned int W>
+class dense_bitset {
+private:
+	uint64_t words[W];
+public:
+	/**
+	 * Default constructor. Initializes an empty bitset.
+	 */
+	dense_bitset() {
+		clear();
+	}
+	/**
+	 * Default destructor.
+	 */
+	~dense_bitset() {
+
+	}
+	/**
+	 * Unsets all bits.
+	 */
+	void clear() {
+		for (unsigned int i = 0; i < W; i++) {
+			words[i] = 0;
+		}
+	}
+	/**
+	 * Sets the bit at the given index (assumed to be less than 64 * W).
+	 */
+	void add(unsigned int index) {
+		words[index >> 6] |= uint64_t(1) << (index & 63);
+	}
+	/**
+	 * Returns true if the bit at the given index is set.
+	 */
+	bool contains(unsigned int index) const {
+		return (words[index >> 6] >> (index & 63)) & 1;
+	}
+	/**
+	 * Returns true if every bit set in this bitset is also set in the given bitset.
+	 */
+	bool is_subset(const dense_bitset<W> & other) const {
+		uint64_t missing = 0;
+		for (unsigned int i = 0; i < W; i++) {
+			missing |= words[i] & ~other.words[i];
+		}
+		return missing == 0;
+	}
+	/**
+	 * Sets all bits that are set in the given bitset.
+	 */
+	dense_bitset<W> & operator|=(const dense_bitset<W> & other) {
+		for (unsigned int i = 0; i < W; i++) {
+			words[i] |= other.words[i];
+		}
+		return *this;
+	}
+};
+
+#endif /* DENSE_BITSET_H */
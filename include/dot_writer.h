@@ -0,0 +1,44 @@
+/*
+ * dot_writer.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef DOT_WRITER_H
+#define DOT_WRITER_H
+
+#include <iostream>
+#include <string>
+
+/**
+ * Buffered writer for Graphviz .dot output.
+ * Text is appended to an internal buffer, which is written to the output stream in chunks whenever it fills up and when the writer is flushed or destroyed,
+ * so that a graph with many edges can be streamed to a file without being assembled in memory first.
+ * Edges are written with their attributes in a bracketed, comma-separated list, so callers only need to supply each attribute fragment (e.g., "color=blue").
+ */
+class dot_writer {
+private:
+	std::ostream * out;
+	std::string buffer;
+	size_t buffer_size;
+	bool edge_has_attributes = false;
+	void flush_if_full();
+public:
+	dot_writer(std::ostream & _out, size_t _buffer_size=65536);
+	virtual ~dot_writer();
+	static const char * strength_style(float strength);
+	void write(const std::string & s);
+	void write(const char * s);
+	void write(char c);
+	void write(int n);
+	void write(unsigned int n);
+	void write_fixed(double x, int precision);
+	void begin_edge(unsigned int ancestor_ind, unsigned int descendant_ind);
+	void attribute(const char * fragment);
+	void attribute(const std::string & fragment);
+	void end_edge();
+	void flush();
+};
+
+#endif /* DOT_WRITER_H */
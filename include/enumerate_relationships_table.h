@@ -13,23 +13,48 @@
 #include <list>
 #include <vector>
 #include <set>
+#include <functional>
 
+#include <roaring/roaring.hh>
 #include "witness.h"
+#include "json_writer.h"
 
+/**
+ * Enumeration of the bits of a variation unit's relationship code,
+ * each of which is set if the corresponding relationship holds between the two witnesses at that variation unit.
+ */
+enum relationship_code {
+	RELATIONSHIP_EXTANT = 1,
+	RELATIONSHIP_AGREE = 2,
+	RELATIONSHIP_PRIOR = 4,
+	RELATIONSHIP_POSTERIOR = 8,
+	RELATIONSHIP_NOREL = 16,
+	RELATIONSHIP_UNCLEAR = 32,
+	RELATIONSHIP_EXPLAINED = 64
+};
+
+/**
+ * Table enumerating the passages at which two witnesses have each type of genealogical relationship.
+ * The table refers to the genealogical comparison and the vector of variation unit IDs it was constructed from, rather than copying them,
+ * so both must outlive it (and temporaries are rejected at compile time); its writers iterate over the comparison's bitmaps directly.
+ * A witness's stored comparison can be passed without copying it through witness::get_genealogical_comparison_ref.
+ */
 class enumerate_relationships_table {
 private:
     std::string primary_wit_id;//ID of the primary witness
 	std::string secondary_wit_id; //ID of the secondary witness
-	std::list<std::string> extant; //list of passages where both witnesses are extant
-	std::list<std::string> agreements; //list of passages where both witnesses agree
-	std::list<std::string> prior; //list of passages where the primary witness has a prior reading
-	std::list<std::string> posterior; //list of passages where the primary witness has a posterior reading
-	std::list<std::string> norel; //list of passages where both witnesses' readings are known to have no directed relationship
-    std::list<std::string> unclear; //list of passages where the witnesses' readings have an unclear relationship
-    std::list<std::string> explained; //list of passages where the primary witness has a reading explained by that of the secondary witness
+	const genealogical_comparison * comp; //genealogical comparison whose passage bitmaps this table enumerates
+	const std::vector<std::string> * variation_unit_ids; //IDs of the variation units, indexed by their positions in the bitmaps
+	std::list<std::string> get_passages(const roaring::Roaring & passages) const;
+	void passages_to_text(std::ostream & out, const roaring::Roaring & passages, const std::string & indent) const;
+	void for_each_relationship_code(const std::function<void(uint32_t, unsigned int)> & f) const;
 public:
 	enumerate_relationships_table();
-	enumerate_relationships_table(const genealogical_comparison & comp, const std::vector<std::string> & variation_unit_ids);
+	enumerate_relationships_table(const genealogical_comparison & _comp, const std::vector<std::string> & _variation_unit_ids);
+	//The table refers to its arguments, so temporaries (e.g., the copy returned by witness::get_genealogical_comparison_for_witness) are not allowed:
+	enumerate_relationships_table(genealogical_comparison && _comp, const std::vector<std::string> & _variation_unit_ids) = delete;
+	enumerate_relationships_table(const genealogical_comparison & _comp, std::vector<std::string> && _variation_unit_ids) = delete;
+	enumerate_relationships_table(genealogical_comparison && _comp, std::vector<std::string> && _variation_unit_ids) = delete;
 	virtual ~enumerate_relationships_table();
     std::string get_primary_wit_id() const;
     std::string get_secondary_wit_id() const;
@@ -43,7 +68,12 @@ public:
     void to_fixed_width(std::ostream & out, const std::set<std::string> & filter_relationship_types);
 	void to_csv(std::ostream & out, const std::set<std::string> & filter_relationship_types);
     void to_tsv(std::ostream & out, const std::set<std::string> & filter_relationship_types);
+    void to_json(json_writer & writer, const std::set<std::string> & filter_relationship_types);
     void to_json(std::ostream & out, const std::set<std::string> & filter_relationship_types);
+	void codes_to_csv(std::ostream & out);
+	void codes_to_tsv(std::ostream & out);
+	void codes_to_json(json_writer & writer);
+	void codes_to_json(std::ostream & out);
 };
 
 #endif /* ENUMERATE_RELATIONSHIPS_TABLE_H */
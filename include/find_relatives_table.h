@@ -15,6 +15,7 @@
 
 #include "variation_unit.h"
 #include "witness.h"
+#include "json_writer.h"
 
  /**
  * Data structure representing a row of the witness comparison table.
@@ -45,7 +46,8 @@ private:
 	std::list<find_relatives_table_row> rows;
 public:
 	find_relatives_table();
-	find_relatives_table(const witness & wit, const variation_unit & vu, const std::list<std::string> list_wit, const std::set<std::string> & filter_wits);
+	find_relatives_table(const witness & wit, const variation_unit & vu, const std::list<std::string> & list_wit, const std::set<std::string> & filter_wits);
+	find_relatives_table(const std::string & _id, const std::string & _label, int _connectivity, int _primary_extant, const std::string & _primary_rdg, const std::list<find_relatives_table_row> & _rows);
 	virtual ~find_relatives_table();
     std::string get_id() const;
     std::string get_label() const;
@@ -56,6 +58,7 @@ public:
     void to_fixed_width(std::ostream & out);
 	void to_csv(std::ostream & out);
     void to_tsv(std::ostream & out);
+    void to_json(json_writer & writer);
     void to_json(std::ostream & out);
 };
 
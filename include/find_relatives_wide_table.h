@@ -0,0 +1,64 @@
+/*
+ * find_relatives_wide_table.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef FIND_RELATIVES_WIDE_TABLE_H
+#define FIND_RELATIVES_WIDE_TABLE_H
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+#include <set>
+
+#include "variation_unit.h"
+#include "witness.h"
+#include "compare_witnesses_table.h"
+#include "find_relatives_table.h"
+#include "json_writer.h"
+
+/**
+ * Data structure representing a row of the wide find relatives table.
+ */
+struct find_relatives_wide_table_row {
+	compare_witnesses_table_row comparison; //genealogical comparison of the primary witness to the secondary witness
+	std::vector<std::string> rdgs; //reading of the secondary witness at each variation unit, in order
+};
+
+/**
+ * Table of the relatives of one witness across many variation units.
+ * The witnesses are ranked against the primary witness only once, and each variation unit contributes one column holding every secondary witness's reading there.
+ * The table can be written as a single wide table or as the sequence of find relatives tables for its variation units.
+ */
+class find_relatives_wide_table {
+private:
+	std::string id;
+	int primary_extant;
+	std::vector<std::string> labels; //labels of the variation units, in order
+	std::vector<int> connectivities; //connectivity limits of the variation units, in order
+	std::vector<std::string> primary_rdgs; //readings of the primary witness at the variation units, in order
+	std::list<find_relatives_wide_table_row> rows;
+public:
+	find_relatives_wide_table();
+	find_relatives_wide_table(const witness & wit, const std::vector<variation_unit> & vus, const std::list<std::string> & list_wit, const std::set<std::string> & filter_wits);
+	virtual ~find_relatives_wide_table();
+	std::string get_id() const;
+	int get_primary_extant() const;
+	std::vector<std::string> get_labels() const;
+	std::vector<int> get_connectivities() const;
+	std::vector<std::string> get_primary_rdgs() const;
+	std::list<find_relatives_wide_table_row> get_rows() const;
+	find_relatives_table get_table(unsigned int vu_ind, const std::set<std::string> & filter_rdgs) const;
+	void to_fixed_width(std::ostream & out);
+	void to_csv(std::ostream & out);
+	void to_tsv(std::ostream & out);
+	void to_json(json_writer & writer);
+	void to_json(std::ostream & out);
+	void tables_to_json(json_writer & writer, const std::set<std::string> & filter_rdgs);
+	void tables_to_json(std::ostream & out, const std::set<std::string> & filter_rdgs);
+};
+
+#endif /* FIND_RELATIVES_WIDE_TABLE_H */
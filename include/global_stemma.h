@@ -10,8 +10,14 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
+#include <set>
+#include <unordered_map>
 
+#include "apparatus.h"
 #include "witness.h"
+#include "json_writer.h"
+#include "dot_writer.h"
 
 //Define graph types for the stemma:
 struct global_stemma_vertex {
@@ -24,17 +30,38 @@ struct global_stemma_edge {
 	float strength;
 };
 
+/**
+ * Data structure representing the edges of a global stemma in compressed sparse row (CSR) form,
+ * with each vertex indexed by its position in the global stemma's list of vertices.
+ */
+struct global_stemma_adjacency {
+	std::vector<unsigned int> offsets; //the edges from the vertex with index i are at indices offsets[i] up to offsets[i + 1] of the arrays below
+	std::vector<unsigned int> descendants; //index of the descendant of each edge
+	std::vector<unsigned int> edge_inds; //index of each edge in the global stemma's list of edges
+};
+
 class global_stemma {
 private:
 	std::list<global_stemma_vertex> vertices;
 	std::list<global_stemma_edge> edges;
+	static std::list<global_stemma_edge> get_edges_to_witness(const witness & wit);
+	unsigned int get_components(const global_stemma_adjacency & adjacency, std::vector<unsigned int> & components) const;
 public:
 	global_stemma();
 	global_stemma(const std::list<witness> & witnesses);
+	global_stemma(const std::list<global_stemma_vertex> & _vertices, const std::list<global_stemma_edge> & _edges);
 	virtual ~global_stemma();
 	std::list<global_stemma_vertex> get_vertices() const;
 	std::list<global_stemma_edge> get_edges() const;
+	global_stemma_adjacency get_adjacency() const;
+	std::list<std::list<std::string>> get_cycles() const;
+	bool is_acyclic() const;
+	global_stemma get_transitive_reduction() const;
+	std::unordered_map<std::string, unsigned int> get_generations() const;
+	std::list<std::string> update(std::list<witness> & witnesses, const apparatus & old_app, const apparatus & new_app, const std::set<unsigned int> & vu_inds, bool classic=false, unsigned int threads=1);
+	void to_dot(dot_writer & writer, bool print_lengths=false, bool flow_strengths=false);
 	void to_dot(std::ostream & out, bool print_lengths=false, bool flow_strengths=false);
+	void to_json(json_writer & writer);
 	void to_json(std::ostream & out);
 };
 
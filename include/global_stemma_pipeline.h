@@ -0,0 +1,57 @@
+/*
+ * global_stemma_pipeline.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef GLOBAL_STEMMA_PIPELINE_H
+#define GLOBAL_STEMMA_PIPELINE_H
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+
+#include "apparatus.h"
+#include "witness.h"
+#include "set_cover_solver.h"
+#include "global_stemma.h"
+#include "substemma_checkpoint.h"
+#include "json_writer.h"
+
+/**
+ * Data structure recording the time spent in each stage of the global stemma pipeline.
+ */
+struct global_stemma_pipeline_timing {
+	double witnesses_time = 0; //seconds spent constructing witnesses and their genealogical comparisons
+	double substemmata_time = 0; //seconds spent optimizing substemmata and setting stemmatic ancestors
+	double stemma_time = 0; //seconds spent constructing the global stemma from the witnesses
+	double total_time = 0; //seconds spent in total
+};
+
+class global_stemma_pipeline {
+private:
+	unsigned int threads = 1; //number of worker threads (0 for as many as the hardware supports)
+	std::list<witness> witnesses;
+	std::vector<set_cover_solver_stats> solver_stats; //statistics for each witness's substemma optimization, in witness order
+	global_stemma stemma;
+	global_stemma_pipeline_timing timing;
+	unsigned int n_resumed = 0; //number of witnesses whose substemmata were read from a checkpoint rather than optimized
+	void run(const apparatus & app, bool classic, substemma_checkpoint * checkpoint);
+public:
+	global_stemma_pipeline();
+	global_stemma_pipeline(const apparatus & app, bool classic=false, unsigned int _threads=1);
+	global_stemma_pipeline(const apparatus & app, const std::string & checkpoint_path, bool classic=false, unsigned int _threads=1);
+	virtual ~global_stemma_pipeline();
+	unsigned int get_threads() const;
+	std::list<witness> get_witnesses() const;
+	std::vector<set_cover_solver_stats> get_solver_stats() const;
+	global_stemma get_global_stemma() const;
+	global_stemma_pipeline_timing get_timing() const;
+	unsigned int get_n_resumed() const;
+	void timing_to_json(json_writer & writer);
+	void timing_to_json(std::ostream & out);
+};
+
+#endif /* GLOBAL_STEMMA_PIPELINE_H */
@@ -0,0 +1,57 @@
+/*
+ * json_writer.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Buffered writer for JavaScript Object Notation (JSON) output.
+ * Values are appended to an internal buffer, which is written to the output stream whenever it fills up and when the writer is flushed or destroyed.
+ * The writer keeps track of the containers it has open, so callers never need to place commas themselves;
+ * strings are escaped, and floating-point numbers are written in the shortest form that reads back as the same value (or as null if they are not finite).
+ */
+class json_writer {
+private:
+	std::ostream * out;
+	std::string buffer;
+	size_t buffer_size;
+	std::vector<bool> container_has_values; //for each open container, whether a value has been written to it yet
+	bool after_key = false;
+	void before_value();
+	void append_string(const std::string & s);
+	void append_integer(unsigned long long n, bool negative);
+	void flush_if_full();
+public:
+	json_writer(std::ostream & _out, size_t _buffer_size=65536);
+	virtual ~json_writer();
+	static std::string format_number(float x);
+	static std::string format_number(double x);
+	void begin_object();
+	void end_object();
+	void begin_array();
+	void end_array();
+	void key(const std::string & k);
+	void value(const std::string & s);
+	void value(const char * s);
+	void value(bool b);
+	void value(int n);
+	void value(unsigned int n);
+	void value(long long n);
+	void value(unsigned long long n);
+	void value(float x);
+	void value(double x);
+	void null_value();
+	void raw_value(const std::string & json);
+	void newline();
+	void flush();
+};
+
+#endif /* JSON_WRITER_H */
@@ -14,6 +14,7 @@
 #include <map>
 
 #include "pugixml.hpp"
+#include "json_writer.h"
 
 //Define graph types for the stemma:
 struct local_stemma_vertex {
@@ -55,6 +56,7 @@ public:
 	bool common_ancestor_exists(const std::string & r1, const std::string & r2) const;
 	bool readings_agree(const std::string & r1, const std::string & r2) const;
 	void to_dot(std::ostream & out, bool print_weights=false);
+	void to_json(json_writer & writer);
 	void to_json(std::ostream & out);
 };
 
@@ -12,9 +12,11 @@
 #include <string>
 #include <list>
 #include <set>
+#include <functional>
 
 #include "set_cover_solver.h"
 #include "witness.h"
+#include "json_writer.h"
 
 /**
  * Data structure representing a row of the optimize substemmata table.
@@ -30,9 +32,15 @@ private:
     std::string id;
     int primary_extant;
 	std::list<optimize_substemmata_table_row> rows;
+	bool streamed = false; //whether the rows are drawn from the enumerator rather than stored
+	set_cover_solution_enumerator enumerator;
+	static optimize_substemmata_table_row get_row(const set_cover_solution & substemma);
+	void for_each_row(const std::function<void(const optimize_substemmata_table_row &)> & f) const;
 public:
 	optimize_substemmata_table();
 	optimize_substemmata_table(const witness & wit, float ub);
+	optimize_substemmata_table(const witness & wit, float ub, unsigned int max_rows);
+	optimize_substemmata_table(const witness & wit, const set_cover_solution_enumerator & _enumerator);
 	virtual ~optimize_substemmata_table();
     std::string get_id() const;
     int get_primary_extant() const;
@@ -40,6 +48,7 @@ public:
     void to_fixed_width(std::ostream & out);
 	void to_csv(std::ostream & out);
     void to_tsv(std::ostream & out);
+    void to_json(json_writer & writer);
     void to_json(std::ostream & out);
 };
 
@@ -0,0 +1,51 @@
+/*
+ * parallel_for.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <functional>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+unsigned int resolve_threads(unsigned int threads);
+void parallel_for(unsigned int n, unsigned int threads, const std::function<void(unsigned int)> & body);
+
+/**
+ * Persistent pool of worker threads for running repeated parallel loops without spawning new threads for each one.
+ */
+class thread_pool {
+private:
+	std::vector<std::thread> workers; //worker threads, in addition to the calling thread
+	std::mutex run_mutex; //serializes loops from different callers
+	std::mutex state_mutex; //guards the loop state below
+	std::condition_variable work_ready;
+	std::condition_variable work_done;
+	const std::function<void(unsigned int)> * body = nullptr;
+	unsigned int n = 0;
+	unsigned int generation = 0; //incremented for every loop, so that workers can tell a new loop from a spurious wakeup
+	unsigned int active = 0; //number of workers still working on the current loop
+	bool stopping = false;
+	std::atomic<unsigned int> next_index;
+	std::atomic<bool> failed;
+	std::exception_ptr first_exception = nullptr;
+	std::mutex exception_mutex;
+	void work();
+public:
+	thread_pool(unsigned int threads);
+	thread_pool(const thread_pool &) = delete;
+	thread_pool & operator=(const thread_pool &) = delete;
+	virtual ~thread_pool();
+	unsigned int size() const;
+	void parallel_for(unsigned int n, const std::function<void(unsigned int)> & body);
+};
+
+#endif /* PARALLEL_FOR_H */
@@ -7,13 +7,16 @@
 #ifndef SET_COVER_SOLVER_H
 #define SET_COVER_SOLVER_H
 
+#include <iostream>
 #include <string>
 #include <list>
 #include <stack>
 #include <vector>
 #include <limits>
+#include <memory>
 
 #include <roaring/roaring.hh>
+#include "json_writer.h"
 
 /**
  * Enumeration of states for an accept-reject branch and bound node.
@@ -47,11 +50,60 @@ struct set_cover_solution {
 	float cost;
 };
 
+/**
+ * Data structure representing statistics collected by a set cover solver over a single call to solve,
+ * so that slow substemma searches can be diagnosed.
+ */
+struct set_cover_solver_stats {
+	std::string backend; //search backend used on the reduced problem ("branch_and_bound", "meet_in_the_middle", or "enumerator"), or empty if no search was needed
+	unsigned int rows = 0; //number of rows before reduction
+	unsigned int unique_rows = 0; //number of rows that uniquely cover one or more columns
+	unsigned int subproblem_rows = 0; //number of rows left after reduction
+	float greedy_bound = std::numeric_limits<float>::infinity(); //cost of the greedy solution used as an initial upper bound (infinite if none was used)
+	unsigned long long nodes_expanded = 0; //number of branch-and-bound node states processed
+	unsigned long long nodes_pruned_by_bound = 0; //number of node states not branched on because their lower bound exceeded the upper bound
+	unsigned long long nodes_pruned_by_infeasibility = 0; //number of node states not branched on because no solution lay under them
+	unsigned long long solutions_found = 0; //number of solutions returned
+	double reduction_time = 0; //seconds spent extracting unique rows and reducing the problem
+	double greedy_time = 0; //seconds spent computing the greedy solution
+	double search_time = 0; //seconds spent searching the reduced problem, excluding the greedy heuristic
+	double total_time = 0; //seconds spent in total
+};
+
+/**
+ * Abstract interface for a backend that checks the feasibility of set cover solutions for a fixed set of rows and target set.
+ * Row sets are passed in and out as Roaring bitmaps, but implementations are free to represent the rows internally however they want.
+ */
+class set_cover_kernel {
+public:
+	set_cover_kernel();
+	virtual ~set_cover_kernel();
+	virtual bool is_feasible(const roaring::Roaring & solution_rows) const = 0;
+	virtual void get_cheapest_irredundant_covers(const std::vector<float> & costs, std::list<roaring::Roaring> & covers) const = 0;
+};
+
 class set_cover_solver {
 private:
 	std::vector<set_cover_row> rows;
 	roaring::Roaring target;
 	float fixed_ub = std::numeric_limits<float>::infinity();
+	std::shared_ptr<const set_cover_kernel> kernel;
+	bool kernel_built = false; //the kernel is built lazily, when the solver starts searching
+	std::vector<roaring::Roaring> column_rows;
+	bool column_index_built = false; //the column index is built lazily, when the solver first branches on a column
+	mutable std::vector<std::vector<unsigned int>> row_columns; //for each row, the ranks of the target columns it covers
+	mutable bool row_index_built = false; //the row index is built lazily, when the solver first removes redundant rows
+	mutable std::vector<unsigned int> coverage_counts; //scratch buffer indexed by target column rank, reused across calls to remove_redundant_rows_from_solution
+	std::vector<unsigned int> column_accepted_counts; //for each target column rank, the number of accepted rows covering it during a column-branching search
+	std::vector<unsigned int> column_remaining_counts; //for each target column rank, the number of remaining rows covering it during a column-branching search
+	set_cover_solver_stats stats;
+	void build_kernel();
+	void build_column_index();
+	void build_row_index() const;
+	void reset_column_counts(const roaring::Roaring & accepted, const roaring::Roaring & remaining);
+	void update_column_counts(unsigned int row, node_state state);
+	void branch_on_counted_column(const roaring::Roaring & remaining, std::stack<branch_and_bound_node> & nodes);
+	float branch_and_bound_single_solution_search(roaring::Roaring & solution_rows, float ub, bool column_branching);
 public:
 	set_cover_solver();
 	set_cover_solver(const std::vector<set_cover_row> & _rows, const roaring::Roaring & _target);
@@ -62,12 +114,51 @@ public:
 	roaring::Roaring get_unique_rows() const;
 	bool is_feasible(const roaring::Roaring & solution_rows) const;
 	void remove_redundant_rows_from_solution(roaring::Roaring & initial_solution_rows) const;
-	roaring::Roaring get_greedy_solution() const;
+	void add_greedy_rows_to_solution(roaring::Roaring & solution_rows, const roaring::Roaring & excluded_rows) const;
+	void improve_solution_by_local_search(roaring::Roaring & solution_rows) const;
+	roaring::Roaring get_greedy_solution(bool local_search=false) const;
 	void branch(const roaring::Roaring & remaining, std::stack<branch_and_bound_node> & nodes);
+	void branch_on_column(const roaring::Roaring & accepted, const roaring::Roaring & remaining, std::stack<branch_and_bound_node> & nodes);
 	float bound(const roaring::Roaring & solution_rows) const;
 	void branch_and_bound(std::list<set_cover_solution> & solutions);
-	void branch_and_bound_single_solution(std::list<set_cover_solution> & solutions);
-	void solve(std::list<set_cover_solution> & solutions, bool single_solution=false);
+	void branch_and_bound_single_solution(std::list<set_cover_solution> & solutions, float initial_ub=std::numeric_limits<float>::infinity(), float warm_start_ub=std::numeric_limits<float>::infinity());
+	bool meet_in_the_middle(std::list<set_cover_solution> & solutions, bool single_solution=false);
+	bool get_subproblem(roaring::Roaring & unique_rows, std::vector<unsigned int> & subproblem_row_inds, roaring::Roaring & subproblem_target, float & subproblem_ub) const;
+	void solve(std::list<set_cover_solution> & solutions, bool single_solution=false, const roaring::Roaring & warm_start_rows=roaring::Roaring());
+	void solve_cheapest(std::list<set_cover_solution> & solutions, unsigned int max_solutions);
+	set_cover_solver_stats get_stats() const;
+	void stats_to_json(json_writer & writer) const;
+	void stats_to_json(std::ostream & out) const;
+};
+
+/**
+ * Lazy enumerator over all set cover solutions with costs within a fixed upper bound.
+ * Solutions are yielded one at a time in branch-and-bound order, and each distinct solution is yielded exactly once.
+ * The upper bound can be tightened while the enumeration is in progress, in which case the remaining search is pruned against the new bound.
+ */
+class set_cover_solution_enumerator {
+private:
+	set_cover_solver solver;
+	roaring::Roaring unique_rows;
+	float unique_rows_cost = 0;
+	std::vector<unsigned int> subproblem_row_inds;
+	set_cover_solver subproblem_solver;
+	float subproblem_ub = 0;
+	float ub = std::numeric_limits<float>::infinity();
+	roaring::Roaring accepted;
+	roaring::Roaring remaining;
+	std::stack<branch_and_bound_node> nodes;
+	bool unique_rows_pending = false;
+	set_cover_solver_stats stats;
+	set_cover_solution get_solution_from_subproblem_rows(const roaring::Roaring & solution_rows) const;
+	bool within_bound(const roaring::Roaring & solution_rows) const;
+public:
+	set_cover_solution_enumerator();
+	set_cover_solution_enumerator(const std::vector<set_cover_row> & _rows, const roaring::Roaring & _target, float _fixed_ub);
+	virtual ~set_cover_solution_enumerator();
+	void tighten_upper_bound(float _ub);
+	bool next(set_cover_solution & solution);
+	set_cover_solver_stats get_stats() const;
 };
 
 #endif /* SET_COVER_SOLVER_H */
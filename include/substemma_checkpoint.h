@@ -0,0 +1,53 @@
+/*
+ * substemma_checkpoint.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef SUBSTEMMA_CHECKPOINT_H
+#define SUBSTEMMA_CHECKPOINT_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+
+#include "apparatus.h"
+#include "set_cover_solver.h"
+
+/**
+ * Data structure representing a witness's solved substemma, as recorded in a checkpoint.
+ */
+struct substemma_checkpoint_entry {
+	std::string wit_id;
+	std::list<std::string> stemmatic_ancestor_ids;
+	set_cover_solver_stats stats;
+};
+
+/**
+ * Append-only checkpoint file of solved substemmata, so that a long substemma optimization run can be resumed after it is interrupted.
+ * The file starts with a header line containing a key for the apparatus and options the substemmata were solved under,
+ * followed by one tab-separated line per solved witness, each of which is flushed as soon as it is written.
+ */
+class substemma_checkpoint {
+private:
+	std::string path;
+	std::string key;
+	std::unordered_map<std::string, substemma_checkpoint_entry> entries;
+	std::ofstream out;
+	mutable std::mutex entries_mutex; //guards the entries and the output stream, so that witnesses solved on different threads can be appended concurrently
+public:
+	substemma_checkpoint(const std::string & _path, const std::string & _key);
+	virtual ~substemma_checkpoint();
+	static std::string get_key(const apparatus & app, bool classic);
+	std::string get_path() const;
+	std::string get_key() const;
+	unsigned int size() const;
+	bool contains(const std::string & wit_id) const;
+	substemma_checkpoint_entry get_entry(const std::string & wit_id) const;
+	void append(const substemma_checkpoint_entry & entry);
+};
+
+#endif /* SUBSTEMMA_CHECKPOINT_H */
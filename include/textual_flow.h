@@ -10,9 +10,13 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
+#include <map>
 
 #include "variation_unit.h"
 #include "witness.h"
+#include "json_writer.h"
+#include "dot_writer.h"
 
 enum flow_type {NONE, EQUAL, CHANGE, LOSS};
 
@@ -29,28 +33,78 @@ struct textual_flow_edge {
 	float strength;
 };
 
+/**
+ * Data structure representing an edge of a textual flow diagram in index form.
+ * The descendant is implicit in the position of the arc in the diagram's compressed sparse row (CSR) adjacency arrays.
+ */
+struct textual_flow_arc {
+	unsigned int ancestor; //index of the ancestor's ID
+	flow_type type;
+	int connectivity;
+	float strength;
+};
+
+/**
+ * Data structure partitioning the vertices of a textual flow diagram by reading,
+ * so that the coherence in attestations diagrams for all readings can be drawn from it without refiltering the whole diagram.
+ * Both vectors are indexed by reading index plus one, so that lacunose vertices are placed in the first slot.
+ */
+struct textual_flow_partition {
+	std::vector<std::vector<unsigned int>> rdg_vertices; //for each reading, the indices of the vertices with it, followed by those of their ancestors that do not have it or are not vertices
+	std::vector<std::vector<unsigned int>> rdg_descendants; //for each reading, the indices of the vertices with it that have an edge ending at them
+};
+
 class textual_flow {
 private:
 	std::string label;
 	std::list<std::string> readings;
 	int connectivity;
-	std::list<textual_flow_vertex> vertices;
-	std::list<textual_flow_edge> edges;
+	std::vector<std::string> ids; //IDs of the vertices, in order, followed by those of any ancestors that are not vertices
+	unsigned int n_vertices = 0;
+	std::vector<std::string> rdgs; //distinct readings of the vertices and of any ancestors that are not vertices
+	std::vector<int> id_rdgs; //index of the reading of each ID in the readings vector (-1 if it is lacunose, or if it is an ancestor that is not a vertex and its reading is unknown)
+	std::vector<unsigned int> arc_offsets; //the edges ending at the ID with index i are the arcs from index arc_offsets[i] up to index arc_offsets[i + 1]
+	std::vector<textual_flow_arc> arcs; //edges grouped by descendant, in their original order
+	int get_rdg_slot(const std::string & rdg) const;
+	textual_flow_partition partition_by_reading() const;
+	void arc_to_dot(dot_writer & writer, unsigned int descendant_ind, const textual_flow_arc & a, bool flow_strengths) const;
+	void arc_to_json(json_writer & writer, unsigned int descendant_ind, const textual_flow_arc & a) const;
+	void attestation_graph_to_dot(dot_writer & writer, const textual_flow_partition & partition, const std::string & rdg, bool flow_strengths) const;
+	void attestation_graph_to_json(json_writer & writer, const textual_flow_partition & partition, const std::string & rdg) const;
 public:
 	textual_flow();
 	textual_flow(const variation_unit & vu, const std::list<witness> & witnesses, int _connectivity);
 	textual_flow(const variation_unit & vu, const std::list<witness> & witnesses);
+	textual_flow(const std::string & _label, const std::list<std::string> & _readings, int _connectivity, const std::list<textual_flow_vertex> & _vertices, const std::list<textual_flow_edge> & _edges);
+	textual_flow(const std::string & _label, const std::list<std::string> & _readings, int _connectivity, const std::vector<std::string> & _ids, unsigned int _n_vertices, const std::vector<std::string> & _rdgs, const std::vector<int> & _id_rdgs, const std::vector<unsigned int> & _arc_offsets, const std::vector<textual_flow_arc> & _arcs);
 	virtual ~textual_flow();
 	std::string get_label() const;
 	std::list<std::string> get_readings() const;
 	int get_connectivity() const;
 	std::list<textual_flow_vertex> get_vertices() const;
 	std::list<textual_flow_edge> get_edges() const;
+	unsigned int get_n_vertices() const;
+	const std::vector<std::string> & get_rdgs_ref() const;
+	const std::vector<int> & get_id_rdgs_ref() const;
+	const std::vector<unsigned int> & get_arc_offsets_ref() const;
+	const std::vector<textual_flow_arc> & get_arcs_ref() const;
+	void textual_flow_to_dot(dot_writer & writer, bool flow_strengths=false);
 	void textual_flow_to_dot(std::ostream & out, bool flow_strengths=false);
+	void textual_flow_to_json(json_writer & writer);
 	void textual_flow_to_json(std::ostream & out);
+	void coherence_in_attestations_to_dot(dot_writer & writer, const std::string & rdg, bool flow_strengths=false);
 	void coherence_in_attestations_to_dot(std::ostream & out, const std::string & rdg, bool flow_strengths=false);
+	void coherence_in_attestations_to_json(json_writer & writer, const std::string & rdg);
 	void coherence_in_attestations_to_json(std::ostream & out, const std::string & rdg);
+	void coherence_in_all_attestations_to_dot(dot_writer & writer, bool flow_strengths=false);
+	void coherence_in_all_attestations_to_dot(std::ostream & out, bool flow_strengths=false);
+	void coherence_in_all_attestations_to_dot(const std::map<std::string, std::ostream *> & outs, bool flow_strengths=false);
+	void coherence_in_all_attestations_to_json(json_writer & writer);
+	void coherence_in_all_attestations_to_json(std::ostream & out);
+	void coherence_in_all_attestations_to_json(const std::map<std::string, std::ostream *> & outs);
+	void coherence_in_variant_passages_to_dot(dot_writer & writer, bool flow_strengths=false);
 	void coherence_in_variant_passages_to_dot(std::ostream & out, bool flow_strengths=false);
+	void coherence_in_variant_passages_to_json(json_writer & writer);
 	void coherence_in_variant_passages_to_json(std::ostream & out);
 };
 
@@ -0,0 +1,63 @@
+/*
+ * textual_flow_builder.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#ifndef TEXTUAL_FLOW_BUILDER_H
+#define TEXTUAL_FLOW_BUILDER_H
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+#include <memory>
+
+#include "variation_unit.h"
+#include "witness.h"
+#include "textual_flow.h"
+#include "json_writer.h"
+#include "dot_writer.h"
+#include "parallel_for.h"
+
+/**
+ * Data structure representing a potential ancestor of a witness, ranked for textual flow purposes.
+ */
+struct ranked_ancestor {
+	unsigned int index; //index of the potential ancestor's ID in the builder's ID table
+	int rank; //connectivity rank of the potential ancestor relative to the witness (0 for the closest ancestors)
+	float strength; //strength of textual flow from the potential ancestor to the witness
+};
+
+class textual_flow_builder {
+private:
+	std::vector<std::string> ids; //IDs of the input witnesses, in order, followed by the IDs of any potential ancestors not among them
+	unsigned int n_witnesses = 0;
+	std::vector<std::vector<ranked_ancestor>> ranked_ancestors; //ranked potential ancestors for each input witness, in order of decreasing agreement
+	unsigned int threads = 1; //number of worker threads to use for batch operations (0 for as many as the hardware supports)
+	std::shared_ptr<thread_pool> pool; //worker threads reused across batch operations (shared by copies of this builder)
+	void index_readings(const variation_unit & vu, std::vector<std::string> & rdgs, std::vector<int> & rdg_inds, std::vector<bool> & equal_flow) const;
+public:
+	textual_flow_builder();
+	textual_flow_builder(const std::list<witness> & witnesses, unsigned int _threads=1);
+	virtual ~textual_flow_builder();
+	unsigned int get_threads() const;
+	void set_threads(unsigned int _threads);
+	std::vector<std::string> get_witness_ids() const;
+	std::vector<ranked_ancestor> get_ranked_ancestors(unsigned int wit_ind) const;
+	textual_flow get_textual_flow(const variation_unit & vu, int connectivity) const;
+	textual_flow get_textual_flow(const variation_unit & vu) const;
+	std::vector<textual_flow> get_textual_flows(const std::vector<variation_unit> & vus, int connectivity) const;
+	std::vector<textual_flow> get_textual_flows(const std::vector<variation_unit> & vus) const;
+	std::vector<textual_flow> get_textual_flow_sweep(const variation_unit & vu, const std::vector<int> & connectivities) const;
+	std::vector<std::vector<textual_flow>> get_textual_flow_sweeps(const std::vector<variation_unit> & vus, const std::vector<int> & connectivities) const;
+	void textual_flows_to_dot(dot_writer & writer, const std::vector<variation_unit> & vus, bool flow_strengths=false) const;
+	void textual_flows_to_dot(std::ostream & out, const std::vector<variation_unit> & vus, bool flow_strengths=false) const;
+	void textual_flows_to_json(json_writer & writer, const std::vector<variation_unit> & vus) const;
+	void textual_flows_to_json(std::ostream & out, const std::vector<variation_unit> & vus) const;
+	void textual_flows_to_ndjson(json_writer & writer, const std::vector<variation_unit> & vus, bool attestations=false, bool variant_passages=false) const;
+	void textual_flows_to_ndjson(std::ostream & out, const std::vector<variation_unit> & vus, bool attestations=false, bool variant_passages=false) const;
+};
+
+#endif /* TEXTUAL_FLOW_BUILDER_H */
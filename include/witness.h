@@ -10,10 +10,13 @@
 
 #include <string>
 #include <list>
+#include <vector>
+#include <map>
 #include <unordered_map>
 
 #include <roaring/roaring.hh>
 #include "apparatus.h"
+#include "variation_unit.h"
 #include "set_cover_solver.h"
 
  /**
@@ -32,12 +35,19 @@ struct genealogical_comparison {
 	float cost; //genealogical cost of relationship
 };
 
+/**
+ * Enumeration of the possible effects of changes to variation units on a witness's genealogical comparisons.
+ */
+enum genealogical_comparison_update {UNCHANGED, COMPARISONS_CHANGED, SET_COVER_CHANGED};
+
 class witness {
 private:
 	std::string id;
 	std::unordered_map<std::string, genealogical_comparison> genealogical_comparisons;
 	std::list<std::string> potential_ancestor_ids;
 	std::list<std::string> stemmatic_ancestor_ids;
+	std::vector<set_cover_row> get_set_cover_rows() const;
+	void populate_potential_ancestor_ids(const std::list<std::string> & other_ids);
 public:
 	witness();
 	witness(const std::string & _id, const apparatus & app, bool classic=false);
@@ -46,8 +56,14 @@ public:
 	std::string get_id() const;
 	std::unordered_map<std::string, genealogical_comparison> get_genealogical_comparisons() const;
 	genealogical_comparison get_genealogical_comparison_for_witness(const std::string & other_id) const;
+	const genealogical_comparison & get_genealogical_comparison_ref(const std::string & other_id) const;
 	std::list<std::string> get_potential_ancestor_ids() const;
 	std::list<set_cover_solution> get_substemmata(float ub=0, bool single_solution=false) const;
+	std::list<set_cover_solution> get_substemmata(float ub, bool single_solution, set_cover_solver_stats & stats) const;
+	std::list<set_cover_solution> get_warm_started_substemmata(const std::list<std::string> & warm_start_ids, set_cover_solver_stats & stats) const;
+	std::list<set_cover_solution> get_cheapest_substemmata(unsigned int max_substemmata, float ub=0) const;
+	set_cover_solution_enumerator get_substemmata_enumerator(float ub) const;
+	genealogical_comparison_update update_genealogical_comparisons(const std::list<std::string> & list_wit, const std::map<unsigned int, variation_unit> & old_vus, const std::map<unsigned int, variation_unit> & new_vus, const std::vector<variation_unit> & vus, bool classic=false);
 	void set_stemmatic_ancestor_ids(const std::list<std::string> & witnesses);
 	std::list<std::string> get_stemmatic_ancestor_ids() const;
 };
@@ -0,0 +1,289 @@
+/*
+ * coherence_metrics_table.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <list>
+#include <vector>
+#include <limits>
+
+#include "variation_unit.h"
+#include "textual_flow.h"
+#include "textual_flow_builder.h"
+#include "parallel_for.h"
+#include "coherence_metrics_table.h"
+#include "json_writer.h"
+
+using namespace std;
+
+/**
+ * Default constructor.
+ */
+coherence_metrics_table::coherence_metrics_table() {
+
+}
+
+/**
+ * Constructs a coherence metrics table for the given variation units from their textual flow diagrams with the given connectivity limit,
+ * which are built by the given textual flow builder.
+ * The variation units are processed in parallel over the builder's worker threads, and the rows are kept in the same order as the variation units.
+ */
+coherence_metrics_table::coherence_metrics_table(const textual_flow_builder & tfb, const vector<variation_unit> & vus, int connectivity) {
+	vector<coherence_metrics_table_row> indexed_rows = vector<coherence_metrics_table_row>(vus.size());
+	parallel_for((unsigned int) vus.size(), tfb.get_threads(), [&](unsigned int i) {
+		indexed_rows[i] = get_row(vus[i], tfb.get_textual_flow(vus[i], connectivity));
+	});
+	rows = list<coherence_metrics_table_row>(indexed_rows.begin(), indexed_rows.end());
+}
+
+/**
+ * Constructs a coherence metrics table for the given variation units from their textual flow diagrams,
+ * which are built by the given textual flow builder using each variation unit's default connectivity value.
+ * The variation units are processed in parallel over the builder's worker threads, and the rows are kept in the same order as the variation units.
+ */
+coherence_metrics_table::coherence_metrics_table(const textual_flow_builder & tfb, const vector<variation_unit> & vus) {
+	vector<coherence_metrics_table_row> indexed_rows = vector<coherence_metrics_table_row>(vus.size());
+	parallel_for((unsigned int) vus.size(), tfb.get_threads(), [&](unsigned int i) {
+		indexed_rows[i] = get_row(vus[i], tfb.get_textual_flow(vus[i]));
+	});
+	rows = list<coherence_metrics_table_row>(indexed_rows.begin(), indexed_rows.end());
+}
+
+/**
+ * Default destructor.
+ */
+coherence_metrics_table::~coherence_metrics_table() {
+
+}
+
+/**
+ * Computes the coherence metrics for the given variation unit from its textual flow diagram.
+ * The roots of a reading's coherence-in-attestations graph are the witnesses with that reading
+ * whose first textual flow ancestor (if they have one) does not have it.
+ * The diagram is read in index form, so that no strings are copied; an ancestor that is not a vertex counts as having a different reading
+ * if its reading is unknown (which is only the case for a diagram constructed from lists of vertices and edges).
+ */
+coherence_metrics_table_row coherence_metrics_table::get_row(const variation_unit & vu, const textual_flow & tf) {
+	coherence_metrics_table_row row;
+	row.id = vu.get_id();
+	row.label = tf.get_label();
+	row.connectivity = tf.get_connectivity();
+	row.change = 0;
+	row.loss = 0;
+	row.max_con = -1;
+	unsigned int n_vertices = tf.get_n_vertices();
+	const vector<string> & rdgs = tf.get_rdgs_ref();
+	const vector<int> & id_rdgs = tf.get_id_rdgs_ref();
+	const vector<unsigned int> & arc_offsets = tf.get_arc_offsets_ref();
+	const vector<textual_flow_arc> & arcs = tf.get_arcs_ref();
+	//Count the edges of each type:
+	for (const textual_flow_arc & a : arcs) {
+		if (a.type == flow_type::CHANGE) {
+			row.change++;
+		}
+		else if (a.type == flow_type::LOSS) {
+			row.loss++;
+		}
+		if (a.connectivity > row.max_con) {
+			row.max_con = a.connectivity;
+		}
+	}
+	//Then count the witnesses and roots for each reading index:
+	vector<int> rdg_wits = vector<int>(rdgs.size(), 0);
+	vector<int> rdg_roots = vector<int>(rdgs.size(), 0);
+	for (unsigned int i = 0; i < n_vertices; i++) {
+		int rdg_ind = id_rdgs[i];
+		if (rdg_ind < 0) {
+			continue;
+		}
+		rdg_wits[rdg_ind]++;
+		if (arc_offsets[i + 1] == arc_offsets[i] || id_rdgs[arcs[arc_offsets[i]].ancestor] != rdg_ind) {
+			rdg_roots[rdg_ind]++;
+		}
+	}
+	//Then list them in the variation unit's reading order (including readings that no witness has):
+	row.rdgs = list<reading_coherence>();
+	for (const string & rdg : tf.get_readings()) {
+		reading_coherence rc;
+		rc.rdg = rdg;
+		rc.wits = 0;
+		rc.roots = 0;
+		for (unsigned int rdg_ind = 0; rdg_ind < rdgs.size(); rdg_ind++) {
+			if (rdgs[rdg_ind] == rdg) {
+				rc.wits = rdg_wits[rdg_ind];
+				rc.roots = rdg_roots[rdg_ind];
+				break;
+			}
+		}
+		row.rdgs.push_back(rc);
+	}
+	return row;
+}
+
+/**
+ * Returns the rows of this coherence_metrics_table.
+ */
+list<coherence_metrics_table_row> coherence_metrics_table::get_rows() const {
+	return rows;
+}
+
+/**
+ * Given an output stream, prints this coherence metrics table in fixed-width format.
+ * The roots of each reading are listed in the ROOTS column as reading:roots pairs.
+ */
+void coherence_metrics_table::to_fixed_width(ostream & out) {
+	//Print the header row:
+	out << std::left << std::setw(24) << "VU";
+	out << std::right << std::setw(8) << "CON";
+	out << std::right << std::setw(8) << "CHANGE";
+	out << std::right << std::setw(8) << "LOSS";
+	out << std::right << std::setw(8) << "MAXCON";
+	out << std::setw(4) << ""; //buffer space between right-aligned and left-aligned columns
+	out << std::left << "ROOTS";
+	out << "\n\n";
+	//Print the subsequent rows:
+	for (coherence_metrics_table_row row : rows) {
+		out << std::left << std::setw(24) << row.label;
+		out << std::right << std::setw(8) << (row.connectivity == numeric_limits<int>::max() ? "ABS" : to_string(row.connectivity));
+		out << std::right << std::setw(8) << row.change;
+		out << std::right << std::setw(8) << row.loss;
+		out << std::right << std::setw(8) << (row.max_con >= 0 ? to_string(row.max_con) : "");
+		out << std::setw(4) << ""; //buffer space between right-aligned and left-aligned columns
+		unsigned int rdg_num = 0;
+		for (reading_coherence rc : row.rdgs) {
+			out << rc.rdg << ":" << rc.roots;
+			if (rdg_num < row.rdgs.size() - 1) {
+				out << " ";
+			}
+			rdg_num++;
+		}
+		out << "\n";
+	}
+	out << endl;
+	return;
+}
+
+/**
+ * Given an output stream, prints this coherence metrics table in comma-separated value (CSV) format.
+ * The variation unit labels and reading IDs are assumed not to contain commas; if they do, then they will need to be manually escaped in the output.
+ */
+void coherence_metrics_table::to_csv(ostream & out) {
+	//Print the header row:
+	out << "VU" << ",";
+	out << "CON" << ",";
+	out << "CHANGE" << ",";
+	out << "LOSS" << ",";
+	out << "MAXCON" << ",";
+	out << "ROOTS" << "\n";
+	//Print the subsequent rows:
+	for (coherence_metrics_table_row row : rows) {
+		out << row.label << ",";
+		out << (row.connectivity == numeric_limits<int>::max() ? "ABS" : to_string(row.connectivity)) << ",";
+		out << row.change << ",";
+		out << row.loss << ",";
+		out << (row.max_con >= 0 ? to_string(row.max_con) : "") << ",";
+		unsigned int rdg_num = 0;
+		for (reading_coherence rc : row.rdgs) {
+			out << rc.rdg << ":" << rc.roots;
+			if (rdg_num < row.rdgs.size() - 1) {
+				out << " ";
+			}
+			rdg_num++;
+		}
+		out << "\n";
+	}
+	out << endl;
+	return;
+}
+
+/**
+ * Given an output stream, prints this coherence metrics table in tab-separated value (TSV) format.
+ * The variation unit labels and reading IDs are assumed not to contain tabs; if they do, then they will need to be manually escaped in the output.
+ */
+void coherence_metrics_table::to_tsv(ostream & out) {
+	//Print the header row:
+	out << "VU" << "\t";
+	out << "CON" << "\t";
+	out << "CHANGE" << "\t";
+	out << "LOSS" << "\t";
+	out << "MAXCON" << "\t";
+	out << "ROOTS" << "\n";
+	//Print the subsequent rows:
+	for (coherence_metrics_table_row row : rows) {
+		out << row.label << "\t";
+		out << (row.connectivity == numeric_limits<int>::max() ? "ABS" : to_string(row.connectivity)) << "\t";
+		out << row.change << "\t";
+		out << row.loss << "\t";
+		out << (row.max_con >= 0 ? to_string(row.max_con) : "") << "\t";
+		unsigned int rdg_num = 0;
+		for (reading_coherence rc : row.rdgs) {
+			out << rc.rdg << ":" << rc.roots;
+			if (rdg_num < row.rdgs.size() - 1) {
+				out << " ";
+			}
+			rdg_num++;
+		}
+		out << "\n";
+	}
+	out << endl;
+	return;
+}
+
+/**
+ * Given a JSON writer, writes this coherence metrics table to it as a JavaScript Object Notation (JSON) object.
+ */
+void coherence_metrics_table::to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the rows array, with each row as an object:
+	writer.key("rows");
+	writer.begin_array();
+	for (const coherence_metrics_table_row & row : rows) {
+		writer.begin_object();
+		writer.key("id");
+		writer.value(row.id);
+		writer.key("label");
+		writer.value(row.label);
+		writer.key("connectivity");
+		writer.value(row.connectivity);
+		writer.key("change");
+		writer.value(row.change);
+		writer.key("loss");
+		writer.value(row.loss);
+		writer.key("max_con");
+		writer.value(row.max_con);
+		//Add the readings array, with each reading's coherence as an object:
+		writer.key("rdgs");
+		writer.begin_array();
+		for (const reading_coherence & rc : row.rdgs) {
+			writer.begin_object();
+			writer.key("rdg");
+			writer.value(rc.rdg);
+			writer.key("wits");
+			writer.value(rc.wits);
+			writer.key("roots");
+			writer.value(rc.roots);
+			writer.end_object();
+		}
+		writer.end_array();
+		writer.end_object();
+	}
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
+/**
+ * Given an output stream, prints this coherence metrics table in JavaScript Object Notation (JSON) format.
+ */
+void coherence_metrics_table::to_json(ostream & out) {
+	json_writer writer(out);
+	to_json(writer);
+	return;
+}
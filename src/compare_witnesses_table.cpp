@@ -15,6 +15,7 @@
 
 #include "witness.h"
 #include "compare_witnesses_table.h"
+#include "json_writer.h"
 
 using namespace std;
 
@@ -29,7 +30,7 @@ compare_witnesses_table::compare_witnesses_table() {
  * Constructs a compare witnesses table relative to a given witness,
  * given a list of witness IDs in input order and a set of witness IDs by which to filter the rows.
  */
- compare_witnesses_table::compare_witnesses_table(const witness & wit, const list<string> list_wit, const set<string> & filter_wits) {
+ compare_witnesses_table::compare_witnesses_table(const witness & wit, const list<string> & list_wit, const set<string> & filter_wits) {
     rows = list<compare_witnesses_table_row>();
     id = wit.get_id();
     //Start by populating the table completely with this witness's comparisons to all other witnesses:
@@ -89,6 +90,16 @@ compare_witnesses_table::compare_witnesses_table() {
 	}
 }
 
+/**
+ * Constructs a compare witnesses table from the ID of its primary witness, the number of passages where that witness is extant,
+ * and a list of rows that have already been ranked and sorted.
+ */
+compare_witnesses_table::compare_witnesses_table(const string & _id, int _primary_extant, const list<compare_witnesses_table_row> & _rows) {
+	id = _id;
+	primary_extant = _primary_extant;
+	rows = _rows;
+}
+
 /**
  * Default destructor.
  */
@@ -247,52 +258,59 @@ void compare_witnesses_table::to_tsv(ostream & out) {
 	return;
 }
 
+/**
+ * Given a JSON writer, writes this witness comparison table to it as a JavaScript Object Notation (JSON) object.
+ */
+void compare_witnesses_table::to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("primary_wit");
+	writer.value(id);
+	writer.key("primary_extant");
+	writer.value(primary_extant);
+	//Add the rows array, with each row as an object:
+	writer.key("rows");
+	writer.begin_array();
+	for (const compare_witnesses_table_row & row : rows) {
+		writer.begin_object();
+		writer.key("id");
+		writer.value(row.id);
+		writer.key("dir");
+		writer.value(row.dir);
+		writer.key("nr");
+		writer.value(row.nr > 0 ? to_string(row.nr) : "");
+		writer.key("pass");
+		writer.value(row.pass);
+		writer.key("eq");
+		writer.value(row.eq);
+		writer.key("perc");
+		writer.value(row.perc);
+		writer.key("prior");
+		writer.value(row.prior);
+		writer.key("posterior");
+		writer.value(row.posterior);
+		writer.key("norel");
+		writer.value(row.norel);
+		writer.key("uncl");
+		writer.value(row.uncl);
+		writer.key("expl");
+		writer.value(row.expl);
+		writer.key("cost");
+		writer.value(row.cost >= 0 ? json_writer::format_number(row.cost) : "");
+		writer.end_object();
+	}
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
 /**
  * Given an output stream, prints this witness comparison table in JavaScript Object Notation (JSON) format.
- * The witness IDs are assumed not to contain characters that need to be escaped in URLs.
  */
 void compare_witnesses_table::to_json(ostream & out) {
-    //Open the root object:
-    out << "{";
-    //Add the metadata fields:
-	out << "\"primary_wit\":" << "\"" << id << "\"" << ",";
-    out << "\"primary_extant\":" << primary_extant << ",";
-    //Open the rows array:
-    out << "\"rows\":" << "[";
-    //Print each row as an object:
-	unsigned int row_num = 0;
-	for (compare_witnesses_table_row row : rows) {
-        //Open the row object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"id\":" << "\"" << row.id << "\"" << ",";
-		out << "\"dir\":" << row.dir << ",";
-		out << "\"nr\":" << "\"" << (row.nr > 0 ? to_string(row.nr) : "") << "\"" << ",";
-		out << "\"pass\":" << row.pass << ",";
-		out << "\"eq\":" << row.eq << ",";
-        out << "\"perc\":" << row.perc << ",";
-		out << "\"prior\":" << row.prior << ",";
-		out << "\"posterior\":" << row.posterior << ",";
-		out << "\"norel\":" << row.norel << ",";
-        out << "\"uncl\":" << row.uncl << ",";
-        out << "\"expl\":" << row.expl << ",";
-		if (row.cost >= 0) {
-			out << "\"cost\":" << "\"" << row.cost << "\"";
-		}
-		else {
-			out << "\"cost\":" << "\"" << "" << "\"";
-		}
-        //Close the row object:
-        out << "}";
-        //Add a comma if this is not the last row:
-        if (row_num < rows.size() - 1) {
-            out << ",";
-        }
-		row_num++;
-	}
-    //Close the rows array:
-    out << "]";
-    //Close the root object:
-    out << "}";
+	json_writer writer(out);
+	to_json(writer);
 	return;
 }
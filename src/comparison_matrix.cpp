@@ -0,0 +1,480 @@
+/*
+ * comparison_matrix.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <list>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "witness.h"
+#include "compare_witnesses_table.h"
+#include "parallel_for.h"
+#include "comparison_matrix.h"
+
+using namespace std;
+
+//Magic string at the start of a binary comparison matrix file:
+const string COMPARISON_MATRIX_MAGIC = "OCBGMCMP";
+//Version of the binary comparison matrix format:
+const uint32_t COMPARISON_MATRIX_VERSION = 1;
+//Number of columns in a comparison matrix:
+const unsigned int COMPARISON_MATRIX_N_COLUMNS = 11;
+//Names of the columns, in the order in which they are written:
+const string COMPARISON_MATRIX_COLUMN_NAMES[COMPARISON_MATRIX_N_COLUMNS] = {"dir", "nr", "pass", "eq", "perc", "prior", "posterior", "norel", "uncl", "expl", "cost"};
+//NumPy-style type strings of the columns (32-bit little-endian integers or floating-point numbers), in the same order:
+const string COMPARISON_MATRIX_COLUMN_TYPES[COMPARISON_MATRIX_N_COLUMNS] = {"<i4", "<i4", "<i4", "<i4", "<f4", "<i4", "<i4", "<i4", "<i4", "<i4", "<f4"};
+//Columns written by default as NumPy .npy files:
+const list<string> COMPARISON_MATRIX_NPY_COLUMNS = list<string>({"eq", "pass", "prior", "posterior", "cost"});
+//Magic string at the start of a NumPy .npy file, followed by the major and minor version of its format:
+const string NPY_MAGIC = string("\x93NUMPY\x01\x00", 8);
+
+/**
+ * Returns the index of the comparison matrix column with the given name,
+ * or the number of columns if there is no column with that name.
+ */
+unsigned int get_comparison_matrix_column_index(const string & name) {
+	return (unsigned int) (find(COMPARISON_MATRIX_COLUMN_NAMES, COMPARISON_MATRIX_COLUMN_NAMES + COMPARISON_MATRIX_N_COLUMNS, name) - COMPARISON_MATRIX_COLUMN_NAMES);
+}
+
+/**
+ * Appends the given 32-bit unsigned integer to the given buffer in little-endian byte order.
+ */
+void append_uint32(string & buffer, uint32_t n) {
+	for (unsigned int i = 0; i < 4; i++) {
+		buffer += (char) ((n >> (8 * i)) & 0xff);
+	}
+	return;
+}
+
+/**
+ * Appends the given 64-bit unsigned integer to the given buffer in little-endian byte order.
+ */
+void append_uint64(string & buffer, uint64_t n) {
+	for (unsigned int i = 0; i < 8; i++) {
+		buffer += (char) ((n >> (8 * i)) & 0xff);
+	}
+	return;
+}
+
+/**
+ * Appends the given string to the given buffer, preceded by its length in bytes as a 32-bit unsigned integer.
+ */
+void append_length_prefixed(string & buffer, const string & s) {
+	append_uint32(buffer, (uint32_t) s.size());
+	buffer += s;
+	return;
+}
+
+/**
+ * Reads a 32-bit unsigned integer in little-endian byte order from the given buffer at the given position, advancing the position past it.
+ * Throws a runtime_error if the buffer ends before the integer does.
+ */
+uint32_t read_uint32(const string & buffer, size_t & pos) {
+	if (buffer.size() < pos + 4) {
+		throw runtime_error("The comparison matrix data ended unexpectedly.");
+	}
+	uint32_t n = 0;
+	for (unsigned int i = 0; i < 4; i++) {
+		n |= (uint32_t) (unsigned char) buffer[pos + i] << (8 * i);
+	}
+	pos += 4;
+	return n;
+}
+
+/**
+ * Reads a 64-bit unsigned integer in little-endian byte order from the given buffer at the given position, advancing the position past it.
+ * Throws a runtime_error if the buffer ends before the integer does.
+ */
+uint64_t read_uint64(const string & buffer, size_t & pos) {
+	if (buffer.size() < pos + 8) {
+		throw runtime_error("The comparison matrix data ended unexpectedly.");
+	}
+	uint64_t n = 0;
+	for (unsigned int i = 0; i < 8; i++) {
+		n |= (uint64_t) (unsigned char) buffer[pos + i] << (8 * i);
+	}
+	pos += 8;
+	return n;
+}
+
+/**
+ * Reads a string preceded by its length in bytes as a 32-bit unsigned integer from the given buffer at the given position, advancing the position past it.
+ * Throws a runtime_error if the buffer ends before the string does.
+ */
+string read_length_prefixed(const string & buffer, size_t & pos) {
+	uint32_t length = read_uint32(buffer, pos);
+	if (buffer.size() < pos + length) {
+		throw runtime_error("The comparison matrix data ended unexpectedly.");
+	}
+	string s = buffer.substr(pos, length);
+	pos += length;
+	return s;
+}
+
+/**
+ * Default constructor.
+ */
+comparison_matrix::comparison_matrix() {
+
+}
+
+/**
+ * Constructs a comparison matrix from the genealogical comparisons of the given witnesses, in the order in which they are given.
+ * The rows for different primary witnesses are populated in parallel over the given number of worker threads (0 for as many as the hardware supports).
+ * The metrics for each pair are the same as those in the row for the secondary witness in the primary witness's compare witnesses table.
+ */
+comparison_matrix::comparison_matrix(const list<witness> & witnesses, unsigned int threads) {
+	ids = vector<string>();
+	for (const witness & wit : witnesses) {
+		ids.push_back(wit.get_id());
+	}
+	unsigned int n = (unsigned int) ids.size();
+	dir = vector<int32_t>(n * n, 0);
+	nr = vector<int32_t>(n * n, 0);
+	pass = vector<int32_t>(n * n, 0);
+	eq = vector<int32_t>(n * n, 0);
+	perc = vector<float>(n * n, 0);
+	prior = vector<int32_t>(n * n, 0);
+	posterior = vector<int32_t>(n * n, 0);
+	norel = vector<int32_t>(n * n, 0);
+	uncl = vector<int32_t>(n * n, 0);
+	expl = vector<int32_t>(n * n, 0);
+	cost = vector<float>(n * n, -1);
+	vector<const witness *> witness_ptrs = vector<const witness *>();
+	for (const witness & wit : witnesses) {
+		witness_ptrs.push_back(&wit);
+	}
+	//Each primary witness's row is independent of the others, so the rows can be populated in parallel:
+	parallel_for(n, threads, [&](unsigned int i) {
+		const witness & wit = *witness_ptrs[i];
+		vector<unsigned int> ancestor_inds = vector<unsigned int>();
+		for (unsigned int j = 0; j < n; j++) {
+			unsigned int ind = i * n + j;
+			const genealogical_comparison & comp = wit.get_genealogical_comparison_ref(ids[j]);
+			pass[ind] = (int32_t) comp.extant.cardinality();
+			eq[ind] = (int32_t) comp.agreements.cardinality();
+			perc[ind] = pass[ind] > 0 ? (100 * float(eq[ind]) / float(pass[ind])) : 0;
+			prior[ind] = (int32_t) comp.prior.cardinality();
+			posterior[ind] = (int32_t) comp.posterior.cardinality();
+			norel[ind] = (int32_t) comp.norel.cardinality();
+			uncl[ind] = (int32_t) comp.unclear.cardinality();
+			expl[ind] = (int32_t) comp.explained.cardinality();
+			//The diagonal entries have no direction, rank, or cost:
+			if (j == i) {
+				continue;
+			}
+			if (posterior[ind] > prior[ind]) {
+				dir[ind] = 1;
+				cost[ind] = comp.cost;
+				ancestor_inds.push_back(j);
+			}
+			else if (posterior[ind] < prior[ind]) {
+				dir[ind] = -1;
+				nr[ind] = -1;
+			}
+		}
+		//Rank the potential ancestors from highest number of agreements to lowest, with ties sharing the same rank:
+		stable_sort(ancestor_inds.begin(), ancestor_inds.end(), [&](unsigned int j1, unsigned int j2) {
+			return eq[i * n + j1] > eq[i * n + j2];
+		});
+		int32_t rank = 0;
+		int32_t rank_value = -1;
+		for (unsigned int j : ancestor_inds) {
+			if (rank == 0 || eq[i * n + j] < rank_value) {
+				rank_value = eq[i * n + j];
+				rank++;
+			}
+			nr[i * n + j] = rank;
+		}
+	});
+}
+
+/**
+ * Constructs a comparison matrix by reading its binary export from the given input stream.
+ * Columns with names that are not recognized are skipped.
+ * Throws a runtime_error if the data is not a comparison matrix in a supported version of the format or if any of its columns are missing or malformed.
+ */
+comparison_matrix::comparison_matrix(istream & in) {
+	string data = string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	size_t pos = 0;
+	if (data.compare(0, COMPARISON_MATRIX_MAGIC.size(), COMPARISON_MATRIX_MAGIC) != 0) {
+		throw runtime_error("The input is not a comparison matrix.");
+	}
+	pos += COMPARISON_MATRIX_MAGIC.size();
+	uint32_t version = read_uint32(data, pos);
+	if (version != COMPARISON_MATRIX_VERSION) {
+		throw runtime_error("The comparison matrix format version " + to_string(version) + " is not supported.");
+	}
+	uint32_t n = read_uint32(data, pos);
+	uint32_t n_columns = read_uint32(data, pos);
+	ids = vector<string>();
+	for (uint32_t i = 0; i < n; i++) {
+		ids.push_back(read_length_prefixed(data, pos));
+	}
+	vector<int32_t> * int_columns[COMPARISON_MATRIX_N_COLUMNS] = {&dir, &nr, &pass, &eq, nullptr, &prior, &posterior, &norel, &uncl, &expl, nullptr};
+	vector<float> * float_columns[COMPARISON_MATRIX_N_COLUMNS] = {nullptr, nullptr, nullptr, nullptr, &perc, nullptr, nullptr, nullptr, nullptr, nullptr, &cost};
+	vector<bool> columns_read = vector<bool>(COMPARISON_MATRIX_N_COLUMNS, false);
+	uint64_t block_size = 4 * (uint64_t) n * (uint64_t) n;
+	for (uint32_t c = 0; c < n_columns; c++) {
+		string name = read_length_prefixed(data, pos);
+		string type = read_length_prefixed(data, pos);
+		uint64_t offset = read_uint64(data, pos);
+		uint64_t length = read_uint64(data, pos);
+		unsigned int col_ind = get_comparison_matrix_column_index(name);
+		if (col_ind == COMPARISON_MATRIX_N_COLUMNS) {
+			continue;
+		}
+		if (type != COMPARISON_MATRIX_COLUMN_TYPES[col_ind] || length != block_size || offset > data.size() || data.size() - offset < length) {
+			throw runtime_error("The comparison matrix column " + name + " is malformed.");
+		}
+		//Decode the block's values:
+		size_t value_pos = (size_t) offset;
+		vector<uint32_t> values = vector<uint32_t>(n * n);
+		for (uint32_t & value : values) {
+			value = read_uint32(data, value_pos);
+		}
+		if (int_columns[col_ind] != nullptr) {
+			*int_columns[col_ind] = vector<int32_t>(values.begin(), values.end());
+		}
+		else {
+			vector<float> & column = *float_columns[col_ind];
+			column = vector<float>(n * n);
+			memcpy(column.data(), values.data(), values.size() * sizeof(float));
+		}
+		columns_read[col_ind] = true;
+	}
+	for (unsigned int col_ind = 0; col_ind < COMPARISON_MATRIX_N_COLUMNS; col_ind++) {
+		if (!columns_read[col_ind]) {
+			throw runtime_error("The comparison matrix column " + COMPARISON_MATRIX_COLUMN_NAMES[col_ind] + " is missing.");
+		}
+	}
+}
+
+/**
+ * Default destructor.
+ */
+comparison_matrix::~comparison_matrix() {
+
+}
+
+/**
+ * Returns the IDs of the witnesses in this matrix, in the order of its rows and columns.
+ */
+vector<string> comparison_matrix::get_ids() const {
+	return ids;
+}
+
+/**
+ * Returns the number of witnesses in this matrix.
+ */
+unsigned int comparison_matrix::size() const {
+	return (unsigned int) ids.size();
+}
+
+/**
+ * Returns the metrics of the comparison of the primary witness with the given index to the secondary witness with the given index,
+ * in the form of a row of the primary witness's compare witnesses table.
+ */
+compare_witnesses_table_row comparison_matrix::get_entry(unsigned int primary_ind, unsigned int secondary_ind) const {
+	unsigned int ind = primary_ind * (unsigned int) ids.size() + secondary_ind;
+	compare_witnesses_table_row row;
+	row.id = ids[secondary_ind];
+	row.dir = dir[ind];
+	row.nr = nr[ind];
+	row.pass = pass[ind];
+	row.perc = perc[ind];
+	row.eq = eq[ind];
+	row.prior = prior[ind];
+	row.posterior = posterior[ind];
+	row.norel = norel[ind];
+	row.uncl = uncl[ind];
+	row.expl = expl[ind];
+	row.cost = cost[ind];
+	return row;
+}
+
+/**
+ * Returns the witness comparison table for every witness in this matrix, in the same order as the witness IDs.
+ * The rows of each table are sorted from highest number of agreements to lowest (with ties in witness order), as in the table constructed from a single witness.
+ * If the filter set is not empty, then only rows for the witnesses it contains are included;
+ * if top_k is positive, then each table is truncated to its first top_k rows after filtering.
+ * The tables are independent of each other, so they are populated in parallel over the given number of worker threads (0 for as many as the hardware supports).
+ */
+vector<compare_witnesses_table> comparison_matrix::get_compare_witnesses_tables(const set<string> & filter_wits, unsigned int top_k, unsigned int threads) const {
+	unsigned int n = (unsigned int) ids.size();
+	//Resolve the filter set to witness indices once, so that the rows can be selected by index:
+	vector<bool> included = vector<bool>(n, filter_wits.empty());
+	for (unsigned int j = 0; j < n; j++) {
+		if (filter_wits.find(ids[j]) != filter_wits.end()) {
+			included[j] = true;
+		}
+	}
+	vector<compare_witnesses_table> tables = vector<compare_witnesses_table>(n);
+	parallel_for(n, threads, [&](unsigned int i) {
+		vector<unsigned int> secondary_inds = vector<unsigned int>();
+		secondary_inds.reserve(n);
+		for (unsigned int j = 0; j < n; j++) {
+			if (j != i && included[j]) {
+				secondary_inds.push_back(j);
+			}
+		}
+		//Order the rows by decreasing number of agreements, breaking ties by witness order; only the first top_k rows need to be sorted:
+		auto compare_rows = [&](unsigned int j1, unsigned int j2) {
+			if (eq[i * n + j1] != eq[i * n + j2]) {
+				return eq[i * n + j1] > eq[i * n + j2];
+			}
+			return j1 < j2;
+		};
+		if (top_k > 0 && top_k < secondary_inds.size()) {
+			partial_sort(secondary_inds.begin(), secondary_inds.begin() + top_k, secondary_inds.end(), compare_rows);
+			secondary_inds.resize(top_k);
+		}
+		else {
+			sort(secondary_inds.begin(), secondary_inds.end(), compare_rows);
+		}
+		list<compare_witnesses_table_row> rows = list<compare_witnesses_table_row>();
+		for (unsigned int j : secondary_inds) {
+			rows.push_back(get_entry(i, j));
+		}
+		tables[i] = compare_witnesses_table(ids[i], pass[i * n + i], rows);
+	});
+	return tables;
+}
+
+/**
+ * Returns the values of the column with the given index, in row-major order, as 32-bit little-endian integers or floating-point numbers.
+ */
+string comparison_matrix::get_column_data(unsigned int col_ind) const {
+	const vector<int32_t> * int_columns[COMPARISON_MATRIX_N_COLUMNS] = {&dir, &nr, &pass, &eq, nullptr, &prior, &posterior, &norel, &uncl, &expl, nullptr};
+	const vector<float> * float_columns[COMPARISON_MATRIX_N_COLUMNS] = {nullptr, nullptr, nullptr, nullptr, &perc, nullptr, nullptr, nullptr, nullptr, nullptr, &cost};
+	string data = string();
+	data.reserve(4 * ids.size() * ids.size());
+	if (int_columns[col_ind] != nullptr) {
+		for (int32_t value : *int_columns[col_ind]) {
+			append_uint32(data, (uint32_t) value);
+		}
+	}
+	else {
+		for (float value : *float_columns[col_ind]) {
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			append_uint32(data, bits);
+		}
+	}
+	return data;
+}
+
+/**
+ * Given an output stream (which should be opened in binary mode), writes this matrix to it in the binary columnar format described in the class documentation.
+ */
+void comparison_matrix::to_binary(ostream & out) const {
+	uint32_t n = (uint32_t) ids.size();
+	uint64_t block_size = 4 * (uint64_t) n * (uint64_t) n;
+	uint64_t padded_block_size = (block_size + 7) / 8 * 8;
+	//Work out the size of the header, so that the offsets of the blocks can be written in it:
+	uint64_t header_size = COMPARISON_MATRIX_MAGIC.size() + 3 * 4;
+	for (const string & id : ids) {
+		header_size += 4 + id.size();
+	}
+	for (unsigned int col_ind = 0; col_ind < COMPARISON_MATRIX_N_COLUMNS; col_ind++) {
+		header_size += 4 + COMPARISON_MATRIX_COLUMN_NAMES[col_ind].size() + 4 + COMPARISON_MATRIX_COLUMN_TYPES[col_ind].size() + 8 + 8;
+	}
+	uint64_t data_start = (header_size + 7) / 8 * 8;
+	//Then write the header:
+	string buffer = COMPARISON_MATRIX_MAGIC;
+	append_uint32(buffer, COMPARISON_MATRIX_VERSION);
+	append_uint32(buffer, n);
+	append_uint32(buffer, COMPARISON_MATRIX_N_COLUMNS);
+	for (const string & id : ids) {
+		append_length_prefixed(buffer, id);
+	}
+	for (unsigned int col_ind = 0; col_ind < COMPARISON_MATRIX_N_COLUMNS; col_ind++) {
+		append_length_prefixed(buffer, COMPARISON_MATRIX_COLUMN_NAMES[col_ind]);
+		append_length_prefixed(buffer, COMPARISON_MATRIX_COLUMN_TYPES[col_ind]);
+		append_uint64(buffer, data_start + col_ind * padded_block_size);
+		append_uint64(buffer, block_size);
+	}
+	buffer.resize((size_t) data_start, '\0');
+	out.write(buffer.data(), buffer.size());
+	//Then write each column's block:
+	for (unsigned int col_ind = 0; col_ind < COMPARISON_MATRIX_N_COLUMNS; col_ind++) {
+		buffer = get_column_data(col_ind);
+		buffer.resize((size_t) padded_block_size, '\0');
+		out.write(buffer.data(), buffer.size());
+	}
+	out.flush();
+	return;
+}
+
+/**
+ * Given an output stream (which should be opened in binary mode) and the name of a column (e.g., "eq" for agreements or "pass" for mutually extant passages),
+ * writes the W x W matrix of that column to it as a NumPy .npy file (format version 1.0), with the rows and columns in the order of this matrix's witness IDs.
+ * Throws a runtime_error if there is no column with the given name.
+ */
+void comparison_matrix::to_npy(ostream & out, const string & column) const {
+	unsigned int col_ind = get_comparison_matrix_column_index(column);
+	if (col_ind == COMPARISON_MATRIX_N_COLUMNS) {
+		throw runtime_error("The comparison matrix has no column " + column + ".");
+	}
+	//The header is a Python dictionary literal, padded with spaces and ended with a newline so that the data starts at a multiple of 64 bytes:
+	string header = "{'descr': '" + COMPARISON_MATRIX_COLUMN_TYPES[col_ind] + "', 'fortran_order': False, 'shape': (" + to_string(ids.size()) + ", " + to_string(ids.size()) + "), }";
+	size_t prefix_size = NPY_MAGIC.size() + 2;
+	size_t padded_header_size = (prefix_size + header.size() + 1 + 63) / 64 * 64 - prefix_size;
+	header.resize(padded_header_size - 1, ' ');
+	header += '\n';
+	string buffer = NPY_MAGIC;
+	buffer += (char) (padded_header_size & 0xff);
+	buffer += (char) ((padded_header_size >> 8) & 0xff);
+	buffer += header;
+	out.write(buffer.data(), buffer.size());
+	buffer = get_column_data(col_ind);
+	out.write(buffer.data(), buffer.size());
+	out.flush();
+	return;
+}
+
+/**
+ * Given an output stream, writes this matrix's witness IDs to it, one per line, in the order of the rows and columns of its .npy matrices.
+ */
+void comparison_matrix::ids_to_txt(ostream & out) const {
+	for (const string & id : ids) {
+		out << id << "\n";
+	}
+	out.flush();
+	return;
+}
+
+/**
+ * Given a path prefix, writes the matrices of agreements ("eq"), mutually extant passages ("pass"), prior and posterior readings ("prior" and "posterior"), and costs ("cost")
+ * to .npy files at the prefix followed by an underscore and the column name (e.g., "prefix_eq.npy"),
+ * and writes the witness IDs for their rows and columns to a sidecar file at the prefix followed by "_ids.txt".
+ * Throws a runtime_error if any of the files cannot be opened for writing.
+ */
+void comparison_matrix::to_npy_files(const string & prefix) const {
+	for (const string & column : COMPARISON_MATRIX_NPY_COLUMNS) {
+		string path = prefix + "_" + column + ".npy";
+		ofstream out(path, ios::out | ios::binary);
+		if (!out.is_open()) {
+			throw runtime_error("The file " + path + " could not be opened for writing.");
+		}
+		to_npy(out, column);
+	}
+	string ids_path = prefix + "_ids.txt";
+	ofstream ids_out(ids_path);
+	if (!ids_out.is_open()) {
+		throw runtime_error("The file " + ids_path + " could not be opened for writing.");
+	}
+	ids_to_txt(ids_out);
+	return;
+}
@@ -0,0 +1,194 @@
+/*
+ * dot_writer.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+
+#include "dot_writer.h"
+
+using namespace std;
+
+//Line style attributes for edges, from weakest to strongest flow strength:
+const char * STRENGTH_STYLE_ATTRIBUTES[] = {"style=dotted", "style=dashed", "style=solid", "style=bold"};
+
+/**
+ * Constructs a .dot writer that writes to the given output stream,
+ * using an internal buffer of (approximately) the given size in bytes.
+ */
+dot_writer::dot_writer(ostream & _out, size_t _buffer_size) {
+	out = &_out;
+	buffer_size = _buffer_size;
+	buffer = string();
+	buffer.reserve(buffer_size + 256);
+}
+
+/**
+ * Default destructor. Writes anything left in the buffer to the output stream.
+ */
+dot_writer::~dot_writer() {
+	flush();
+}
+
+/**
+ * Returns the line style attribute for an edge with the given flow strength.
+ */
+const char * dot_writer::strength_style(float strength) {
+	if (strength < 0.01) {
+		return STRENGTH_STYLE_ATTRIBUTES[0];
+	}
+	else if (strength < 0.05) {
+		return STRENGTH_STYLE_ATTRIBUTES[1];
+	}
+	else if (strength < 0.1) {
+		return STRENGTH_STYLE_ATTRIBUTES[2];
+	}
+	return STRENGTH_STYLE_ATTRIBUTES[3];
+}
+
+/**
+ * Writes the buffer to the output stream if it has reached its size.
+ */
+void dot_writer::flush_if_full() {
+	if (buffer.size() >= buffer_size) {
+		flush();
+	}
+	return;
+}
+
+/**
+ * Appends the given string to the output as is.
+ */
+void dot_writer::write(const string & s) {
+	buffer += s;
+	flush_if_full();
+	return;
+}
+
+/**
+ * Appends the given null-terminated string to the output as is.
+ */
+void dot_writer::write(const char * s) {
+	buffer += s;
+	flush_if_full();
+	return;
+}
+
+/**
+ * Appends the given character to the output.
+ */
+void dot_writer::write(char c) {
+	buffer += c;
+	flush_if_full();
+	return;
+}
+
+/**
+ * Appends the given signed integer to the output in decimal format.
+ */
+void dot_writer::write(int n) {
+	if (n < 0) {
+		buffer += '-';
+		write((unsigned int) (-(long long) n));
+		return;
+	}
+	write((unsigned int) n);
+	return;
+}
+
+/**
+ * Appends the given unsigned integer to the output in decimal format.
+ */
+void dot_writer::write(unsigned int n) {
+	char digits[10];
+	unsigned int n_digits = 0;
+	do {
+		digits[n_digits++] = (char) ('0' + n % 10);
+		n /= 10;
+	} while (n > 0);
+	while (n_digits > 0) {
+		buffer += digits[--n_digits];
+	}
+	flush_if_full();
+	return;
+}
+
+/**
+ * Appends the given number to the output in fixed-point format with the given number of digits after the decimal point.
+ */
+void dot_writer::write_fixed(double x, int precision) {
+	char buf[64];
+	int length = snprintf(buf, sizeof(buf), "%.*f", precision, x);
+	//If the number does not fit in the stack buffer, then format it again into one that is large enough:
+	if (length >= (int) sizeof(buf)) {
+		string s = string(length + 1, '\0');
+		snprintf(&s[0], s.size(), "%.*f", precision, x);
+		s.resize(length);
+		buffer += s;
+	}
+	else if (length > 0) {
+		buffer.append(buf, length);
+	}
+	flush_if_full();
+	return;
+}
+
+/**
+ * Starts a line describing an edge between the vertices with the given indices, to be followed by its attributes.
+ * The line is indented for a subgraph of the graph.
+ */
+void dot_writer::begin_edge(unsigned int ancestor_ind, unsigned int descendant_ind) {
+	buffer += "\t\t";
+	write(ancestor_ind);
+	buffer += " -> ";
+	write(descendant_ind);
+	buffer += " [";
+	edge_has_attributes = false;
+	return;
+}
+
+/**
+ * Adds the given attribute fragment to the edge currently being written, separating it from any previous attribute.
+ * Further text written before the next attribute or the end of the edge is appended to this attribute.
+ */
+void dot_writer::attribute(const char * fragment) {
+	if (edge_has_attributes) {
+		buffer += ", ";
+	}
+	buffer += fragment;
+	edge_has_attributes = true;
+	return;
+}
+
+/**
+ * Adds the given attribute fragment to the edge currently being written, separating it from any previous attribute.
+ * Further text written before the next attribute or the end of the edge is appended to this attribute.
+ */
+void dot_writer::attribute(const string & fragment) {
+	attribute(fragment.c_str());
+	return;
+}
+
+/**
+ * Ends the line describing the edge currently being written.
+ */
+void dot_writer::end_edge() {
+	buffer += "];\n";
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes everything in the buffer to the output stream.
+ */
+void dot_writer::flush() {
+	if (!buffer.empty()) {
+		out->write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+	return;
+}
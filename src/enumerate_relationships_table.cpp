@@ -11,72 +11,40 @@
 #include <list>
 #include <vector>
 #include <set>
+#include <functional>
 
+#include <roaring/roaring.hh>
 #include "witness.h"
 #include "enumerate_relationships_table.h"
+#include "json_writer.h"
 
 using namespace std;
+using namespace roaring;
+
+//Empty genealogical comparison and variation unit IDs to which default-constructed tables refer:
+const genealogical_comparison EMPTY_GENEALOGICAL_COMPARISON = genealogical_comparison();
+const vector<string> EMPTY_VARIATION_UNIT_IDS = vector<string>();
 
  /**
  * Default constructor.
  */
 enumerate_relationships_table::enumerate_relationships_table() {
-
+	comp = &EMPTY_GENEALOGICAL_COMPARISON;
+	variation_unit_ids = &EMPTY_VARIATION_UNIT_IDS;
 }
 
 /**
  * Constructs an enumerate relationships table for a given genealogical comparison,
  * given a genealogical comparison and a vector of variation unit IDs.
+ * The table refers to both rather than copying them, so they must outlive it.
  */
- enumerate_relationships_table::enumerate_relationships_table(const genealogical_comparison & comp, const vector<string> & variation_unit_ids) {
+ enumerate_relationships_table::enumerate_relationships_table(const genealogical_comparison & _comp, const vector<string> & _variation_unit_ids) {
 	//Copy in the primary and secondary witness IDs first:
-    primary_wit_id = comp.primary_wit;
-	secondary_wit_id = comp.secondary_wit;
-	//Initialize a placeholder for iterating through each set index in a genealogical comparison bitmap:
-	uint32_t vu_index;
-	//Then populate the lists of variation unit IDs for each type of genealogical relationship:
-	extant = list<string>();
-	uint64_t extant_cardinality = comp.extant.cardinality();
-	for (uint32_t i = 0; i < extant_cardinality; i++) {
-    	comp.extant.select(i, &vu_index);
-		extant.push_back(variation_unit_ids[vu_index]);
-	}
-	agreements = list<string>();
-	uint64_t agreements_cardinality = comp.agreements.cardinality();
-	for (uint32_t i = 0; i < agreements_cardinality; i++) {
-    	comp.agreements.select(i, &vu_index);
-		agreements.push_back(variation_unit_ids[vu_index]);
-	}
-	prior = list<string>();
-	uint64_t prior_cardinality = comp.prior.cardinality();
-	for (uint32_t i = 0; i < prior_cardinality; i++) {
-    	comp.prior.select(i, &vu_index);
-		prior.push_back(variation_unit_ids[vu_index]);
-	}
-	posterior = list<string>();
-	uint64_t posterior_cardinality = comp.posterior.cardinality();
-	for (uint32_t i = 0; i < posterior_cardinality; i++) {
-    	comp.posterior.select(i, &vu_index);
-		posterior.push_back(variation_unit_ids[vu_index]);
-	}
-	norel = list<string>();
-	uint64_t norel_cardinality = comp.norel.cardinality();
-	for (uint32_t i = 0; i < norel_cardinality; i++) {
-    	comp.norel.select(i, &vu_index);
-		norel.push_back(variation_unit_ids[vu_index]);
-	}
-	unclear = list<string>();
-	uint64_t unclear_cardinality = comp.unclear.cardinality();
-	for (uint32_t i = 0; i < unclear_cardinality; i++) {
-    	comp.unclear.select(i, &vu_index);
-		unclear.push_back(variation_unit_ids[vu_index]);
-	}
-	explained = list<string>();
-	uint64_t explained_cardinality = comp.explained.cardinality();
-	for (uint32_t i = 0; i < explained_cardinality; i++) {
-    	comp.explained.select(i, &vu_index);
-		explained.push_back(variation_unit_ids[vu_index]);
-	}
+    primary_wit_id = _comp.primary_wit;
+	secondary_wit_id = _comp.secondary_wit;
+	//Then refer to the comparison's bitmaps and the variation unit IDs, to be iterated over when the table is written:
+	comp = &_comp;
+	variation_unit_ids = &_variation_unit_ids;
 }
 
 /**
@@ -86,6 +54,63 @@ enumerate_relationships_table::~enumerate_relationships_table() {
 
 }
 
+/**
+ * Returns a list of the IDs of the variation units in the given bitmap of passages.
+ */
+list<string> enumerate_relationships_table::get_passages(const Roaring & passages) const {
+	list<string> vu_ids = list<string>();
+	for (Roaring::const_iterator it = passages.begin(); it != passages.end(); it++) {
+		vu_ids.push_back((*variation_unit_ids)[*it]);
+	}
+	return vu_ids;
+}
+
+/**
+ * Given an output stream, a bitmap of passages, and a string to indent each line with,
+ * prints the IDs of the variation units in the bitmap to the output stream, one per line.
+ */
+void enumerate_relationships_table::passages_to_text(ostream & out, const Roaring & passages, const string & indent) const {
+	for (Roaring::const_iterator it = passages.begin(); it != passages.end(); it++) {
+		out << indent << (*variation_unit_ids)[*it] << "\n";
+	}
+	return;
+}
+
+/**
+ * Calls the given function with the index and relationship code of each variation unit at which any relationship holds, in increasing order of index.
+ * The codes are computed in one merged pass over the seven bitmaps of the genealogical comparison.
+ */
+void enumerate_relationships_table::for_each_relationship_code(const function<void(uint32_t, unsigned int)> & f) const {
+	const unsigned int n_relationships = 7;
+	const Roaring * bitmaps[n_relationships] = {&comp->extant, &comp->agreements, &comp->prior, &comp->posterior, &comp->norel, &comp->unclear, &comp->explained};
+	const unsigned int bits[n_relationships] = {RELATIONSHIP_EXTANT, RELATIONSHIP_AGREE, RELATIONSHIP_PRIOR, RELATIONSHIP_POSTERIOR, RELATIONSHIP_NOREL, RELATIONSHIP_UNCLEAR, RELATIONSHIP_EXPLAINED};
+	Roaring::const_iterator its[n_relationships] = {bitmaps[0]->begin(), bitmaps[1]->begin(), bitmaps[2]->begin(), bitmaps[3]->begin(), bitmaps[4]->begin(), bitmaps[5]->begin(), bitmaps[6]->begin()};
+	while (true) {
+		//The next variation unit is the smallest index at the head of any bitmap:
+		bool found = false;
+		uint32_t vu_ind = 0;
+		for (unsigned int k = 0; k < n_relationships; k++) {
+			if (its[k] != bitmaps[k]->end() && (!found || *its[k] < vu_ind)) {
+				vu_ind = *its[k];
+				found = true;
+			}
+		}
+		if (!found) {
+			break;
+		}
+		//Set the bit for each bitmap with this index at its head, and advance past it:
+		unsigned int code = 0;
+		for (unsigned int k = 0; k < n_relationships; k++) {
+			if (its[k] != bitmaps[k]->end() && *its[k] == vu_ind) {
+				code |= bits[k];
+				its[k]++;
+			}
+		}
+		f(vu_ind, code);
+	}
+	return;
+}
+
 /**
  * Returns the ID of the primary witness under comparison in this table.
  */
@@ -104,49 +129,49 @@ string enumerate_relationships_table::get_secondary_wit_id() const {
  * Returns this table's list of passages where both witnesses are extant.
  */
 list<string> enumerate_relationships_table::get_extant() const {
-	return extant;
+	return get_passages(comp->extant);
 }
 
 /**
  * Returns this table's list of passages where both witnesses agree.
  */
 list<string> enumerate_relationships_table::get_agreements() const {
-	return agreements;
+	return get_passages(comp->agreements);
 }
 
 /**
  * Returns this table's list of passages where the primary witness is prior.
  */
 list<string> enumerate_relationships_table::get_prior() const {
-	return prior;
+	return get_passages(comp->prior);
 }
 
 /**
  * Returns this table's list of passages where the primary witness is posterior.
  */
 list<string> enumerate_relationships_table::get_posterior() const {
-	return posterior;
+	return get_passages(comp->posterior);
 }
 
 /**
  * Returns this table's list of passages where both witnesses' readings are known to have no directed relationship.
  */
 list<string> enumerate_relationships_table::get_norel() const {
-	return norel;
+	return get_passages(comp->norel);
 }
 
 /**
  * Returns this table's list of passages where the witnesses' readings have an unclear relationship.
 */
 list<string> enumerate_relationships_table::get_unclear() const {
-	return unclear;
+	return get_passages(comp->unclear);
 }
 
 /**
  * Returns this table's list of passages where the primary witness has a reading explained by that of the secondary witness.
 */
 list<string> enumerate_relationships_table::get_explained() const {
-	return explained;
+	return get_passages(comp->explained);
 }
 
 /**
@@ -161,58 +186,37 @@ void enumerate_relationships_table::to_fixed_width(ostream & out, const set<stri
 	if (filter_relationship_types.find("extant") != filter_relationship_types.end()) {
 		out << "EXTANT";
 		out << "\n\n";
-		for (string vu_id : extant) {
-			out << "\t" << vu_id;
-			out << "\n";
-		}
+		passages_to_text(out, comp->extant, "\t");
 	}
 	if (filter_relationship_types.find("agree") != filter_relationship_types.end()) {
 		out << "AGREE";
 		out << "\n\n";
-		for (string vu_id : agreements) {
-			out << "\t" << vu_id;
-			out << "\n";
-		}
+		passages_to_text(out, comp->agreements, "\t");
 	}
 	if (filter_relationship_types.find("prior") != filter_relationship_types.end()) {
 		out << "PRIOR";
 		out << "\n\n";
-		for (string vu_id : prior) {
-			out << "\t" << vu_id;
-			out << "\n";
-		}
+		passages_to_text(out, comp->prior, "\t");
 	}
 	if (filter_relationship_types.find("posterior") != filter_relationship_types.end()) {
 		out << "POSTERIOR";
 		out << "\n\n";
-		for (string vu_id : posterior) {
-			out << "\t" << vu_id;
-			out << "\n";
-		}
+		passages_to_text(out, comp->posterior, "\t");
 	}
 	if (filter_relationship_types.find("norel") != filter_relationship_types.end()) {
 		out << "NOREL";
 		out << "\n\n";
-		for (string vu_id : norel) {
-			out << "\t" << vu_id;
-			out << "\n";
-		}
+		passages_to_text(out, comp->norel, "\t");
 	}
 	if (filter_relationship_types.find("unclear") != filter_relationship_types.end()) {
 		out << "UNCLEAR";
 		out << "\n\n";
-		for (string vu_id : unclear) {
-			out << "\t" << vu_id;
-			out << "\n";
-		}
+		passages_to_text(out, comp->unclear, "\t");
 	}
 	if (filter_relationship_types.find("explained") != filter_relationship_types.end()) {
 		out << "EXPLAINED";
 		out << "\n\n";
-		for (string vu_id : explained) {
-			out << "\t" << vu_id;
-			out << "\n";
-		}
+		passages_to_text(out, comp->explained, "\t");
 	}
 	out << endl;
 	return;
@@ -229,45 +233,31 @@ void enumerate_relationships_table::to_csv(ostream & out, const set<string> & fi
 	//Then print the lists of passages for the filtered relationship types:
 	if (filter_relationship_types.find("extant") != filter_relationship_types.end()) {
 		out << "EXTANT" << "\n";
-		for (string vu_id : extant) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->extant, "");
 	}
 	if (filter_relationship_types.find("agree") != filter_relationship_types.end()) {
 		out << "AGREE" << "\n";
-		for (string vu_id : agreements) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->agreements, "");
 	}
 	if (filter_relationship_types.find("prior") != filter_relationship_types.end()) {
 		out << "PRIOR" << "\n";
-		for (string vu_id : prior) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->prior, "");
 	}
 	if (filter_relationship_types.find("posterior") != filter_relationship_types.end()) {
 		out << "POSTERIOR" << "\n";
-		for (string vu_id : posterior) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->posterior, "");
 	}
 	if (filter_relationship_types.find("norel") != filter_relationship_types.end()) {
 		out << "NOREL" << "\n";
-		for (string vu_id : norel) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->norel, "");
 	}
 	if (filter_relationship_types.find("unclear") != filter_relationship_types.end()) {
 		out << "UNCLEAR" << "\n";
-		for (string vu_id : unclear) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->unclear, "");
 	}
 	if (filter_relationship_types.find("explained") != filter_relationship_types.end()) {
 		out << "EXPLAINED" << "\n";
-		for (string vu_id : explained) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->explained, "");
 	}
 	out << endl;
 	return;
@@ -284,183 +274,156 @@ void enumerate_relationships_table::to_tsv(ostream & out, const set<string> & fi
 	//Then print the lists of passages for the filtered relationship types:
 	if (filter_relationship_types.find("extant") != filter_relationship_types.end()) {
 		out << "EXTANT" << "\n";
-		for (string vu_id : extant) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->extant, "");
 	}
 	if (filter_relationship_types.find("agree") != filter_relationship_types.end()) {
 		out << "AGREE" << "\n";
-		for (string vu_id : agreements) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->agreements, "");
 	}
 	if (filter_relationship_types.find("prior") != filter_relationship_types.end()) {
 		out << "PRIOR" << "\n";
-		for (string vu_id : prior) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->prior, "");
 	}
 	if (filter_relationship_types.find("posterior") != filter_relationship_types.end()) {
 		out << "POSTERIOR" << "\n";
-		for (string vu_id : posterior) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->posterior, "");
 	}
 	if (filter_relationship_types.find("norel") != filter_relationship_types.end()) {
 		out << "NOREL" << "\n";
-		for (string vu_id : norel) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->norel, "");
 	}
 	if (filter_relationship_types.find("unclear") != filter_relationship_types.end()) {
 		out << "UNCLEAR" << "\n";
-		for (string vu_id : unclear) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->unclear, "");
 	}
 	if (filter_relationship_types.find("explained") != filter_relationship_types.end()) {
 		out << "EXPLAINED" << "\n";
-		for (string vu_id : explained) {
-			out << vu_id << "\n";
-		}
+		passages_to_text(out, comp->explained, "");
 	}
 	out << endl;
 	return;
 }
 
 /**
- * Given an output stream and a set of desired relationship types, 
+ * Given a JSON writer and a set of desired relationship types,
+ * writes the contents of this table for those relationship types to it as a JavaScript Object Notation (JSON) object.
+ */
+void enumerate_relationships_table::to_json(json_writer & writer, const set<string> & filter_relationship_types) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("primary_wit");
+	writer.value(primary_wit_id);
+	writer.key("secondary_wit");
+	writer.value(secondary_wit_id);
+	//Then add the lists of passages for the filtered relationship types:
+	auto add_passages = [&](const string & relationship_type, const Roaring & passages) {
+		if (filter_relationship_types.find(relationship_type) == filter_relationship_types.end()) {
+			return;
+		}
+		writer.key(relationship_type);
+		writer.begin_array();
+		for (Roaring::const_iterator it = passages.begin(); it != passages.end(); it++) {
+			writer.value((*variation_unit_ids)[*it]);
+		}
+		writer.end_array();
+	};
+	add_passages("extant", comp->extant);
+	add_passages("agree", comp->agreements);
+	add_passages("prior", comp->prior);
+	add_passages("posterior", comp->posterior);
+	add_passages("norel", comp->norel);
+	add_passages("unclear", comp->unclear);
+	add_passages("explained", comp->explained);
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
+/**
+ * Given an output stream and a set of desired relationship types,
  * prints the contents of this table for those relationship types in JavaScript Object Notation (JSON) format.
- * The witness IDs are assumed not to contain characters that need to be escaped in URLs.
  */
 void enumerate_relationships_table::to_json(ostream & out, const set<string> & filter_relationship_types) {
-    //Open the root object:
-    out << "{";
-    //Add the metadata fields:
-	out << "\"primary_wit\":" << "\"" << primary_wit_id << "\"" << ",";
-	out << "\"secondary_wit\":" << "\"" << secondary_wit_id << "\"" << ",";
-    //Then print the lists of passages for the filtered relationship types:
-	unsigned int relationship_types_processed = 0;
-	if (filter_relationship_types.find("extant") != filter_relationship_types.end()) {
-		out << "\"extant\":" << "[";
-		for (string vu_id : extant) {
-			out << "\"" << vu_id << "\"";
-			//If this is not the last ID in the list, then add a comma:
-			if (vu_id != extant.back()) {
-				out << ",";
-			}
-		}
-    	out << "]";
-		//Increment the number of relationship types processed so far:
-		relationship_types_processed++;
-		//If this is less than the number of desired relationship types, then add a comma:
-		if (relationship_types_processed < filter_relationship_types.size()) {
-			out << ",";
-		}
-	}
-	if (filter_relationship_types.find("agree") != filter_relationship_types.end()) {
-		out << "\"agree\":" << "[";
-		for (string vu_id : agreements) {
-			out << "\"" << vu_id << "\"";
-			//If this is not the last ID in the list, then add a comma:
-			if (vu_id != agreements.back()) {
-				out << ",";
-			}
-		}
-		out << "]";
-		//Increment the number of relationship types processed so far:
-		relationship_types_processed++;
-		//If this is less than the number of desired relationship types, then add a comma:
-		if (relationship_types_processed < filter_relationship_types.size()) {
-			out << ",";
-		}
-	}
-	if (filter_relationship_types.find("prior") != filter_relationship_types.end()) {
-		out << "\"prior\":" << "[";
-		for (string vu_id : prior) {
-			out << "\"" << vu_id << "\"";
-			//If this is not the last ID in the list, then add a comma:
-			if (vu_id != prior.back()) {
-				out << ",";
-			}
-		}
-		out << "]";
-		//Increment the number of relationship types processed so far:
-		relationship_types_processed++;
-		//If this is less than the number of desired relationship types, then add a comma:
-		if (relationship_types_processed < filter_relationship_types.size()) {
-			out << ",";
-		}
-	}
-	if (filter_relationship_types.find("posterior") != filter_relationship_types.end()) {
-		out << "\"posterior\":" << "[";
-		for (string vu_id : posterior) {
-			out << "\"" << vu_id << "\"";
-			//If this is not the last ID in the list, then add a comma:
-			if (vu_id != posterior.back()) {
-				out << ",";
-			}
-		}
-		out << "]";
-		//Increment the number of relationship types processed so far:
-		relationship_types_processed++;
-		//If this is less than the number of desired relationship types, then add a comma:
-		if (relationship_types_processed < filter_relationship_types.size()) {
-			out << ",";
-		}
-	}
-	if (filter_relationship_types.find("norel") != filter_relationship_types.end()) {
-		out << "\"norel\":" << "[";
-		for (string vu_id : norel) {
-			out << "\"" << vu_id << "\"";
-			//If this is not the last ID in the list, then add a comma:
-			if (vu_id != norel.back()) {
-				out << ",";
-			}
-		}
-		out << "]";
-		//Increment the number of relationship types processed so far:
-		relationship_types_processed++;
-		//If this is less than the number of desired relationship types, then add a comma:
-		if (relationship_types_processed < filter_relationship_types.size()) {
-			out << ",";
-		}
-	}
-	if (filter_relationship_types.find("unclear") != filter_relationship_types.end()) {
-		out << "\"unclear\":" << "[";
-		for (string vu_id : unclear) {
-			out << "\"" << vu_id << "\"";
-			//If this is not the last ID in the list, then add a comma:
-			if (vu_id != unclear.back()) {
-				out << ",";
-			}
-		}
-		out << "]";
-		//Increment the number of relationship types processed so far:
-		relationship_types_processed++;
-		//If this is less than the number of desired relationship types, then add a comma:
-		if (relationship_types_processed < filter_relationship_types.size()) {
-			out << ",";
-		}
-	}
-	if (filter_relationship_types.find("explained") != filter_relationship_types.end()) {
-		out << "\"explained\":" << "[";
-		for (string vu_id : explained) {
-			out << "\"" << vu_id << "\"";
-			//If this is not the last ID in the list, then add a comma:
-			if (vu_id != explained.back()) {
-				out << ",";
-			}
-		}
-		out << "]";
-		//Increment the number of relationship types processed so far:
-		relationship_types_processed++;
-		//If this is less than the number of desired relationship types, then add a comma:
-		if (relationship_types_processed < filter_relationship_types.size()) {
-			out << ",";
-		}
-	}
-    //Close the root object:
-    out << "}";
+	json_writer writer(out);
+	to_json(writer, filter_relationship_types);
+	return;
+}
+
+/**
+ * Given an output stream, prints the relationship code of each variation unit at which any relationship holds between the witnesses
+ * in comma-separated value (CSV) format, with one row per variation unit.
+ * Each code is the sum of the relationship_code bits for the relationships that hold at that variation unit.
+ * The variation unit IDs are assumed not to contain commas; if they do, then they will need to be manually escaped in the output.
+ */
+void enumerate_relationships_table::codes_to_csv(ostream & out) {
+	//Print the caption:
+	out << "Genealogical relationships between " << primary_wit_id << " and " << secondary_wit_id << "\n";
+	//Print the header row:
+	out << "VU" << "," << "CODE" << "\n";
+	//Then print one row per variation unit:
+	for_each_relationship_code([&](uint32_t vu_ind, unsigned int code) {
+		out << (*variation_unit_ids)[vu_ind] << "," << code << "\n";
+	});
+	out << endl;
+	return;
+}
+
+/**
+ * Given an output stream, prints the relationship code of each variation unit at which any relationship holds between the witnesses
+ * in tab-separated value (TSV) format, with one row per variation unit.
+ * Each code is the sum of the relationship_code bits for the relationships that hold at that variation unit.
+ * The variation unit IDs are assumed not to contain tabs; if they do, then they will need to be manually escaped in the output.
+ */
+void enumerate_relationships_table::codes_to_tsv(ostream & out) {
+	//Print the caption:
+	out << "Genealogical relationships between " << primary_wit_id << " and " << secondary_wit_id << "\n";
+	//Print the header row:
+	out << "VU" << "\t" << "CODE" << "\n";
+	//Then print one row per variation unit:
+	for_each_relationship_code([&](uint32_t vu_ind, unsigned int code) {
+		out << (*variation_unit_ids)[vu_ind] << "\t" << code << "\n";
+	});
+	out << endl;
 	return;
-}
\ No newline at end of file
+}
+
+/**
+ * Given a JSON writer, writes the relationship code of each variation unit at which any relationship holds between the witnesses
+ * to it as a JavaScript Object Notation (JSON) object, with one row object per variation unit.
+ * Each code is the sum of the relationship_code bits for the relationships that hold at that variation unit.
+ */
+void enumerate_relationships_table::codes_to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("primary_wit");
+	writer.value(primary_wit_id);
+	writer.key("secondary_wit");
+	writer.value(secondary_wit_id);
+	//Add the rows array, with each variation unit as an object:
+	writer.key("rows");
+	writer.begin_array();
+	for_each_relationship_code([&](uint32_t vu_ind, unsigned int code) {
+		writer.begin_object();
+		writer.key("id");
+		writer.value((*variation_unit_ids)[vu_ind]);
+		writer.key("code");
+		writer.value(code);
+		writer.end_object();
+	});
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
+/**
+ * Given an output stream, prints the relationship code of each variation unit at which any relationship holds between the witnesses
+ * in JavaScript Object Notation (JSON) format.
+ */
+void enumerate_relationships_table::codes_to_json(ostream & out) {
+	json_writer writer(out);
+	codes_to_json(writer);
+	return;
+}
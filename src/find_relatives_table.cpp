@@ -16,6 +16,7 @@
 #include "variation_unit.h"
 #include "witness.h"
 #include "find_relatives_table.h"
+#include "json_writer.h"
 
 using namespace std;
 
@@ -30,7 +31,7 @@ find_relatives_table::find_relatives_table() {
  * Constructs a find relatives table relative to a given witness at a given variation unit,
  * given a list of witness IDs in input order and a set of readings by which to filter the rows.
  */
- find_relatives_table::find_relatives_table(const witness & wit, const variation_unit & vu, const list<string> list_wit, const set<string> & filter_rdgs) {
+ find_relatives_table::find_relatives_table(const witness & wit, const variation_unit & vu, const list<string> & list_wit, const set<string> & filter_rdgs) {
     rows = list<find_relatives_table_row>();
     id = wit.get_id();
     label = vu.get_label();
@@ -95,6 +96,19 @@ find_relatives_table::find_relatives_table() {
 	}
 }
 
+/**
+ * Constructs a find relatives table from the ID of its primary witness, the label and connectivity limit of its variation unit,
+ * the number of passages where the primary witness is extant, the primary witness's reading, and a list of rows that have already been ranked, sorted, and filtered.
+ */
+find_relatives_table::find_relatives_table(const string & _id, const string & _label, int _connectivity, int _primary_extant, const string & _primary_rdg, const list<find_relatives_table_row> & _rows) {
+	id = _id;
+	label = _label;
+	connectivity = _connectivity;
+	primary_extant = _primary_extant;
+	primary_rdg = _primary_rdg;
+	rows = _rows;
+}
+
 /**
  * Default destructor.
  */
@@ -282,56 +296,67 @@ void find_relatives_table::to_tsv(ostream & out) {
 	return;
 }
 
+/**
+ * Given a JSON writer, writes this find relatives table to it as a JavaScript Object Notation (JSON) object.
+ */
+void find_relatives_table::to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("primary_wit");
+	writer.value(id);
+	writer.key("primary_extant");
+	writer.value(primary_extant);
+	writer.key("label");
+	writer.value(label);
+	writer.key("connectivity");
+	writer.value(connectivity);
+	writer.key("primary_rdg");
+	writer.value(primary_rdg);
+	//Add the rows array, with each row as an object:
+	writer.key("rows");
+	writer.begin_array();
+	for (const find_relatives_table_row & row : rows) {
+		writer.begin_object();
+		writer.key("id");
+		writer.value(row.id);
+		writer.key("dir");
+		writer.value(row.dir);
+		writer.key("nr");
+		writer.value(row.nr > 0 ? to_string(row.nr) : "");
+		writer.key("rdg");
+		writer.value(row.rdg);
+		writer.key("pass");
+		writer.value(row.pass);
+		writer.key("eq");
+		writer.value(row.eq);
+		writer.key("perc");
+		writer.value(row.perc);
+		writer.key("prior");
+		writer.value(row.prior);
+		writer.key("posterior");
+		writer.value(row.posterior);
+		writer.key("norel");
+		writer.value(row.norel);
+		writer.key("uncl");
+		writer.value(row.uncl);
+		writer.key("expl");
+		writer.value(row.expl);
+		writer.key("cost");
+		writer.value(row.cost >= 0 ? json_writer::format_number(row.cost) : "");
+		writer.end_object();
+	}
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
 /**
  * Given an output stream, prints this find relatives table in JavaScript Object Notation (JSON) format.
- * The witness IDs are assumed not to contain characters that need to be escaped in URLs.
  */
 void find_relatives_table::to_json(ostream & out) {
-    //Open the root object:
-    out << "{";
-    //Add the metadata fields:
-	out << "\"primary_wit\":" << "\"" << id << "\"" << ",";
-    out << "\"primary_extant\":" << primary_extant << ",";
-    out << "\"label\":" << "\"" << label << "\"" << ",";
-    out << "\"connectivity\":" << connectivity << ",";
-    out << "\"primary_rdg\":" << "\"" << primary_rdg << "\"" << ",";
-    //Open the rows array:
-    out << "\"rows\":" << "[";
-    //Print each row as an object:
-	unsigned int row_num = 0;
-	for (find_relatives_table_row row : rows) {
-        //Open the row object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"id\":" << "\"" << row.id << "\"" << ",";
-		out << "\"dir\":" << row.dir << ",";
-		out << "\"nr\":" << "\"" << (row.nr > 0 ? to_string(row.nr) : "") << "\"" << ",";
-		out << "\"rdg\":" << "\"" << row.rdg << "\"" << ",";
-		out << "\"pass\":" << row.pass << ",";
-		out << "\"eq\":" << row.eq << ",";
-        out << "\"perc\":" << row.perc << ",";
-		out << "\"prior\":" << row.prior << ",";
-		out << "\"posterior\":" << row.posterior << ",";
-		out << "\"norel\":" << row.norel << ",";
-        out << "\"uncl\":" << row.uncl << ",";
-        out << "\"expl\":" << row.expl << ",";
-		if (row.cost >= 0) {
-			out << "\"cost\":" << "\"" << row.cost << "\"";
-		}
-		else {
-			out << "\"cost\":" << "\"" << "" << "\"";
-		}
-        //Close the row object:
-        out << "}";
-        //Add a comma if this is not the last row:
-        if (row_num < rows.size() - 1) {
-            out << ",";
-        }
-		row_num++;
-	}
-    //Close the rows array:
-    out << "]";
-    //Close the root object:
-    out << "}";
+	json_writer writer(out);
+	to_json(writer);
 	return;
 }
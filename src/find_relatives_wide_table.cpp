@@ -0,0 +1,428 @@
+/*
+ * find_relatives_wide_table.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <list>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+
+#include "variation_unit.h"
+#include "witness.h"
+#include "compare_witnesses_table.h"
+#include "find_relatives_table.h"
+#include "find_relatives_wide_table.h"
+#include "json_writer.h"
+
+using namespace std;
+
+ /**
+ * Default constructor.
+ */
+find_relatives_wide_table::find_relatives_wide_table() {
+
+}
+
+/**
+ * Constructs a wide find relatives table relative to a given witness at a given vector of variation units,
+ * given a list of witness IDs in input order and a set of witness IDs by which to filter the rows.
+ * The witnesses are compared to and ranked against the primary witness once, as in the compare witnesses table,
+ * and then only their readings are looked up at each variation unit.
+ */
+find_relatives_wide_table::find_relatives_wide_table(const witness & wit, const vector<variation_unit> & vus, const list<string> & list_wit, const set<string> & filter_wits) {
+	//Rank the secondary witnesses once for all variation units:
+	compare_witnesses_table cwt = compare_witnesses_table(wit, list_wit, filter_wits);
+	id = cwt.get_id();
+	primary_extant = cwt.get_primary_extant();
+	rows = list<find_relatives_wide_table_row>();
+	for (const compare_witnesses_table_row & comparison : cwt.get_rows()) {
+		find_relatives_wide_table_row row;
+		row.comparison = comparison;
+		row.rdgs = vector<string>();
+		row.rdgs.reserve(vus.size());
+		rows.push_back(row);
+	}
+	//Then add the readings of the primary witness and each secondary witness at each variation unit:
+	labels = vector<string>();
+	connectivities = vector<int>();
+	primary_rdgs = vector<string>();
+	for (const variation_unit & vu : vus) {
+		labels.push_back(vu.get_label());
+		connectivities.push_back(vu.get_connectivity());
+		unordered_map<string, string> reading_support = vu.get_reading_support();
+		primary_rdgs.push_back(reading_support.find(id) != reading_support.end() ? reading_support.at(id) : "-");
+		for (find_relatives_wide_table_row & row : rows) {
+			row.rdgs.push_back(reading_support.find(row.comparison.id) != reading_support.end() ? reading_support.at(row.comparison.id) : "-");
+		}
+	}
+}
+
+/**
+ * Default destructor.
+ */
+find_relatives_wide_table::~find_relatives_wide_table() {
+
+}
+
+/**
+ * Returns the ID of the primary witness for which this table provides comparisons.
+ */
+string find_relatives_wide_table::get_id() const {
+	return id;
+}
+
+/**
+ * Returns the number of passages at which this table's primary witness is extant.
+ */
+int find_relatives_wide_table::get_primary_extant() const {
+	return primary_extant;
+}
+
+/**
+ * Returns the labels of the variation units at which this table provides readings.
+ */
+vector<string> find_relatives_wide_table::get_labels() const {
+	return labels;
+}
+
+/**
+ * Returns the connectivity limits of the variation units at which this table provides readings.
+ */
+vector<int> find_relatives_wide_table::get_connectivities() const {
+	return connectivities;
+}
+
+/**
+ * Returns the readings of the primary witness at the variation units under consideration.
+ */
+vector<string> find_relatives_wide_table::get_primary_rdgs() const {
+	return primary_rdgs;
+}
+
+/**
+ * Returns this table's list of rows.
+ */
+list<find_relatives_wide_table_row> find_relatives_wide_table::get_rows() const {
+	return rows;
+}
+
+/**
+ * Returns the find relatives table for the variation unit with the given index in this table,
+ * with its rows filtered by the given set of readings (if it is not empty).
+ */
+find_relatives_table find_relatives_wide_table::get_table(unsigned int vu_ind, const set<string> & filter_rdgs) const {
+	list<find_relatives_table_row> table_rows = list<find_relatives_table_row>();
+	for (const find_relatives_wide_table_row & row : rows) {
+		const string & rdg = row.rdgs[vu_ind];
+		if (!filter_rdgs.empty() && filter_rdgs.find(rdg) == filter_rdgs.end()) {
+			continue;
+		}
+		find_relatives_table_row table_row;
+		table_row.id = row.comparison.id;
+		table_row.dir = row.comparison.dir;
+		table_row.nr = row.comparison.nr;
+		table_row.rdg = rdg;
+		table_row.pass = row.comparison.pass;
+		table_row.perc = row.comparison.perc;
+		table_row.eq = row.comparison.eq;
+		table_row.prior = row.comparison.prior;
+		table_row.posterior = row.comparison.posterior;
+		table_row.norel = row.comparison.norel;
+		table_row.uncl = row.comparison.uncl;
+		table_row.expl = row.comparison.expl;
+		table_row.cost = row.comparison.cost;
+		table_rows.push_back(table_row);
+	}
+	return find_relatives_table(id, labels[vu_ind], connectivities[vu_ind], primary_extant, primary_rdgs[vu_ind], table_rows);
+}
+
+/**
+ * Given an output stream, prints this wide find relatives table in fixed-width format,
+ * with one reading column for each variation unit after the comparison columns.
+ */
+void find_relatives_wide_table::to_fixed_width(ostream & out) {
+	//Size each reading column to fit its label and readings:
+	vector<unsigned int> rdg_widths = vector<unsigned int>();
+	for (unsigned int vu_ind = 0; vu_ind < labels.size(); vu_ind++) {
+		unsigned int rdg_width = (unsigned int) max(labels[vu_ind].size(), primary_rdgs[vu_ind].size());
+		for (const find_relatives_wide_table_row & row : rows) {
+			rdg_width = max(rdg_width, (unsigned int) row.rdgs[vu_ind].size());
+		}
+		rdg_widths.push_back(rdg_width + 2 > 8 ? rdg_width + 2 : 8);
+	}
+	//Print the caption:
+	out << "Genealogical comparisons for W1 = " << id << " (" << primary_extant << " extant passages):";
+	out << "\n\n";
+	//Print the header row:
+	out << std::left << std::setw(8) << "W2";
+	out << std::left << std::setw(4) << "DIR";
+	out << std::right << std::setw(4) << "NR";
+	out << std::right << std::setw(8) << "PASS";
+	out << std::right << std::setw(8) << "EQ";
+	out << std::right << std::setw(12) << ""; //percentage of agreements among mutually extant passages
+	out << std::right << std::setw(8) << "W1>W2";
+	out << std::right << std::setw(8) << "W1<W2";
+	out << std::right << std::setw(8) << "NOREL";
+	out << std::right << std::setw(8) << "UNCL";
+	out << std::right << std::setw(8) << "EXPL";
+	out << std::right << std::setw(12) << "COST";
+	out << std::setw(4) << ""; //buffer space between right-aligned and left-aligned columns
+	for (unsigned int vu_ind = 0; vu_ind < labels.size(); vu_ind++) {
+		out << std::left << std::setw(rdg_widths[vu_ind]) << labels[vu_ind];
+	}
+	out << "\n\n";
+	//Print a row for the readings of the primary witness:
+	out << std::left << std::setw(8) << id;
+	out << std::setw(88) << ""; //no comparison of the primary witness to itself
+	out << std::setw(4) << ""; //buffer space between right-aligned and left-aligned columns
+	for (unsigned int vu_ind = 0; vu_ind < labels.size(); vu_ind++) {
+		out << std::left << std::setw(rdg_widths[vu_ind]) << primary_rdgs[vu_ind];
+	}
+	out << "\n";
+	//Print the subsequent rows:
+	for (const find_relatives_wide_table_row & row : rows) {
+		const compare_witnesses_table_row & comparison = row.comparison;
+		out << std::left << std::setw(8) << comparison.id;
+		out << std::left << std::setw(4) << (comparison.dir == -1 ? "<" : (comparison.dir == 1 ? ">" : "="));
+		out << std::right << std::setw(4) << (comparison.nr > 0 ? to_string(comparison.nr) : "");
+		out << std::right << std::setw(8) << comparison.pass;
+		out << std::right << std::setw(8) << comparison.eq;
+		out << std::right << std::setw(3) << "(" << std::setw(7) << fixed << std::setprecision(3) << comparison.perc << std::setw(2) << "%)";
+		out << std::right << std::setw(8) << comparison.prior;
+		out << std::right << std::setw(8) << comparison.posterior;
+		out << std::right << std::setw(8) << comparison.norel;
+		out << std::right << std::setw(8) << comparison.uncl;
+		out << std::right << std::setw(8) << comparison.expl;
+		if (comparison.cost >= 0) {
+			out << std::right << std::setw(12) << fixed << std::setprecision(3) << comparison.cost;
+		}
+		else {
+			out << std::right << std::setw(12) << "";
+		}
+		out << std::setw(4) << ""; //buffer space between right-aligned and left-aligned columns
+		for (unsigned int vu_ind = 0; vu_ind < labels.size(); vu_ind++) {
+			out << std::left << std::setw(rdg_widths[vu_ind]) << row.rdgs[vu_ind];
+		}
+		out << "\n";
+	}
+	out << endl;
+	return;
+}
+
+/**
+ * Given an output stream, prints this wide find relatives table in comma-separated value (CSV) format,
+ * with one reading column for each variation unit after the comparison columns.
+ * The witness IDs, variation unit labels, and readings are assumed not to contain commas; if they do, then they will need to be manually escaped in the output.
+ */
+void find_relatives_wide_table::to_csv(ostream & out) {
+	//Print the header row:
+	out << "W2" << ",";
+	out << "DIR" << ",";
+	out << "NR" << ",";
+	out << "PASS" << ",";
+	out << "EQ" << ",";
+	out << "" << ","; //percentage of agreements among mutually extant passages
+	out << "W1>W2" << ",";
+	out << "W1<W2" << ",";
+	out << "NOREL" << ",";
+	out << "UNCL" << ",";
+	out << "EXPL" << ",";
+	out << "COST";
+	for (const string & label : labels) {
+		out << "," << label;
+	}
+	out << "\n";
+	//Print a row for the readings of the primary witness:
+	out << id << ",,,,,,,,,,,";
+	for (const string & primary_rdg : primary_rdgs) {
+		out << "," << primary_rdg;
+	}
+	out << "\n";
+	//Print the subsequent rows:
+	for (const find_relatives_wide_table_row & row : rows) {
+		const compare_witnesses_table_row & comparison = row.comparison;
+		out << comparison.id << ",";
+		out << (comparison.dir == -1 ? "<" : (comparison.dir == 1 ? ">" : "=")) << ",";
+		out << (comparison.nr > 0 ? to_string(comparison.nr) : "") << ",";
+		out << comparison.pass << ",";
+		out << comparison.eq << ",";
+		out << "(" << comparison.perc << "%)" << ",";
+		out << comparison.prior << ",";
+		out << comparison.posterior << ",";
+		out << comparison.norel << ",";
+		out << comparison.uncl << ",";
+		out << comparison.expl << ",";
+		if (comparison.cost >= 0) {
+			out << comparison.cost;
+		}
+		for (const string & rdg : row.rdgs) {
+			out << "," << rdg;
+		}
+		out << "\n";
+	}
+	out << endl;
+	return;
+}
+
+/**
+ * Given an output stream, prints this wide find relatives table in tab-separated value (TSV) format,
+ * with one reading column for each variation unit after the comparison columns.
+ * The witness IDs, variation unit labels, and readings are assumed not to contain tabs; if they do, then they will need to be manually escaped in the output.
+ */
+void find_relatives_wide_table::to_tsv(ostream & out) {
+	//Print the header row:
+	out << "W2" << "\t";
+	out << "DIR" << "\t";
+	out << "NR" << "\t";
+	out << "PASS" << "\t";
+	out << "EQ" << "\t";
+	out << "" << "\t"; //percentage of agreements among mutually extant passages
+	out << "W1>W2" << "\t";
+	out << "W1<W2" << "\t";
+	out << "NOREL" << "\t";
+	out << "UNCL" << "\t";
+	out << "EXPL" << "\t";
+	out << "COST";
+	for (const string & label : labels) {
+		out << "\t" << label;
+	}
+	out << "\n";
+	//Print a row for the readings of the primary witness:
+	out << id << "\t\t\t\t\t\t\t\t\t\t\t";
+	for (const string & primary_rdg : primary_rdgs) {
+		out << "\t" << primary_rdg;
+	}
+	out << "\n";
+	//Print the subsequent rows:
+	for (const find_relatives_wide_table_row & row : rows) {
+		const compare_witnesses_table_row & comparison = row.comparison;
+		out << comparison.id << "\t";
+		out << (comparison.dir == -1 ? "<" : (comparison.dir == 1 ? ">" : "=")) << "\t";
+		out << (comparison.nr > 0 ? to_string(comparison.nr) : "") << "\t";
+		out << comparison.pass << "\t";
+		out << comparison.eq << "\t";
+		out << "(" << comparison.perc << "%)" << "\t";
+		out << comparison.prior << "\t";
+		out << comparison.posterior << "\t";
+		out << comparison.norel << "\t";
+		out << comparison.uncl << "\t";
+		out << comparison.expl << "\t";
+		if (comparison.cost >= 0) {
+			out << comparison.cost;
+		}
+		for (const string & rdg : row.rdgs) {
+			out << "\t" << rdg;
+		}
+		out << "\n";
+	}
+	out << endl;
+	return;
+}
+
+/**
+ * Given a JSON writer, writes this wide find relatives table to it as a JavaScript Object Notation (JSON) object.
+ */
+void find_relatives_wide_table::to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("primary_wit");
+	writer.value(id);
+	writer.key("primary_extant");
+	writer.value(primary_extant);
+	//Add the variation units array, with each variation unit as an object:
+	writer.key("units");
+	writer.begin_array();
+	for (unsigned int vu_ind = 0; vu_ind < labels.size(); vu_ind++) {
+		writer.begin_object();
+		writer.key("label");
+		writer.value(labels[vu_ind]);
+		writer.key("connectivity");
+		writer.value(connectivities[vu_ind]);
+		writer.key("primary_rdg");
+		writer.value(primary_rdgs[vu_ind]);
+		writer.end_object();
+	}
+	writer.end_array();
+	//Add the rows array, with each row as an object:
+	writer.key("rows");
+	writer.begin_array();
+	for (const find_relatives_wide_table_row & row : rows) {
+		const compare_witnesses_table_row & comparison = row.comparison;
+		writer.begin_object();
+		writer.key("id");
+		writer.value(comparison.id);
+		writer.key("dir");
+		writer.value(comparison.dir);
+		writer.key("nr");
+		writer.value(comparison.nr > 0 ? to_string(comparison.nr) : "");
+		writer.key("pass");
+		writer.value(comparison.pass);
+		writer.key("eq");
+		writer.value(comparison.eq);
+		writer.key("perc");
+		writer.value(comparison.perc);
+		writer.key("prior");
+		writer.value(comparison.prior);
+		writer.key("posterior");
+		writer.value(comparison.posterior);
+		writer.key("norel");
+		writer.value(comparison.norel);
+		writer.key("uncl");
+		writer.value(comparison.uncl);
+		writer.key("expl");
+		writer.value(comparison.expl);
+		writer.key("cost");
+		writer.value(comparison.cost >= 0 ? json_writer::format_number(comparison.cost) : "");
+		writer.key("rdgs");
+		writer.begin_array();
+		for (const string & rdg : row.rdgs) {
+			writer.value(rdg);
+		}
+		writer.end_array();
+		writer.end_object();
+	}
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
+/**
+ * Given an output stream, prints this wide find relatives table in JavaScript Object Notation (JSON) format.
+ */
+void find_relatives_wide_table::to_json(ostream & out) {
+	json_writer writer(out);
+	to_json(writer);
+	return;
+}
+
+/**
+ * Given a JSON writer and a set of readings by which to filter the rows,
+ * writes the find relatives tables for all of this table's variation units to it as a JavaScript Object Notation (JSON) array, in order.
+ */
+void find_relatives_wide_table::tables_to_json(json_writer & writer, const set<string> & filter_rdgs) {
+	writer.begin_array();
+	for (unsigned int vu_ind = 0; vu_ind < labels.size(); vu_ind++) {
+		get_table(vu_ind, filter_rdgs).to_json(writer);
+	}
+	writer.end_array();
+	return;
+}
+
+/**
+ * Given an output stream and a set of readings by which to filter the rows,
+ * prints the find relatives tables for all of this table's variation units as a JavaScript Object Notation (JSON) array, in order.
+ */
+void find_relatives_wide_table::tables_to_json(ostream & out, const set<string> & filter_rdgs) {
+	json_writer writer(out);
+	tables_to_json(writer, filter_rdgs);
+	return;
+}
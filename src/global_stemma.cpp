@@ -6,16 +6,23 @@
  */
 
 #include <iostream>
-#include <sstream>
-#include <iomanip>
 #include <string>
 #include <list>
+#include <set>
+#include <map>
+#include <vector>
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 
 #include <roaring/roaring.hh>
 #include "global_stemma.h"
+#include "apparatus.h"
 #include "witness.h"
+#include "set_cover_solver.h"
+#include "parallel_for.h"
+#include "json_writer.h"
+#include "dot_writer.h"
 
 using namespace std;
 
@@ -41,30 +48,20 @@ global_stemma::global_stemma(const list<witness> & witnesses) {
 		vertices.push_back(v);
 	}
 	//Retrieve each witness's stemmatic ancestors and add the appropriate edges:
-	for (witness wit : witnesses) {
-		string wit_id = wit.get_id();
-		//If the witness has no stemmatic ancestors (which happens for the Ausgangstext and highly lacunose witnesses),
-		//then no edges need to be drawn to it:
-		list<string> stemmatic_ancestor_ids = wit.get_stemmatic_ancestor_ids();
-		if (stemmatic_ancestor_ids.empty()) {
-			continue;
-		}
-		//Otherwise, add an edge for each ancestor:
-		for (string ancestor_id : stemmatic_ancestor_ids) {
-			//Calculate the genealogical cost and stability of the textual flow:
-			genealogical_comparison comp = wit.get_genealogical_comparison_for_witness(ancestor_id);
-			float length = comp.cost;
-			float strength = float(comp.posterior.cardinality() - comp.prior.cardinality()) / float(comp.extant.cardinality());
-			global_stemma_edge e;
-			e.ancestor = ancestor_id;
-			e.descendant = wit_id;
-			e.length = length;
-			e.strength = strength;
-			edges.push_back(e);
-		}
+	for (const witness & wit : witnesses) {
+		list<global_stemma_edge> wit_edges = get_edges_to_witness(wit);
+		edges.splice(edges.end(), wit_edges);
 	}
 }
 
+/**
+ * Constructs a global stemma from its lists of vertices and edges.
+ */
+global_stemma::global_stemma(const list<global_stemma_vertex> & _vertices, const list<global_stemma_edge> & _edges) {
+	vertices = list<global_stemma_vertex>(_vertices);
+	edges = list<global_stemma_edge>(_edges);
+}
+
 /**
  * Default destructor.
  */
@@ -72,6 +69,34 @@ global_stemma::~global_stemma() {
 
 }
 
+/**
+ * Returns a list of the edges from the given witness's stemmatic ancestors to it.
+ */
+list<global_stemma_edge> global_stemma::get_edges_to_witness(const witness & wit) {
+	list<global_stemma_edge> wit_edges = list<global_stemma_edge>();
+	string wit_id = wit.get_id();
+	//If the witness has no stemmatic ancestors (which happens for the Ausgangstext and highly lacunose witnesses),
+	//then no edges need to be drawn to it:
+	list<string> stemmatic_ancestor_ids = wit.get_stemmatic_ancestor_ids();
+	if (stemmatic_ancestor_ids.empty()) {
+		return wit_edges;
+	}
+	//Otherwise, add an edge for each ancestor:
+	for (string ancestor_id : stemmatic_ancestor_ids) {
+		//Calculate the genealogical cost and stability of the textual flow:
+		genealogical_comparison comp = wit.get_genealogical_comparison_for_witness(ancestor_id);
+		float length = comp.cost;
+		float strength = float(comp.posterior.cardinality() - comp.prior.cardinality()) / float(comp.extant.cardinality());
+		global_stemma_edge e;
+		e.ancestor = ancestor_id;
+		e.descendant = wit_id;
+		e.length = length;
+		e.strength = strength;
+		wit_edges.push_back(e);
+	}
+	return wit_edges;
+}
+
 /**
  * Returns this global stemma's list of vertices.
  */
@@ -87,84 +112,437 @@ list<global_stemma_edge> global_stemma::get_edges() const {
 }
 
 /**
- * Given an output stream, writes the global stemma graph to output in .dot format.
+ * Returns the edges of this global stemma in compressed sparse row (CSR) form, indexed by the positions of the vertices in the vertex list.
+ * The edges from each vertex are kept in the order in which they appear in the edge list.
+ */
+global_stemma_adjacency global_stemma::get_adjacency() const {
+	global_stemma_adjacency adjacency;
+	//Map each vertex ID to its index:
+	unordered_map<string, unsigned int> id_to_index = unordered_map<string, unsigned int>();
+	unsigned int vertex_ind = 0;
+	for (const global_stemma_vertex & v : vertices) {
+		id_to_index[v.id] = vertex_ind;
+		vertex_ind++;
+	}
+	//Then count the edges from each vertex, and convert the counts to offsets:
+	vector<unsigned int> ancestor_inds = vector<unsigned int>();
+	vector<unsigned int> descendant_inds = vector<unsigned int>();
+	ancestor_inds.reserve(edges.size());
+	descendant_inds.reserve(edges.size());
+	adjacency.offsets = vector<unsigned int>(vertices.size() + 1, 0);
+	for (const global_stemma_edge & e : edges) {
+		unsigned int ancestor_ind = id_to_index.at(e.ancestor);
+		ancestor_inds.push_back(ancestor_ind);
+		descendant_inds.push_back(id_to_index.at(e.descendant));
+		adjacency.offsets[ancestor_ind + 1]++;
+	}
+	for (unsigned int i = 0; i < vertices.size(); i++) {
+		adjacency.offsets[i + 1] += adjacency.offsets[i];
+	}
+	//Then place each edge in its ancestor's range:
+	adjacency.descendants = vector<unsigned int>(edges.size());
+	adjacency.edge_inds = vector<unsigned int>(edges.size());
+	vector<unsigned int> next = vector<unsigned int>(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+	for (unsigned int edge_ind = 0; edge_ind < edges.size(); edge_ind++) {
+		unsigned int pos = next[ancestor_inds[edge_ind]]++;
+		adjacency.descendants[pos] = descendant_inds[edge_ind];
+		adjacency.edge_inds[pos] = edge_ind;
+	}
+	return adjacency;
+}
+
+/**
+ * Given the adjacency of this global stemma, populates the given vector with the index of the strongly connected component of each vertex,
+ * using an iterative version of Tarjan's algorithm, which runs in linear time.
+ * The components are numbered in reverse topological order, so every edge between different components goes from a higher-numbered component to a lower-numbered one.
+ * Returns the number of components.
+ */
+unsigned int global_stemma::get_components(const global_stemma_adjacency & adjacency, vector<unsigned int> & components) const {
+	unsigned int n = (unsigned int) adjacency.offsets.size() - 1;
+	components = vector<unsigned int>(n);
+	vector<int> discovery = vector<int>(n, -1);
+	vector<int> lowlink = vector<int>(n, 0);
+	vector<bool> on_stack = vector<bool>(n, false);
+	vector<unsigned int> component_stack = vector<unsigned int>();
+	//Each frame of the call stack holds a vertex and the position of the next edge from it to be visited:
+	vector<pair<unsigned int, unsigned int>> call_stack = vector<pair<unsigned int, unsigned int>>();
+	int n_discovered = 0;
+	unsigned int n_components = 0;
+	for (unsigned int root = 0; root < n; root++) {
+		if (discovery[root] >= 0) {
+			continue;
+		}
+		discovery[root] = lowlink[root] = n_discovered++;
+		component_stack.push_back(root);
+		on_stack[root] = true;
+		call_stack.push_back(pair<unsigned int, unsigned int>(root, adjacency.offsets[root]));
+		while (!call_stack.empty()) {
+			unsigned int u = call_stack.back().first;
+			unsigned int pos = call_stack.back().second;
+			//If there are edges from this vertex left to visit, then visit the next one:
+			if (pos < adjacency.offsets[u + 1]) {
+				call_stack.back().second++;
+				unsigned int v = adjacency.descendants[pos];
+				if (discovery[v] < 0) {
+					discovery[v] = lowlink[v] = n_discovered++;
+					component_stack.push_back(v);
+					on_stack[v] = true;
+					call_stack.push_back(pair<unsigned int, unsigned int>(v, adjacency.offsets[v]));
+				}
+				else if (on_stack[v]) {
+					lowlink[u] = min(lowlink[u], discovery[v]);
+				}
+				continue;
+			}
+			//Otherwise, return from this vertex:
+			call_stack.pop_back();
+			if (!call_stack.empty()) {
+				unsigned int parent = call_stack.back().first;
+				lowlink[parent] = min(lowlink[parent], lowlink[u]);
+			}
+			//If this vertex is the root of a component, then pop the component off of the stack:
+			if (lowlink[u] == discovery[u]) {
+				unsigned int w;
+				do {
+					w = component_stack.back();
+					component_stack.pop_back();
+					on_stack[w] = false;
+					components[w] = n_components;
+				} while (w != u);
+				n_components++;
+			}
+		}
+	}
+	return n_components;
+}
+
+/**
+ * Returns a list of the cycles of stemmatic ancestry in this global stemma,
+ * each of which is given as the list of IDs of the vertices in a strongly connected component with more than one vertex (or with an edge from a vertex to itself).
+ * The vertices in each cycle, and the cycles themselves, are sorted in the order of the vertex list.
+ * This runs in linear time in the number of vertices and edges.
+ */
+list<list<string>> global_stemma::get_cycles() const {
+	global_stemma_adjacency adjacency = get_adjacency();
+	vector<unsigned int> components;
+	unsigned int n_components = get_components(adjacency, components);
+	//Count the vertices in each component, and mark the components with edges from a vertex to itself:
+	vector<unsigned int> sizes = vector<unsigned int>(n_components, 0);
+	vector<bool> cyclic = vector<bool>(n_components, false);
+	for (unsigned int u = 0; u < components.size(); u++) {
+		sizes[components[u]]++;
+		for (unsigned int pos = adjacency.offsets[u]; pos < adjacency.offsets[u + 1]; pos++) {
+			if (adjacency.descendants[pos] == u) {
+				cyclic[components[u]] = true;
+			}
+		}
+	}
+	//Then group the vertices of the cyclic components in the order of their first vertices:
+	vector<string> ids = vector<string>();
+	for (const global_stemma_vertex & v : vertices) {
+		ids.push_back(v.id);
+	}
+	list<list<string>> cycles = list<list<string>>();
+	unordered_map<unsigned int, list<string> *> component_to_cycle = unordered_map<unsigned int, list<string> *>();
+	for (unsigned int u = 0; u < components.size(); u++) {
+		unsigned int component = components[u];
+		if (sizes[component] < 2 && !cyclic[component]) {
+			continue;
+		}
+		if (component_to_cycle.find(component) == component_to_cycle.end()) {
+			cycles.push_back(list<string>());
+			component_to_cycle[component] = &cycles.back();
+		}
+		component_to_cycle.at(component)->push_back(ids[u]);
+	}
+	return cycles;
+}
+
+/**
+ * Returns a boolean value indicating whether this global stemma is free of cycles of stemmatic ancestry.
+ */
+bool global_stemma::is_acyclic() const {
+	return get_cycles().empty();
+}
+
+/**
+ * Returns the transitive reduction of this global stemma, i.e., a copy without any edge from an ancestor to a descendant that is also reachable through other edges.
+ * Vertices are processed in reverse topological order, and each vertex's set of reachable vertices is built up as a bitmap
+ * from those of the descendants it keeps edges to (visiting the nearest descendants first), so an edge is redundant exactly when its descendant is already in that set.
+ * If this global stemma has cycles, then the reduction is computed on its strongly connected components:
+ * the edges within each component are kept, and only one edge is kept between any two components with an edge between them that is not otherwise implied.
+ * The edges kept are in the same order as in this global stemma.
+ */
+global_stemma global_stemma::get_transitive_reduction() const {
+	global_stemma_adjacency adjacency = get_adjacency();
+	vector<unsigned int> components;
+	unsigned int n_components = get_components(adjacency, components);
+	//Group the vertices by component:
+	vector<unsigned int> component_offsets = vector<unsigned int>(n_components + 1, 0);
+	for (unsigned int component : components) {
+		component_offsets[component + 1]++;
+	}
+	for (unsigned int c = 0; c < n_components; c++) {
+		component_offsets[c + 1] += component_offsets[c];
+	}
+	vector<unsigned int> component_vertices = vector<unsigned int>(components.size());
+	vector<unsigned int> next = vector<unsigned int>(component_offsets.begin(), component_offsets.end() - 1);
+	for (unsigned int u = 0; u < components.size(); u++) {
+		component_vertices[next[components[u]]++] = u;
+	}
+	//Then process the components in reverse topological order (i.e., in order of their indices):
+	vector<bool> kept = vector<bool>(edges.size(), false);
+	vector<roaring::Roaring> reachable = vector<roaring::Roaring>(n_components);
+	vector<pair<unsigned int, unsigned int>> out_edges = vector<pair<unsigned int, unsigned int>>();
+	for (unsigned int c = 0; c < n_components; c++) {
+		//Collect the edges from this component to others, keeping the edges within it:
+		out_edges.clear();
+		for (unsigned int i = component_offsets[c]; i < component_offsets[c + 1]; i++) {
+			unsigned int u = component_vertices[i];
+			for (unsigned int pos = adjacency.offsets[u]; pos < adjacency.offsets[u + 1]; pos++) {
+				unsigned int target = components[adjacency.descendants[pos]];
+				if (target == c) {
+					kept[adjacency.edge_inds[pos]] = true;
+				}
+				else {
+					out_edges.push_back(pair<unsigned int, unsigned int>(target, adjacency.edge_inds[pos]));
+				}
+			}
+		}
+		//Visit the target components nearest to this one first (i.e., in decreasing order of index),
+		//so that any component that reaches another is visited before it:
+		sort(out_edges.begin(), out_edges.end(), [](const pair<unsigned int, unsigned int> & e1, const pair<unsigned int, unsigned int> & e2) {
+			return e1.first > e2.first || (e1.first == e2.first && e1.second < e2.second);
+		});
+		for (const pair<unsigned int, unsigned int> & out_edge : out_edges) {
+			unsigned int target = out_edge.first;
+			if (reachable[c].contains(target)) {
+				continue;
+			}
+			kept[out_edge.second] = true;
+			reachable[c] |= reachable[target];
+			reachable[c].add(target);
+		}
+	}
+	list<global_stemma_edge> reduced_edges = list<global_stemma_edge>();
+	unsigned int edge_ind = 0;
+	for (const global_stemma_edge & e : edges) {
+		if (kept[edge_ind]) {
+			reduced_edges.push_back(e);
+		}
+		edge_ind++;
+	}
+	return global_stemma(vertices, reduced_edges);
+}
+
+/**
+ * Returns a map of vertex IDs to their generations in this global stemma,
+ * where a vertex without stemmatic ancestors is in generation 0, and any other vertex is in the generation after the latest generation of its ancestors
+ * (i.e., its generation is the length of the longest path of stemmatic ancestry ending at it).
+ * If this global stemma has cycles, then the vertices in each strongly connected component are placed in the same generation.
+ * This runs in linear time in the number of vertices and edges.
+ */
+unordered_map<string, unsigned int> global_stemma::get_generations() const {
+	global_stemma_adjacency adjacency = get_adjacency();
+	vector<unsigned int> components;
+	unsigned int n_components = get_components(adjacency, components);
+	//Group the vertices by component:
+	vector<vector<unsigned int>> component_vertices = vector<vector<unsigned int>>(n_components);
+	for (unsigned int u = 0; u < components.size(); u++) {
+		component_vertices[components[u]].push_back(u);
+	}
+	//Then propagate generations from the sources (i.e., the highest-numbered components) down:
+	vector<unsigned int> component_generations = vector<unsigned int>(n_components, 0);
+	for (unsigned int c = n_components; c-- > 0;) {
+		for (unsigned int u : component_vertices[c]) {
+			for (unsigned int pos = adjacency.offsets[u]; pos < adjacency.offsets[u + 1]; pos++) {
+				unsigned int target = components[adjacency.descendants[pos]];
+				if (target != c && component_generations[target] < component_generations[c] + 1) {
+					component_generations[target] = component_generations[c] + 1;
+				}
+			}
+		}
+	}
+	unordered_map<string, unsigned int> generations = unordered_map<string, unsigned int>();
+	unsigned int u = 0;
+	for (const global_stemma_vertex & v : vertices) {
+		generations[v.id] = component_generations[components[u]];
+		u++;
+	}
+	return generations;
+}
+
+/**
+ * Updates this global stemma after the local stemmata or reading support of the variation units at the given indices have changed,
+ * given the list of witnesses it was constructed from (which is updated in place) and the apparatuses from before and after the changes.
+ * An optional flag indicating whether the "classic" calculation of costs and explained readings is used for the witnesses
+ * and an optional number of worker threads (0 for as many as the hardware supports) can also be specified.
+ * Each witness's genealogical comparisons are updated only at the changed variation units,
+ * and only the witnesses whose substemma set cover problems changed have their substemmata optimized again,
+ * with their previous stemmatic ancestors used to warm-start the search.
+ * The edges to witnesses whose comparisons changed are then replaced, and all other edges are left as they are.
+ * Returns a list of the IDs of the witnesses whose substemmata were optimized again.
+ */
+list<string> global_stemma::update(list<witness> & witnesses, const apparatus & old_app, const apparatus & new_app, const set<unsigned int> & vu_inds, bool classic, unsigned int threads) {
+	//Collect the changed variation units before and after the changes:
+	vector<variation_unit> old_app_vus = old_app.get_variation_units();
+	vector<variation_unit> new_app_vus = new_app.get_variation_units();
+	map<unsigned int, variation_unit> old_vus = map<unsigned int, variation_unit>();
+	map<unsigned int, variation_unit> new_vus = map<unsigned int, variation_unit>();
+	for (unsigned int vu_ind : vu_inds) {
+		old_vus[vu_ind] = old_app_vus.at(vu_ind);
+		new_vus[vu_ind] = new_app_vus.at(vu_ind);
+	}
+	list<string> list_wit = new_app.get_list_wit();
+	//Update the genealogical comparisons of every witness in parallel:
+	vector<witness *> wits = vector<witness *>();
+	for (witness & wit : witnesses) {
+		wits.push_back(&wit);
+	}
+	vector<genealogical_comparison_update> updates = vector<genealogical_comparison_update>(wits.size());
+	parallel_for((unsigned int) wits.size(), threads, [&](unsigned int i) {
+		updates[i] = wits[i]->update_genealogical_comparisons(list_wit, old_vus, new_vus, new_app_vus, classic);
+	});
+	//Then optimize the substemmata of the affected witnesses again in parallel, starting with those with the most potential ancestors:
+	vector<unsigned int> affected = vector<unsigned int>();
+	vector<size_t> n_potential_ancestors = vector<size_t>(wits.size());
+	for (unsigned int i = 0; i < wits.size(); i++) {
+		if (updates[i] == genealogical_comparison_update::SET_COVER_CHANGED) {
+			affected.push_back(i);
+			n_potential_ancestors[i] = wits[i]->get_potential_ancestor_ids().size();
+		}
+	}
+	stable_sort(affected.begin(), affected.end(), [&](unsigned int i1, unsigned int i2) {
+		return n_potential_ancestors[i1] > n_potential_ancestors[i2];
+	});
+	parallel_for((unsigned int) affected.size(), threads, [&](unsigned int i) {
+		witness & wit = *wits[affected[i]];
+		set_cover_solver_stats stats;
+		list<set_cover_solution> substemmata = wit.get_warm_started_substemmata(wit.get_stemmatic_ancestor_ids(), stats);
+		list<string> stemmatic_ancestor_ids = list<string>();
+		if (!substemmata.empty()) {
+			for (const set_cover_row & row : substemmata.front().rows) {
+				stemmatic_ancestor_ids.push_back(row.id);
+			}
+		}
+		wit.set_stemmatic_ancestor_ids(stemmatic_ancestor_ids);
+	});
+	//Finally, patch the edge list, keeping the existing edges to witnesses whose comparisons did not change:
+	unordered_map<string, list<global_stemma_edge>> edges_by_descendant = unordered_map<string, list<global_stemma_edge>>();
+	for (const global_stemma_edge & e : edges) {
+		edges_by_descendant[e.descendant].push_back(e);
+	}
+	edges = list<global_stemma_edge>();
+	for (unsigned int i = 0; i < wits.size(); i++) {
+		list<global_stemma_edge> wit_edges = updates[i] == genealogical_comparison_update::UNCHANGED ? edges_by_descendant[wits[i]->get_id()] : get_edges_to_witness(*wits[i]);
+		edges.splice(edges.end(), wit_edges);
+	}
+	//Return the IDs of the witnesses whose substemmata were optimized again, in order:
+	sort(affected.begin(), affected.end());
+	list<string> updated_ids = list<string>();
+	for (unsigned int i : affected) {
+		updated_ids.push_back(wits[i]->get_id());
+	}
+	return updated_ids;
+}
+
+/**
+ * Given a .dot writer, writes the global stemma graph to it in .dot format.
  * Optional flags indicating whether to print edge lengths and format edges based on flow strength can be specified.
  */
-void global_stemma::to_dot(ostream & out, bool print_lengths, bool flow_strengths) {
+void global_stemma::to_dot(dot_writer & writer, bool print_lengths, bool flow_strengths) {
 	//Add the graph first:
-	out << "digraph global_stemma {\n";
+	writer.write("digraph global_stemma {\n");
 	//Add a subgraph for the legend:
-	out << "\tsubgraph cluster_legend {\n";
+	writer.write("\tsubgraph cluster_legend {\n");
 	//Add a box node indicating the label of this graph:
-	out << "\t\tlabel [shape=plaintext, label=\"Global Stemma\"];\n";
-	out << "\t}\n";
+	writer.write("\t\tlabel [shape=plaintext, label=\"Global Stemma\"];\n");
+	writer.write("\t}\n");
 	//Add a subgraph for the plot:
-	out << "\tsubgraph cluster_plot {\n";
+	writer.write("\tsubgraph cluster_plot {\n");
 	//Make its border invisible:
-	out << "\t\tstyle=invis;\n";
+	writer.write("\t\tstyle=invis;\n");
 	//Add a line indicating that nodes have an ellipse shape:
-	out << "\t\tnode [shape=ellipse];\n";
+	writer.write("\t\tnode [shape=ellipse];\n");
 	//Add all of its nodes, mapping their IDs to numerical indices:
-	unordered_map<string, int> id_to_index = unordered_map<string, int>();
-	for (global_stemma_vertex v : vertices) {
-		string wit_id = v.id;
-		unsigned int i = (unsigned int) id_to_index.size();
-		id_to_index[wit_id] = i;
-		int index = id_to_index.at(wit_id);
-		out << "\t\t";
-		out << index << " [label=\"" << wit_id << "\"]";
-		out << ";\n";
+	unordered_map<string, unsigned int> id_to_index = unordered_map<string, unsigned int>();
+	for (const global_stemma_vertex & v : vertices) {
+		unsigned int index = (unsigned int) id_to_index.size();
+		id_to_index[v.id] = index;
+		writer.write("\t\t");
+		writer.write(index);
+		writer.write(" [label=\"");
+		writer.write(v.id);
+		writer.write("\"];\n");
 	}
 	//Add all of its edges:
-	for (global_stemma_edge e : edges) {
-		//Get the numerical indices of the endpoints:
-		string ancestor_id = e.ancestor;
-		string descendant_id = e.descendant;
-		int ancestor_ind = id_to_index.at(ancestor_id);
-		int descendant_ind = id_to_index.at(descendant_id);
-		//Handle the conditional formatting of the edge:
-		list<string> format_cmds = list<string>();
+	for (const global_stemma_edge & e : edges) {
+		//Add a line describing the edge, using the numerical indices of its endpoints:
+		writer.begin_edge(id_to_index.at(e.ancestor), id_to_index.at(e.descendant));
 		//Set the preferred length of the edge (used only by the neato and fdp Graphviz programs) based on its genealogical cost:
-		string edge_len = "len=" + to_string(e.length);
-		format_cmds.push_back(edge_len);
-		//If the connectivity index is not direct (i.e., 0), then print it in one-based format:
+		writer.attribute("len=");
+		writer.write_fixed(e.length, 6);
+		//If specified, then label the edge with its length:
 		if (print_lengths) {
-			stringstream ss;
-			ss << "label=\"" << fixed << std::setprecision(3) << e.length << "\", fontsize=10" << endl;
-			string edge_label = ss.str();
-			format_cmds.push_back(edge_label);
+			writer.attribute("label=\"");
+			writer.write_fixed(e.length, 3);
+			writer.write("\", fontsize=10\n");
 		}
+		//If specified, then format the line style based on the flow strength:
 		if (flow_strengths) {
-			//Format the line style based on the flow strength:
-			if (e.strength < 0.01) {
-				string edge_style = "style=dotted";
-				format_cmds.push_back(edge_style);
-			}
-			else if (e.strength < 0.05) {
-				string edge_style = "style=dashed";
-				format_cmds.push_back(edge_style);
-			}
-			else if (e.strength < 0.1) {
-				string edge_style = "style=solid";
-				format_cmds.push_back(edge_style);
-			}
-			else {
-				string edge_style = "style=bold";
-				format_cmds.push_back(edge_style);
-			}
+			writer.attribute(dot_writer::strength_style(e.strength));
 		}
-		//Add a line describing the edge:
-		out << "\t\t" << ancestor_ind << " -> " << descendant_ind << " [";
-		for (string format_cmd : format_cmds) {
-			if (format_cmd != format_cmds.front()) {
-				out << ", ";
-			}
-			out << format_cmd;
-		}
-		out << "];\n";
+		writer.end_edge();
+	}
+	writer.write("\t}\n");
+	writer.write("}\n");
+	return;
+}
+
+/**
+ * Given an output stream, writes the global stemma graph to output in .dot format.
+ * Optional flags indicating whether to print edge lengths and format edges based on flow strength can be specified.
+ */
+void global_stemma::to_dot(ostream & out, bool print_lengths, bool flow_strengths) {
+	dot_writer writer(out);
+	to_dot(writer, print_lengths, flow_strengths);
+	return;
+}
+
+/**
+ * Given a JSON writer, writes the global stemma graph to it as a JavaScript Object Notation (JSON) object.
+ */
+void global_stemma::to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the vertices array, with each vertex as an object:
+	writer.key("vertices");
+	writer.begin_array();
+	for (const global_stemma_vertex & v : vertices) {
+		writer.begin_object();
+		writer.key("id");
+		writer.value(v.id);
+		writer.end_object();
+	}
+	writer.end_array();
+	//Add the edges array, with each edge as an object:
+	writer.key("edges");
+	writer.begin_array();
+	for (const global_stemma_edge & e : edges) {
+		writer.begin_object();
+		writer.key("ancestor");
+		writer.value(e.ancestor);
+		writer.key("descendant");
+		writer.value(e.descendant);
+		writer.key("length");
+		writer.value(e.length);
+		writer.key("strength");
+		writer.value(e.strength);
+		writer.end_object();
 	}
-	out << "\t}\n";
-	out << "}" << endl;
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
 	return;
 }
 
@@ -172,50 +550,7 @@ void global_stemma::to_dot(ostream & out, bool print_lengths, bool flow_strength
  * Given an output stream, writes the global stemma graph to output in JavaScript Object Notation (JSON) format.
  */
 void global_stemma::to_json(ostream & out) {
-    //Open the root object:
-    out << "{";
-    //Open the vertices array:
-    out << "\"vertices\":" << "[";
-    //Print each vertex as an object:
-	unsigned int vertex_num = 0;
-	for (global_stemma_vertex v : vertices) {
-        //Open the vertex object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"id\":" << "\"" << v.id << "\"";
-        //Close the vertex object:
-        out << "}";
-        //Add a comma if this is not the last vertex:
-        if (vertex_num != vertices.size() - 1) {
-            out << ",";
-        }
-		vertex_num++;
-	}
-	//Close the vertices array:
-    out << "]" << ",";
-	//Open the edges array:
-    out << "\"edges\":" << "[";
-    //Print each edge as an object:
-	unsigned int edge_num = 0;
-	for (global_stemma_edge e : edges) {
-        //Open the edge object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"ancestor\":" << "\"" << e.ancestor << "\"" << ",";
-        out << "\"descendant\":" << "\"" << e.descendant << "\"" << ",";
-        out << "\"length\":" << e.length << ",";
-        out << "\"strength\":" << e.strength;
-        //Close the edge object:
-        out << "}";
-        //Add a comma if this is not the last edge:
-        if (edge_num != edges.size() - 1) {
-            out << ",";
-        }
-		edge_num++;
-	}
-	//Close the edges array:
-    out << "]";
-    //Close the root object:
-    out << "}";
+	json_writer writer(out);
+	to_json(writer);
 	return;
 }
@@ -0,0 +1,203 @@
+/*
+ * global_stemma_pipeline.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+
+#include "apparatus.h"
+#include "witness.h"
+#include "set_cover_solver.h"
+#include "global_stemma.h"
+#include "substemma_checkpoint.h"
+#include "parallel_for.h"
+#include "json_writer.h"
+#include "global_stemma_pipeline.h"
+
+using namespace std;
+
+/**
+ * Default constructor.
+ */
+global_stemma_pipeline::global_stemma_pipeline() {
+
+}
+
+/**
+ * Runs the whole global stemma pipeline on the given apparatus, using an optional flag indicating whether
+ * the "classic" calculation of costs and explained readings should be used for the witnesses
+ * and an optional number of worker threads (0 for as many as the hardware supports).
+ */
+global_stemma_pipeline::global_stemma_pipeline(const apparatus & app, bool classic, unsigned int _threads) {
+	threads = _threads;
+	run(app, classic, nullptr);
+}
+
+/**
+ * Runs the whole global stemma pipeline on the given apparatus, as the constructor without a checkpoint path does,
+ * but records each witness's optimized substemma and solver statistics in the checkpoint file at the given path as soon as they are found.
+ * If the checkpoint file already exists (e.g., because an earlier run was interrupted), then the witnesses recorded in it are not optimized again.
+ * The checkpoint is tied to the apparatus and the flag for the "classic" calculation,
+ * and a runtime_error is thrown if the existing checkpoint file was written for different ones.
+ */
+global_stemma_pipeline::global_stemma_pipeline(const apparatus & app, const string & checkpoint_path, bool classic, unsigned int _threads) {
+	threads = _threads;
+	substemma_checkpoint checkpoint(checkpoint_path, substemma_checkpoint::get_key(app, classic));
+	run(app, classic, &checkpoint);
+}
+
+/**
+ * Default destructor.
+ */
+global_stemma_pipeline::~global_stemma_pipeline() {
+
+}
+
+/**
+ * Runs the global stemma pipeline on the given apparatus, using the given flag for the "classic" calculation of costs and explained readings
+ * and an optional checkpoint (which may be null).
+ * The pipeline constructs a witness for each witness ID in the apparatus, optimizes each witness's substemma
+ * (taking a single minimum-cost solution) to set its stemmatic ancestors, and then constructs the global stemma.
+ * The first two stages are run in parallel; since substemma optimization times vary widely,
+ * witnesses are scheduled in decreasing order of their number of potential ancestors,
+ * so that the hardest set cover instances start first and do not straggle at the end.
+ */
+void global_stemma_pipeline::run(const apparatus & app, bool classic, substemma_checkpoint * checkpoint) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	//Construct the witnesses in parallel:
+	chrono::steady_clock::time_point stage_start = chrono::steady_clock::now();
+	list<string> list_wit = app.get_list_wit();
+	vector<string> wit_ids = vector<string>(list_wit.begin(), list_wit.end());
+	vector<witness> indexed_witnesses = vector<witness>(wit_ids.size());
+	parallel_for((unsigned int) wit_ids.size(), threads, [&](unsigned int i) {
+		indexed_witnesses[i] = witness(wit_ids[i], app, classic);
+	});
+	timing.witnesses_time = chrono::duration<double>(chrono::steady_clock::now() - stage_start).count();
+	//Then optimize the substemmata of the witnesses in parallel, starting with those with the most potential ancestors
+	//(and skipping any witnesses already solved in the checkpoint):
+	stage_start = chrono::steady_clock::now();
+	solver_stats = vector<set_cover_solver_stats>(indexed_witnesses.size());
+	vector<unsigned int> schedule = vector<unsigned int>();
+	vector<size_t> n_potential_ancestors = vector<size_t>(indexed_witnesses.size());
+	n_resumed = 0;
+	for (unsigned int i = 0; i < indexed_witnesses.size(); i++) {
+		witness & wit = indexed_witnesses[i];
+		if (checkpoint != nullptr && checkpoint->contains(wit.get_id())) {
+			substemma_checkpoint_entry entry = checkpoint->get_entry(wit.get_id());
+			wit.set_stemmatic_ancestor_ids(entry.stemmatic_ancestor_ids);
+			solver_stats[i] = entry.stats;
+			n_resumed++;
+			continue;
+		}
+		schedule.push_back(i);
+		n_potential_ancestors[i] = wit.get_potential_ancestor_ids().size();
+	}
+	stable_sort(schedule.begin(), schedule.end(), [&](unsigned int i1, unsigned int i2) {
+		return n_potential_ancestors[i1] > n_potential_ancestors[i2];
+	});
+	parallel_for((unsigned int) schedule.size(), threads, [&](unsigned int i) {
+		unsigned int wit_ind = schedule[i];
+		witness & wit = indexed_witnesses[wit_ind];
+		list<set_cover_solution> substemmata = wit.get_substemmata(0, true, solver_stats[wit_ind]);
+		list<string> stemmatic_ancestor_ids = list<string>();
+		if (!substemmata.empty()) {
+			for (const set_cover_row & row : substemmata.front().rows) {
+				stemmatic_ancestor_ids.push_back(row.id);
+			}
+		}
+		wit.set_stemmatic_ancestor_ids(stemmatic_ancestor_ids);
+		if (checkpoint != nullptr) {
+			substemma_checkpoint_entry entry;
+			entry.wit_id = wit.get_id();
+			entry.stemmatic_ancestor_ids = stemmatic_ancestor_ids;
+			entry.stats = solver_stats[wit_ind];
+			checkpoint->append(entry);
+		}
+	});
+	timing.substemmata_time = chrono::duration<double>(chrono::steady_clock::now() - stage_start).count();
+	//Then construct the global stemma:
+	stage_start = chrono::steady_clock::now();
+	witnesses = list<witness>(indexed_witnesses.begin(), indexed_witnesses.end());
+	stemma = global_stemma(witnesses);
+	timing.stemma_time = chrono::duration<double>(chrono::steady_clock::now() - stage_start).count();
+	timing.total_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return;
+}
+
+/**
+ * Returns the number of worker threads this pipeline used.
+ */
+unsigned int global_stemma_pipeline::get_threads() const {
+	return threads;
+}
+
+/**
+ * Returns the witnesses constructed by this pipeline, with their stemmatic ancestors set, in the apparatus's witness order.
+ */
+list<witness> global_stemma_pipeline::get_witnesses() const {
+	return witnesses;
+}
+
+/**
+ * Returns the statistics of each witness's substemma optimization, in the apparatus's witness order.
+ */
+vector<set_cover_solver_stats> global_stemma_pipeline::get_solver_stats() const {
+	return solver_stats;
+}
+
+/**
+ * Returns the global stemma constructed by this pipeline.
+ */
+global_stemma global_stemma_pipeline::get_global_stemma() const {
+	return stemma;
+}
+
+/**
+ * Returns the time spent in each stage of this pipeline.
+ */
+global_stemma_pipeline_timing global_stemma_pipeline::get_timing() const {
+	return timing;
+}
+
+/**
+ * Returns the number of witnesses whose substemmata were read from a checkpoint rather than optimized.
+ */
+unsigned int global_stemma_pipeline::get_n_resumed() const {
+	return n_resumed;
+}
+
+/**
+ * Given a JSON writer, writes the time spent in each stage of this pipeline to it as a JavaScript Object Notation (JSON) object.
+ */
+void global_stemma_pipeline::timing_to_json(json_writer & writer) {
+	writer.begin_object();
+	writer.key("threads");
+	writer.value(threads);
+	writer.key("witnesses_time");
+	writer.value(timing.witnesses_time);
+	writer.key("substemmata_time");
+	writer.value(timing.substemmata_time);
+	writer.key("stemma_time");
+	writer.value(timing.stemma_time);
+	writer.key("total_time");
+	writer.value(timing.total_time);
+	writer.end_object();
+	return;
+}
+
+/**
+ * Given an output stream, prints the time spent in each stage of this pipeline in JavaScript Object Notation (JSON) format.
+ */
+void global_stemma_pipeline::timing_to_json(ostream & out) {
+	json_writer writer(out);
+	timing_to_json(writer);
+	return;
+}
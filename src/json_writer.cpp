@@ -0,0 +1,347 @@
+/*
+ * json_writer.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "json_writer.h"
+
+using namespace std;
+
+/**
+ * Returns the shortest decimal representation of the given floating-point value (of type T) that reads back as the same value,
+ * trying each precision in turn up to the given maximum number of significant digits.
+ * Integral values are written without a decimal point, and values that are not finite are written as null.
+ */
+template <typename T>
+string format_floating_point(T x, int max_digits) {
+	if (!isfinite(x)) {
+		return "null";
+	}
+	//Integral values within the range where every integer is exactly representable can be written as integers:
+	if (x == floor(x) && fabs(x) < 1e15) {
+		return to_string((long long) x);
+	}
+	//Make the buffer large enough for any output of the %g format, so that it is never truncated:
+	char buf[320];
+	for (int digits = 1; digits < max_digits; digits++) {
+		snprintf(buf, sizeof(buf), "%.*g", digits, (double) x);
+		if ((T) strtod(buf, nullptr) == x) {
+			return string(buf);
+		}
+	}
+	snprintf(buf, sizeof(buf), "%.*g", max_digits, (double) x);
+	return string(buf);
+}
+
+/**
+ * Constructs a JSON writer that writes to the given output stream,
+ * using an internal buffer of (approximately) the given size in bytes.
+ */
+json_writer::json_writer(ostream & _out, size_t _buffer_size) {
+	out = &_out;
+	buffer_size = _buffer_size;
+	buffer = string();
+	buffer.reserve(buffer_size + 64);
+	container_has_values = vector<bool>();
+}
+
+/**
+ * Default destructor. Writes anything left in the buffer to the output stream.
+ */
+json_writer::~json_writer() {
+	flush();
+}
+
+/**
+ * Returns the shortest decimal representation of the given single-precision number that reads back as the same number,
+ * or null if it is not finite.
+ */
+string json_writer::format_number(float x) {
+	return format_floating_point<float>(x, 9);
+}
+
+/**
+ * Returns the shortest decimal representation of the given double-precision number that reads back as the same number,
+ * or null if it is not finite.
+ */
+string json_writer::format_number(double x) {
+	return format_floating_point<double>(x, 17);
+}
+
+/**
+ * Prepares the buffer for a new value, adding a comma if it is not the first value in its container.
+ */
+void json_writer::before_value() {
+	if (after_key) {
+		after_key = false;
+		return;
+	}
+	if (!container_has_values.empty()) {
+		if (container_has_values.back()) {
+			buffer += ',';
+		}
+		container_has_values.back() = true;
+	}
+	return;
+}
+
+/**
+ * Appends the given string to the buffer as a quoted JSON string, escaping quotation marks, backslashes, and control characters.
+ * Other characters (including multi-byte UTF-8 sequences) are copied as they are.
+ */
+void json_writer::append_string(const string & s) {
+	static const char hex_digits[] = "0123456789abcdef";
+	buffer += '"';
+	for (unsigned char c : s) {
+		switch (c) {
+			case '"':
+				buffer += "\\\"";
+				break;
+			case '\\':
+				buffer += "\\\\";
+				break;
+			case '\b':
+				buffer += "\\b";
+				break;
+			case '\f':
+				buffer += "\\f";
+				break;
+			case '\n':
+				buffer += "\\n";
+				break;
+			case '\r':
+				buffer += "\\r";
+				break;
+			case '\t':
+				buffer += "\\t";
+				break;
+			default:
+				if (c < 0x20) {
+					buffer += "\\u00";
+					buffer += hex_digits[c >> 4];
+					buffer += hex_digits[c & 15];
+				}
+				else {
+					buffer += (char) c;
+				}
+		}
+	}
+	buffer += '"';
+	return;
+}
+
+/**
+ * Appends the given magnitude to the buffer as a decimal integer, with a minus sign if the negative flag is set.
+ */
+void json_writer::append_integer(unsigned long long n, bool negative) {
+	char digits[24];
+	unsigned int n_digits = 0;
+	do {
+		digits[n_digits++] = (char) ('0' + n % 10);
+		n /= 10;
+	} while (n > 0);
+	if (negative) {
+		buffer += '-';
+	}
+	while (n_digits > 0) {
+		buffer += digits[--n_digits];
+	}
+	return;
+}
+
+/**
+ * Writes the buffer to the output stream if it has reached its size.
+ */
+void json_writer::flush_if_full() {
+	if (buffer.size() >= buffer_size) {
+		flush();
+	}
+	return;
+}
+
+/**
+ * Opens a new object.
+ */
+void json_writer::begin_object() {
+	before_value();
+	buffer += '{';
+	container_has_values.push_back(false);
+	return;
+}
+
+/**
+ * Closes the innermost open object.
+ */
+void json_writer::end_object() {
+	container_has_values.pop_back();
+	buffer += '}';
+	flush_if_full();
+	return;
+}
+
+/**
+ * Opens a new array.
+ */
+void json_writer::begin_array() {
+	before_value();
+	buffer += '[';
+	container_has_values.push_back(false);
+	return;
+}
+
+/**
+ * Closes the innermost open array.
+ */
+void json_writer::end_array() {
+	container_has_values.pop_back();
+	buffer += ']';
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes the given key in the innermost open object; the next value written will be its value.
+ */
+void json_writer::key(const string & k) {
+	before_value();
+	append_string(k);
+	buffer += ':';
+	after_key = true;
+	return;
+}
+
+/**
+ * Writes the given string value.
+ */
+void json_writer::value(const string & s) {
+	before_value();
+	append_string(s);
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes the given null-terminated string value.
+ */
+void json_writer::value(const char * s) {
+	value(string(s));
+	return;
+}
+
+/**
+ * Writes the given Boolean value.
+ */
+void json_writer::value(bool b) {
+	before_value();
+	buffer += b ? "true" : "false";
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes the given integer value.
+ */
+void json_writer::value(int n) {
+	value((long long) n);
+	return;
+}
+
+/**
+ * Writes the given unsigned integer value.
+ */
+void json_writer::value(unsigned int n) {
+	value((unsigned long long) n);
+	return;
+}
+
+/**
+ * Writes the given long integer value.
+ */
+void json_writer::value(long long n) {
+	before_value();
+	//Negate in unsigned arithmetic, so that the minimum value does not overflow:
+	append_integer(n < 0 ? 0ULL - (unsigned long long) n : (unsigned long long) n, n < 0);
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes the given unsigned long integer value.
+ */
+void json_writer::value(unsigned long long n) {
+	before_value();
+	append_integer(n, false);
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes the given single-precision number, in the shortest form that reads back as the same number (or as null if it is not finite).
+ */
+void json_writer::value(float x) {
+	before_value();
+	buffer += format_number(x);
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes the given double-precision number, in the shortest form that reads back as the same number (or as null if it is not finite).
+ */
+void json_writer::value(double x) {
+	before_value();
+	buffer += format_number(x);
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes a null value.
+ */
+void json_writer::null_value() {
+	before_value();
+	buffer += "null";
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes the given string, which is assumed to be already serialized JSON, as a value without escaping it
+ * (e.g., so that values serialized in parallel can be written in order).
+ */
+void json_writer::raw_value(const string & json) {
+	before_value();
+	buffer += json;
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes a line break, which ends a record when values are written as newline-delimited JSON (NDJSON).
+ * It should only be written between top-level values, since JSON strings cannot contain unescaped line breaks.
+ */
+void json_writer::newline() {
+	buffer += '\n';
+	flush_if_full();
+	return;
+}
+
+/**
+ * Writes everything in the buffer to the output stream.
+ */
+void json_writer::flush() {
+	if (!buffer.empty()) {
+		out->write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+	return;
+}
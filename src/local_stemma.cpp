@@ -15,6 +15,7 @@
 
 #include "pugixml.hpp"
 #include "local_stemma.h"
+#include "json_writer.h"
 
 using namespace std;
 using namespace pugi;
@@ -368,54 +369,48 @@ void local_stemma::to_dot(ostream & out, bool print_weights) {
 }
 
 /**
- * Given an output stream, writes the local stemma graph to output in JavaScript Object Notation (JSON) format.
+ * Given a JSON writer, writes the local stemma graph to it as a JavaScript Object Notation (JSON) object.
  */
-void local_stemma::to_json(ostream & out) {
-    //Open the root object:
-    out << "{";
-    //Add the metadata fields:
-	out << "\"label\":" << "\"" << label << "\"" << ",";
-    //Open the vertices array:
-    out << "\"vertices\":" << "[";
-    //Print each vertex as an object:
-	unsigned int vertex_num = 0;
-	for (local_stemma_vertex v : vertices) {
-        //Open the vertex object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"id\":" << "\"" << v.id << "\"";
-        //Close the vertex object:
-        out << "}";
-        //Add a comma if this is not the last vertex:
-        if (vertex_num != vertices.size() - 1) {
-            out << ",";
-        }
-		vertex_num++;
+void local_stemma::to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("label");
+	writer.value(label);
+	//Add the vertices array, with each vertex as an object:
+	writer.key("vertices");
+	writer.begin_array();
+	for (const local_stemma_vertex & v : vertices) {
+		writer.begin_object();
+		writer.key("id");
+		writer.value(v.id);
+		writer.end_object();
 	}
-	//Close the vertices array:
-    out << "]" << ",";
-	//Open the edges array:
-    out << "\"edges\":" << "[";
-    //Print each edge as an object:
-	unsigned int edge_num = 0;
-	for (local_stemma_edge e : edges) {
-        //Open the edge object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"prior\":" << "\"" << e.prior << "\"" << ",";
-        out << "\"posterior\":" << "\"" << e.posterior << "\"" << ",";
-        out << "\"weight\":" << e.weight;
-        //Close the edge object:
-        out << "}";
-        //Add a comma if this is not the last edge:
-        if (edge_num != edges.size() - 1) {
-            out << ",";
-        }
-		edge_num++;
+	writer.end_array();
+	//Add the edges array, with each edge as an object:
+	writer.key("edges");
+	writer.begin_array();
+	for (const local_stemma_edge & e : edges) {
+		writer.begin_object();
+		writer.key("prior");
+		writer.value(e.prior);
+		writer.key("posterior");
+		writer.value(e.posterior);
+		writer.key("weight");
+		writer.value(e.weight);
+		writer.end_object();
 	}
-	//Close the edges array:
-    out << "]";
-    //Close the root object:
-    out << "}";
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
+/**
+ * Given an output stream, writes the local stemma graph to output in JavaScript Object Notation (JSON) format.
+ */
+void local_stemma::to_json(ostream & out) {
+	json_writer writer(out);
+	to_json(writer);
 	return;
 }
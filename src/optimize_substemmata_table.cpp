@@ -12,11 +12,13 @@
 #include <set>
 #include <algorithm>
 #include <limits>
+#include <functional>
 
 #include <roaring/roaring.hh>
 #include "set_cover_solver.h"
 #include "witness.h"
 #include "optimize_substemmata_table.h"
+#include "json_writer.h"
 
 using namespace std;
 
@@ -37,18 +39,41 @@ optimize_substemmata_table::optimize_substemmata_table(const witness & wit, floa
     primary_extant = (int) wit.get_genealogical_comparison_for_witness(id).extant.cardinality();
 	rows = list<optimize_substemmata_table_row>();
 	list<set_cover_solution> substemmata = wit.get_substemmata(ub);
-	for (set_cover_solution substemma : substemmata) {
-	    optimize_substemmata_table_row row;
-		row.ancestors = list<string>();
-		for (set_cover_row sc_row : substemma.rows) {
-		    row.ancestors.push_back(sc_row.id);
-		}
-		row.cost = substemma.cost;
-		row.agreements = substemma.agreements;
-		rows.push_back(row);
+	for (const set_cover_solution & substemma : substemmata) {
+		rows.push_back(get_row(substemma));
 	}
 }
 
+/**
+ * Constructs an optimize substemmata table containing at most the given number of lowest-cost substemmata for a given witness
+ * (assumed to have its potential ancestors list populated).
+ * If the specified upper bound on substemma costs is positive, then only substemmata within this bound will be considered;
+ * otherwise, the search is bounded only by the cost of the worst substemma in the table.
+ */
+optimize_substemmata_table::optimize_substemmata_table(const witness & wit, float ub, unsigned int max_rows) {
+    id = wit.get_id();
+    primary_extant = (int) wit.get_genealogical_comparison_for_witness(id).extant.cardinality();
+	rows = list<optimize_substemmata_table_row>();
+	list<set_cover_solution> substemmata = wit.get_cheapest_substemmata(max_rows, ub);
+	for (const set_cover_solution & substemma : substemmata) {
+		rows.push_back(get_row(substemma));
+	}
+}
+
+/**
+ * Constructs an optimize substemmata table for a given witness that streams its rows from the given enumerator of the witness's substemmata
+ * (e.g., one returned by the witness's get_substemmata_enumerator method).
+ * The rows are not stored or sorted by cost; each output method draws them from a fresh copy of the enumerator, in the order in which it finds them,
+ * so that a table with a generous upper bound can be written out without holding all of its substemmata in memory.
+ */
+optimize_substemmata_table::optimize_substemmata_table(const witness & wit, const set_cover_solution_enumerator & _enumerator) {
+    id = wit.get_id();
+    primary_extant = (int) wit.get_genealogical_comparison_for_witness(id).extant.cardinality();
+	rows = list<optimize_substemmata_table_row>();
+	streamed = true;
+	enumerator = _enumerator;
+}
+
 /**
  * Default destructor.
  */
@@ -56,6 +81,39 @@ optimize_substemmata_table::~optimize_substemmata_table() {
 
 }
 
+/**
+ * Converts the given substemma to a row of this table.
+ */
+optimize_substemmata_table_row optimize_substemmata_table::get_row(const set_cover_solution & substemma) {
+	optimize_substemmata_table_row row;
+	row.ancestors = list<string>();
+	for (const set_cover_row & sc_row : substemma.rows) {
+		row.ancestors.push_back(sc_row.id);
+	}
+	row.cost = substemma.cost;
+	row.agreements = substemma.agreements;
+	return row;
+}
+
+/**
+ * Calls the given function on each row of this table in order.
+ * If this table streams its rows, then they are drawn one at a time from a copy of its enumerator, so that this table's enumerator can be reused.
+ */
+void optimize_substemmata_table::for_each_row(const function<void(const optimize_substemmata_table_row &)> & f) const {
+	if (!streamed) {
+		for (const optimize_substemmata_table_row & row : rows) {
+			f(row);
+		}
+		return;
+	}
+	set_cover_solution_enumerator rows_enumerator = enumerator;
+	set_cover_solution substemma;
+	while (rows_enumerator.next(substemma)) {
+		f(get_row(substemma));
+	}
+	return;
+}
+
 /**
  * Returns the ID of the primary witness for which this table provides comparisons.
  */
@@ -72,9 +130,17 @@ int optimize_substemmata_table::get_primary_extant() const {
 
 /**
  * Returns this table's list of rows.
+ * If this table streams its rows, then they are all drawn from its enumerator into the list.
  */
 list<optimize_substemmata_table_row> optimize_substemmata_table::get_rows() const {
-    return rows;
+    if (!streamed) {
+        return rows;
+    }
+    list<optimize_substemmata_table_row> streamed_rows = list<optimize_substemmata_table_row>();
+    for_each_row([&](const optimize_substemmata_table_row & row) {
+        streamed_rows.push_back(row);
+    });
+    return streamed_rows;
 }
 
 /**
@@ -90,7 +156,7 @@ void optimize_substemmata_table::to_fixed_width(ostream & out) {
 	out << std::right << std::setw(8) << "AGREE";
 	out << "\n\n";
 	//Print the subsequent rows:
-	for (optimize_substemmata_table_row row : rows) {
+	for_each_row([&](const optimize_substemmata_table_row & row) {
 		string substemma_str = "";
 		for (string ancestor : row.ancestors) {
 			substemma_str += ancestor;
@@ -102,7 +168,7 @@ void optimize_substemmata_table::to_fixed_width(ostream & out) {
 		out << std::right << std::setw(8) << row.cost;
 		out << std::right << std::setw(8) << row.agreements;
 		out << "\n";
-	}
+	});
 	out << endl;
 	return;
 }
@@ -117,7 +183,7 @@ void optimize_substemmata_table::to_csv(ostream & out) {
 	out << "COST" << ",";
 	out << "AGREE" << "\n";
 	//Print the subsequent rows:
-	for (optimize_substemmata_table_row row : rows) {
+	for_each_row([&](const optimize_substemmata_table_row & row) {
 		string substemma_str = "";
 		substemma_str += "\""; //place in quotes to escape commas
 		for (string ancestor : row.ancestors) {
@@ -130,7 +196,7 @@ void optimize_substemmata_table::to_csv(ostream & out) {
 		out << substemma_str << ",";
 		out << row.cost << ",";
 		out << row.agreements << "\n";
-	}
+	});
 	out << endl;
 	return;
 }
@@ -145,7 +211,7 @@ void optimize_substemmata_table::to_tsv(ostream & out) {
 	out << "COST" << "\t";
 	out << "AGREE" << "\n";
 	//Print the subsequent rows:
-	for (optimize_substemmata_table_row row : rows) {
+	for_each_row([&](const optimize_substemmata_table_row & row) {
 		string substemma_str = "";
 		for (string ancestor : row.ancestors) {
 			substemma_str += ancestor;
@@ -156,54 +222,50 @@ void optimize_substemmata_table::to_tsv(ostream & out) {
 		out << substemma_str << "\t";
 		out << row.cost << "\t";
 		out << row.agreements << "\n";
-	}
+	});
 	out << endl;
 	return;
 }
 
+/**
+ * Given a JSON writer, writes this substemma optimization table to it as a JavaScript Object Notation (JSON) object.
+ */
+void optimize_substemmata_table::to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("primary_wit");
+	writer.value(id);
+	writer.key("primary_extant");
+	writer.value(primary_extant);
+	//Add the rows array, with each row as an object:
+	writer.key("rows");
+	writer.begin_array();
+	for_each_row([&](const optimize_substemmata_table_row & row) {
+		writer.begin_object();
+		writer.key("ancestors");
+		writer.begin_array();
+		for (const string & ancestor : row.ancestors) {
+			writer.value(ancestor);
+		}
+		writer.end_array();
+		writer.key("cost");
+		writer.value(row.cost);
+		writer.key("agreements");
+		writer.value(row.agreements);
+		writer.end_object();
+	});
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
 /**
  * Given an output stream, prints this substemma optimization table in JavaScript Object Notation (JSON) format.
- * The witness IDs are assumed not to contain characters that need to be escaped in URLs.
  */
 void optimize_substemmata_table::to_json(ostream & out) {
-    //Open the root object:
-    out << "{";
-    //Add the metadata fields:
-	out << "\"primary_wit\":" << "\"" << id << "\"" << ",";
-	out << "\"primary_extant\":" << primary_extant << ",";
-    //Open the rows array:
-    out << "\"rows\":" << "[";
-    //Print each row as an object:
-	unsigned int row_num = 0;
-	for (optimize_substemmata_table_row row : rows) {
-        //Open the row object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"ancestors\":";
-		//Open the substemma array:
-		out << "[";
-		for (string ancestor : row.ancestors) {
-			out << "\"" << ancestor << "\"";
-			if (ancestor != row.ancestors.back()) {
-				out << ",";
-			}
-		}
-		//Close the substemma array:
-		out << "]";
-		out << ",";
-		out << "\"cost\":" << row.cost << ",";
-		out << "\"agreements\":" << row.agreements;
-        //Close the row object:
-        out << "}";
-        //Add a comma if this is not the last row:
-        if (row_num != rows.size() - 1) {
-            out << ",";
-        }
-		row_num++;
-	}
-    //Close the rows array:
-    out << "]";
-    //Close the root object:
-    out << "}";
+	json_writer writer(out);
+	to_json(writer);
 	return;
 }
@@ -0,0 +1,188 @@
+/*
+ * parallel_for.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <functional>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include "parallel_for.h"
+
+using namespace std;
+
+/**
+ * Calls the given function on indices claimed one at a time from the given shared counter until every index below n has been claimed.
+ * If a call throws an exception, then the first such exception is recorded, and the given failure flag is set so that no further indices are claimed.
+ */
+static void claim_indices(unsigned int n, const function<void(unsigned int)> & body, atomic<unsigned int> & next_index, atomic<bool> & failed, exception_ptr & first_exception, mutex & exception_mutex) {
+	while (!failed.load()) {
+		unsigned int i = next_index.fetch_add(1);
+		if (i >= n) {
+			break;
+		}
+		try {
+			body(i);
+		}
+		catch (...) {
+			lock_guard<mutex> lock(exception_mutex);
+			if (!first_exception) {
+				first_exception = current_exception();
+			}
+			failed.store(true);
+		}
+	}
+}
+
+/**
+ * Returns the number of worker threads to use for the given requested number of threads.
+ * A request of 0 threads is interpreted as a request for as many threads as the hardware supports.
+ */
+unsigned int resolve_threads(unsigned int threads) {
+	if (threads == 0) {
+		threads = thread::hardware_concurrency();
+	}
+	return threads > 0 ? threads : 1;
+}
+
+/**
+ * Calls the given function on every index from 0 to n - 1, distributing the indices over the given number of threads
+ * (or as many threads as the hardware supports, if the number of threads is 0).
+ * Indices are claimed one at a time from a shared counter, so uneven workloads are balanced across threads.
+ * The function must be safe to call concurrently for different indices;
+ * callers that need deterministic output should write the result for each index to its own slot.
+ * If any call throws an exception, then no further indices are claimed, and the first exception is rethrown once all threads have finished.
+ */
+void parallel_for(unsigned int n, unsigned int threads, const function<void(unsigned int)> & body) {
+	threads = resolve_threads(threads);
+	if (threads > n) {
+		threads = n;
+	}
+	//If there is no work to share, then do it on this thread:
+	if (threads <= 1) {
+		for (unsigned int i = 0; i < n; i++) {
+			body(i);
+		}
+		return;
+	}
+	atomic<unsigned int> next_index(0);
+	atomic<bool> failed(false);
+	exception_ptr first_exception = nullptr;
+	mutex exception_mutex;
+	vector<thread> workers = vector<thread>();
+	workers.reserve(threads);
+	for (unsigned int t = 0; t < threads; t++) {
+		workers.push_back(thread([&]() {
+			claim_indices(n, body, next_index, failed, first_exception, exception_mutex);
+		}));
+	}
+	for (thread & worker : workers) {
+		worker.join();
+	}
+	if (first_exception) {
+		rethrow_exception(first_exception);
+	}
+}
+
+/**
+ * Constructs a pool for running loops over the given number of threads
+ * (or as many threads as the hardware supports, if the number of threads is 0).
+ * The thread that runs a loop takes part in it, so one fewer worker thread is started.
+ */
+thread_pool::thread_pool(unsigned int threads) : next_index(0), failed(false) {
+	threads = resolve_threads(threads);
+	workers = vector<thread>();
+	workers.reserve(threads - 1);
+	for (unsigned int t = 1; t < threads; t++) {
+		workers.push_back(thread(&thread_pool::work, this));
+	}
+}
+
+/**
+ * Stops and joins the worker threads.
+ */
+thread_pool::~thread_pool() {
+	{
+		lock_guard<mutex> lock(state_mutex);
+		stopping = true;
+	}
+	work_ready.notify_all();
+	for (thread & worker : workers) {
+		worker.join();
+	}
+}
+
+/**
+ * Waits for each loop and takes part in it until the pool is stopped.
+ */
+void thread_pool::work() {
+	unsigned int seen_generation = 0;
+	while (true) {
+		{
+			unique_lock<mutex> lock(state_mutex);
+			work_ready.wait(lock, [&]() { return stopping || generation != seen_generation; });
+			if (stopping) {
+				return;
+			}
+			seen_generation = generation;
+		}
+		claim_indices(n, *body, next_index, failed, first_exception, exception_mutex);
+		{
+			lock_guard<mutex> lock(state_mutex);
+			active--;
+			if (active == 0) {
+				work_done.notify_all();
+			}
+		}
+	}
+}
+
+/**
+ * Returns the number of threads that take part in each loop, including the calling thread.
+ */
+unsigned int thread_pool::size() const {
+	return (unsigned int) workers.size() + 1;
+}
+
+/**
+ * Calls the given function on every index from 0 to n - 1, distributing the indices over this pool's threads,
+ * under the same contract as the free parallel_for function.
+ * Loops from different callers are run one at a time, so this must not be called from inside a loop on the same pool.
+ */
+void thread_pool::parallel_for(unsigned int _n, const function<void(unsigned int)> & _body) {
+	lock_guard<mutex> run_lock(run_mutex);
+	//If there is no work to share, then do it on this thread:
+	if (workers.empty() || _n <= 1) {
+		for (unsigned int i = 0; i < _n; i++) {
+			_body(i);
+		}
+		return;
+	}
+	{
+		lock_guard<mutex> lock(state_mutex);
+		body = &_body;
+		n = _n;
+		next_index.store(0);
+		failed.store(false);
+		first_exception = nullptr;
+		active = (unsigned int) workers.size();
+		generation++;
+	}
+	work_ready.notify_all();
+	claim_indices(n, *body, next_index, failed, first_exception, exception_mutex);
+	{
+		unique_lock<mutex> lock(state_mutex);
+		work_done.wait(lock, [&]() { return active == 0; });
+	}
+	if (first_exception) {
+		exception_ptr e = first_exception;
+		first_exception = nullptr;
+		rethrow_exception(e);
+	}
+}
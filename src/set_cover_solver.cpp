@@ -5,19 +5,220 @@
  *      Author: jjmccollum
  */
 
+#include <iostream>
 #include <string>
 #include <list>
 #include <stack>
+#include <queue>
+#include <functional>
+#include <utility>
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
 #include <limits>
+#include <memory>
+#include <chrono>
 
 #include "set_cover_solver.h"
+#include "dense_bitset.h"
+#include "json_writer.h"
 #include <roaring/roaring.hh>
 
 using namespace std;
 using namespace roaring;
 
+/**
+ * Maximum number of rows in a set cover problem for which the meet-in-the-middle backend will be used.
+ * Each half of the rows then has at most 2^12 subsets.
+ */
+const unsigned int MEET_IN_THE_MIDDLE_MAX_ROWS = 24;
+
+/**
+ * Returns the number of seconds elapsed since the given time point.
+ */
+double seconds_since(const chrono::steady_clock::time_point & start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Default constructor.
+ */
+set_cover_kernel::set_cover_kernel() {
+
+}
+
+/**
+ * Default destructor.
+ */
+set_cover_kernel::~set_cover_kernel() {
+
+}
+
+/**
+ * Set cover kernel that represents each row's coverage of the target set as a fixed-width dense bitset of W 64-bit words.
+ * Columns are compressed to their ranks within the target set, so the width only has to accommodate the size of the target.
+ * It only serves feasibility checks and the meet-in-the-middle backend;
+ * the branch-and-bound search state stays in Roaring bitmaps of row indices and the solver's per-column counts.
+ */
+template <unsigned int W>
+class dense_set_cover_kernel : public set_cover_kernel {
+private:
+	vector<dense_bitset<W>> row_bitsets;
+	dense_bitset<W> target_bitset;
+public:
+	/**
+	 * Constructs a dense set cover kernel given a vector of row data structures and a bitmap representing the target set to cover,
+	 * which is assumed to fit in W words.
+	 */
+	dense_set_cover_kernel(const vector<set_cover_row> & rows, const Roaring & target) {
+		//Map each target column to its rank within the target set:
+		unordered_map<unsigned int, unsigned int> column_ranks = unordered_map<unsigned int, unsigned int>();
+		unsigned int rank = 0;
+		for (Roaring::const_iterator it = target.begin(); it != target.end(); it++) {
+			column_ranks[*it] = rank;
+			target_bitset.add(rank);
+			rank++;
+		}
+		//Then convert each row's coverage of the target set to a dense bitset over these ranks:
+		row_bitsets = vector<dense_bitset<W>>(rows.size());
+		for (unsigned int row_ind = 0; row_ind < rows.size(); row_ind++) {
+			Roaring row_target = rows[row_ind].explained & target;
+			for (Roaring::const_iterator it = row_target.begin(); it != row_target.end(); it++) {
+				row_bitsets[row_ind].add(column_ranks.at(*it));
+			}
+		}
+	}
+	/**
+	 * Default destructor.
+	 */
+	virtual ~dense_set_cover_kernel() {
+
+	}
+	/**
+	 * Given a bitmap representing a set of rows,
+	 * returns a boolean value indicating if that set of rows constitutes a feasible set cover solution.
+	 */
+	bool is_feasible(const Roaring & solution_rows) const {
+		dense_bitset<W> row_union = dense_bitset<W>();
+		for (Roaring::const_iterator it = solution_rows.begin(); it != solution_rows.end(); it++) {
+			row_union |= row_bitsets[*it];
+			if (target_bitset.is_subset(row_union)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	/**
+	 * Given the index of the first row in a contiguous block of rows, the number of rows in the block, and the costs of all rows,
+	 * populates the given vectors with the coverage and cost of every subset of the block, indexed by the bitmask of the subset.
+	 * Each subset's coverage and cost are obtained from those of the subset without its highest row.
+	 */
+	void get_subset_coverage(unsigned int first_row, unsigned int n_rows, const vector<float> & costs, vector<dense_bitset<W>> & subset_coverage, vector<float> & subset_costs) const {
+		subset_coverage = vector<dense_bitset<W>>(size_t(1) << n_rows);
+		subset_costs = vector<float>(size_t(1) << n_rows, 0);
+		for (unsigned int i = 0; i < n_rows; i++) {
+			unsigned int bit = 1u << i;
+			for (unsigned int mask = 0; mask < bit; mask++) {
+				subset_coverage[mask | bit] = subset_coverage[mask];
+				subset_coverage[mask | bit] |= row_bitsets[first_row + i];
+				subset_costs[mask | bit] = subset_costs[mask] + costs[first_row + i];
+			}
+		}
+	}
+	/**
+	 * Given the coverage of two sets of rows, returns true if their union covers the target set.
+	 */
+	bool covers_target(const dense_bitset<W> & coverage_1, const dense_bitset<W> & coverage_2) const {
+		dense_bitset<W> row_union = coverage_1;
+		row_union |= coverage_2;
+		return target_bitset.is_subset(row_union);
+	}
+	/**
+	 * Given a bitmap representing a feasible set of rows, returns true if no row can be removed from it without making it infeasible.
+	 */
+	bool is_irredundant(const Roaring & solution_rows) const {
+		for (Roaring::const_iterator it = solution_rows.begin(); it != solution_rows.end(); it++) {
+			Roaring reduced_rows = solution_rows - Roaring::bitmapOf(1, *it);
+			if (is_feasible(reduced_rows)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	/**
+	 * Given the costs of the rows (which are assumed to number at most MEET_IN_THE_MIDDLE_MAX_ROWS),
+	 * populates the given list with bitmaps of all irredundant set cover solutions whose costs are within rounding error of the minimum cost.
+	 * The rows are split into two halves, and the coverage and cost of every subset of each half are enumerated;
+	 * then each subset of the first half is paired with the cheapest subsets of the second half that complete its coverage.
+	 * Since costs are not summed in row order here, callers should recompute the exact costs of the solutions returned.
+	 */
+	void get_cheapest_irredundant_covers(const vector<float> & costs, list<Roaring> & covers) const {
+		covers = list<Roaring>();
+		unsigned int n_rows = (unsigned int) row_bitsets.size();
+		unsigned int n_left = n_rows / 2;
+		unsigned int n_right = n_rows - n_left;
+		vector<dense_bitset<W>> left_coverage;
+		vector<float> left_costs;
+		get_subset_coverage(0, n_left, costs, left_coverage, left_costs);
+		vector<dense_bitset<W>> right_coverage;
+		vector<float> right_costs;
+		get_subset_coverage(n_left, n_right, costs, right_coverage, right_costs);
+		//Sort the subsets of the right half by cost, so that the search for each left subset's complement can stop early:
+		vector<unsigned int> right_order = vector<unsigned int>(right_costs.size());
+		iota(right_order.begin(), right_order.end(), 0);
+		stable_sort(right_order.begin(), right_order.end(), [&](unsigned int m1, unsigned int m2) {
+			return right_costs[m1] < right_costs[m2];
+		});
+		//First, find the minimum cost of any solution:
+		float min_cost = numeric_limits<float>::infinity();
+		for (unsigned int left_mask = 0; left_mask < left_costs.size(); left_mask++) {
+			for (unsigned int right_mask : right_order) {
+				float cost = left_costs[left_mask] + right_costs[right_mask];
+				if (cost >= min_cost) {
+					break;
+				}
+				if (covers_target(left_coverage[left_mask], right_coverage[right_mask])) {
+					min_cost = cost;
+					break;
+				}
+			}
+		}
+		//If there is no solution, then we're done:
+		if (min_cost == numeric_limits<float>::infinity()) {
+			return;
+		}
+		//Then collect every irredundant solution whose cost is within rounding error of the minimum:
+		float slack = (fabs(min_cost) + 1) * n_rows * numeric_limits<float>::epsilon();
+		for (unsigned int left_mask = 0; left_mask < left_costs.size(); left_mask++) {
+			for (unsigned int right_mask : right_order) {
+				float cost = left_costs[left_mask] + right_costs[right_mask];
+				if (cost > min_cost + slack) {
+					break;
+				}
+				if (!covers_target(left_coverage[left_mask], right_coverage[right_mask])) {
+					continue;
+				}
+				Roaring solution_rows = Roaring();
+				for (unsigned int i = 0; i < n_left; i++) {
+					if (left_mask & (1u << i)) {
+						solution_rows.add(i);
+					}
+				}
+				for (unsigned int i = 0; i < n_right; i++) {
+					if (right_mask & (1u << i)) {
+						solution_rows.add(n_left + i);
+					}
+				}
+				if (is_irredundant(solution_rows)) {
+					covers.push_back(solution_rows);
+				}
+			}
+		}
+	}
+};
+
 /**
  * Default constructor.
  */
@@ -54,6 +255,100 @@ set_cover_solver::~set_cover_solver() {
 
 }
 
+/**
+ * Builds the column-major view of this solver's rows used for column branching,
+ * which maps each target column (in order) to a bitmap of the rows that cover it.
+ * It is built the first time the solver branches on a column, rather than when the solver is constructed,
+ * so that solvers that never branch on columns do not pay for it; subsequent calls do nothing.
+ */
+void set_cover_solver::build_column_index() {
+	if (column_index_built) {
+		return;
+	}
+	column_index_built = true;
+	column_rows = vector<Roaring>(target.cardinality());
+	unordered_map<unsigned int, unsigned int> column_ranks = unordered_map<unsigned int, unsigned int>();
+	unsigned int rank = 0;
+	for (Roaring::const_iterator it = target.begin(); it != target.end(); it++) {
+		column_ranks[*it] = rank;
+		rank++;
+	}
+	for (unsigned int row_ind = 0; row_ind < rows.size(); row_ind++) {
+		Roaring row_target = rows[row_ind].explained & target;
+		for (Roaring::const_iterator it = row_target.begin(); it != row_target.end(); it++) {
+			column_rows[column_ranks.at(*it)].add(row_ind);
+		}
+	}
+	return;
+}
+
+/**
+ * Builds the row-major view of this solver's rows used by remove_redundant_rows_from_solution and the per-column counts of column branching,
+ * which maps each row to the ranks of the target columns it covers, in order.
+ * It is built the first time it is needed, rather than when the solver is constructed; subsequent calls do nothing.
+ * Since it is built from const methods, a solver should not be shared between threads.
+ */
+void set_cover_solver::build_row_index() const {
+	if (row_index_built) {
+		return;
+	}
+	row_index_built = true;
+	row_columns = vector<vector<unsigned int>>(rows.size());
+	for (unsigned int row_ind = 0; row_ind < rows.size(); row_ind++) {
+		Roaring row_target = rows[row_ind].explained & target;
+		for (Roaring::const_iterator it = row_target.begin(); it != row_target.end(); it++) {
+			//The rank of a column in the target is the number of target columns less than or equal to it:
+			row_columns[row_ind].push_back((unsigned int) target.rank(*it) - 1);
+		}
+	}
+	coverage_counts = vector<unsigned int>(target.cardinality(), 0);
+	return;
+}
+
+/**
+ * Chooses a feasibility kernel for this solver based on the size of its target set.
+ * If the target set fits in a dense bitset of at most 64 words (i.e., 4096 columns),
+ * then a dense kernel of the smallest sufficient power-of-two width is used;
+ * otherwise, no kernel is set, and feasibility is checked directly using Roaring bitmaps.
+ * The kernel is built when this solver starts searching, rather than when it is constructed,
+ * so that solvers that never search (e.g., one whose problem is reduced to a subproblem solved by another solver) do not pay for it;
+ * subsequent calls do nothing. Until then, feasibility is checked directly using Roaring bitmaps.
+ */
+void set_cover_solver::build_kernel() {
+	if (kernel_built) {
+		return;
+	}
+	kernel_built = true;
+	kernel = shared_ptr<const set_cover_kernel>();
+	uint64_t n_columns = target.cardinality();
+	if (n_columns == 0) {
+		return;
+	}
+	uint64_t n_words = (n_columns + 63) / 64;
+	if (n_words <= 1) {
+		kernel = make_shared<dense_set_cover_kernel<1>>(rows, target);
+	}
+	else if (n_words <= 2) {
+		kernel = make_shared<dense_set_cover_kernel<2>>(rows, target);
+	}
+	else if (n_words <= 4) {
+		kernel = make_shared<dense_set_cover_kernel<4>>(rows, target);
+	}
+	else if (n_words <= 8) {
+		kernel = make_shared<dense_set_cover_kernel<8>>(rows, target);
+	}
+	else if (n_words <= 16) {
+		kernel = make_shared<dense_set_cover_kernel<16>>(rows, target);
+	}
+	else if (n_words <= 32) {
+		kernel = make_shared<dense_set_cover_kernel<32>>(rows, target);
+	}
+	else if (n_words <= 64) {
+		kernel = make_shared<dense_set_cover_kernel<64>>(rows, target);
+	}
+	return;
+}
+
 /**
  * Given a bitmap representing a set of rows in a solution,
  * returns a set cover solution data structure containing those rows.
@@ -148,11 +443,15 @@ Roaring set_cover_solver::get_unique_rows() const {
  * returns a boolean value indicating if that set of rows constitutes a feasible set cover solution.
  */
 bool set_cover_solver::is_feasible(const Roaring & solution_rows) const {
-	//Check if the target set is covered by the accepted rows:
+	//If there is a dense kernel for this problem, then defer to it:
+	if (kernel) {
+		return kernel->is_feasible(solution_rows);
+	}
+	//Otherwise, check if the target set is covered by the accepted rows:
 	Roaring row_union = Roaring();
 	for (Roaring::const_iterator it = solution_rows.begin(); it != solution_rows.end(); it++) {
 		unsigned int row_ind = *it;
-		set_cover_row row = rows[row_ind];
+		const set_cover_row & row = rows[row_ind];
 		row_union |= row.explained;
 		if (target.isSubset(row_union)) {
 			return true;
@@ -164,59 +463,155 @@ bool set_cover_solver::is_feasible(const Roaring & solution_rows) const {
 /**
  * Given a bitmap representing the rows included in a solution,
  * does a backwards pass through the solution rows and removes any that are not necessary to the solution's feasibility.
+ * If the given rows do not constitute a feasible solution, then they are left unchanged.
  */
 void set_cover_solver::remove_redundant_rows_from_solution(Roaring & solution_rows) const {
+	if (solution_rows.isEmpty() || target.isEmpty() || !is_feasible(solution_rows)) {
+		return;
+	}
+	//Count how many solution rows cover each target column, so that redundancy can be checked without recomputing unions:
+	build_row_index();
+	for (Roaring::const_iterator it = solution_rows.begin(); it != solution_rows.end(); it++) {
+		for (unsigned int col_rank : row_columns[*it]) {
+			coverage_counts[col_rank]++;
+		}
+	}
 	//Loop backwards through the set of solution row indices to remove the highest-cost redundant columns:
 	Roaring unprocessed_rows = Roaring(solution_rows);
 	while (!unprocessed_rows.isEmpty()) {
 		//Get the highest-index (i.e., highest-cost) unprocessed row:
 		unsigned int row_ind = unprocessed_rows.maximum();
-		set_cover_row row = rows[row_ind];
-		//Remove the row and check if it is redundant (i.e., if the reduced solution set without it is feasible):
-		solution_rows.remove(row_ind);
-		if (!is_feasible(solution_rows)) {
-			//If it isn't redundant, then add it back to the reduced row set:
-			solution_rows.add(row_ind);
+		const vector<unsigned int> & row_col_ranks = row_columns[row_ind];
+		//The row is redundant if every target column it covers is also covered by another solution row:
+		bool redundant = true;
+		for (unsigned int col_rank : row_col_ranks) {
+			if (coverage_counts[col_rank] < 2) {
+				redundant = false;
+				break;
+			}
+		}
+		//If it is, then remove it from the solution and update the coverage counts:
+		if (redundant) {
+			solution_rows.remove(row_ind);
+			for (unsigned int col_rank : row_col_ranks) {
+				coverage_counts[col_rank]--;
+			}
 		}
 		//Pop this row from the back of the unprocessed set:
 		unprocessed_rows.remove(row_ind);
 	}
+	//Clear the counts of the remaining rows, so that the buffer can be reused on the next call:
+	for (Roaring::const_iterator it = solution_rows.begin(); it != solution_rows.end(); it++) {
+		for (unsigned int col_rank : row_columns[*it]) {
+			coverage_counts[col_rank] = 0;
+		}
+	}
 	return;
 }
 
 /**
- * Returns the bitmap representing the set cover solution found by the basic greedy heuristic.
+ * Given a bitmap representing a partial solution and a bitmap of rows that should not be added to it,
+ * adds rows to the partial solution using the basic greedy heuristic until the target is covered or no more rows can be added.
+ * Rows are chosen by lowest cost-to-coverage proportion (or density), with ties broken in favor of lower-index rows.
+ * Since the density of a row can only increase as more columns are covered, densities are evaluated lazily:
+ * candidate rows are kept in a priority queue keyed by possibly stale densities,
+ * and only the row at the top of the queue has its density recomputed at each step.
  */
-Roaring set_cover_solver::get_greedy_solution() const {
-	Roaring greedy_solution_rows = Roaring();
+void set_cover_solver::add_greedy_rows_to_solution(Roaring & solution_rows, const Roaring & excluded_rows) const {
+	//Get the target columns not yet covered by the partial solution:
 	Roaring uncovered = Roaring(target);
-	//Until the target is completely covered, choose the row with the lowest cost-to-coverage proportion:
-	while (!uncovered.isEmpty()) {
-		float best_density = numeric_limits<float>::infinity();
-		unsigned int best_row_ind = 0;
-		unsigned int row_ind = 0;
-		for (set_cover_row row : rows) {
-			float cost = row.cost;
-			float coverage = float((uncovered & row.explained).cardinality());
-			//Skip if there is no coverage:
-			if (coverage == 0) {
-				row_ind++;
+	for (Roaring::const_iterator it = solution_rows.begin(); it != solution_rows.end(); it++) {
+		uncovered -= rows[*it].explained;
+	}
+	//Initialize a min-heap of candidate rows keyed by their densities and indices:
+	typedef pair<float, unsigned int> density_row_pair;
+	priority_queue<density_row_pair, vector<density_row_pair>, greater<density_row_pair>> candidates = priority_queue<density_row_pair, vector<density_row_pair>, greater<density_row_pair>>();
+	for (unsigned int row_ind = 0; row_ind < rows.size(); row_ind++) {
+		if (solution_rows.contains(row_ind) || excluded_rows.contains(row_ind)) {
+			continue;
+		}
+		const set_cover_row & row = rows[row_ind];
+		float coverage = float(uncovered.and_cardinality(row.explained));
+		//Skip if there is no coverage:
+		if (coverage == 0) {
+			continue;
+		}
+		candidates.push(density_row_pair(row.cost / coverage, row_ind));
+	}
+	//Until the target is completely covered, choose the row with the lowest density:
+	while (!uncovered.isEmpty() && !candidates.empty()) {
+		density_row_pair candidate = candidates.top();
+		candidates.pop();
+		unsigned int row_ind = candidate.second;
+		const set_cover_row & row = rows[row_ind];
+		//Recompute the density of this row:
+		float coverage = float(uncovered.and_cardinality(row.explained));
+		if (coverage == 0) {
+			continue;
+		}
+		candidate.first = row.cost / coverage;
+		//If its updated density is no longer better than the stale density of the next candidate, then put it back in the queue:
+		if (!candidates.empty() && candidates.top() < candidate) {
+			candidates.push(candidate);
+			continue;
+		}
+		//Otherwise, no other row can do better, so add this row to the solution, and remove its overlap with the target set from the target set:
+		solution_rows.add(row_ind);
+		uncovered -= row.explained;
+	}
+	return;
+}
+
+/**
+ * Given a bitmap representing a feasible solution, attempts to lower its cost by local search.
+ * For each row in the solution (starting with the highest-cost row), the row is dropped,
+ * the resulting gap is re-covered greedily using rows outside of the solution, and any redundant rows are removed.
+ * Whenever this yields a cheaper solution, it replaces the current one, and the search starts over;
+ * the search ends when no single row can be swapped out for a cheaper alternative.
+ */
+void set_cover_solver::improve_solution_by_local_search(Roaring & solution_rows) const {
+	float cost = bound(solution_rows);
+	bool improved = true;
+	while (improved) {
+		improved = false;
+		Roaring unprocessed_rows = Roaring(solution_rows);
+		while (!unprocessed_rows.isEmpty()) {
+			unsigned int row_ind = unprocessed_rows.maximum();
+			unprocessed_rows.remove(row_ind);
+			//Drop this row and re-cover the columns it leaves uncovered without using it:
+			Roaring candidate_rows = Roaring(solution_rows);
+			candidate_rows.remove(row_ind);
+			add_greedy_rows_to_solution(candidate_rows, Roaring::bitmapOf(1, row_ind));
+			if (!is_feasible(candidate_rows)) {
 				continue;
 			}
-			float density = cost / coverage;
-			if (density < best_density && !greedy_solution_rows.contains(row_ind)) {
-				best_density = density;
-				best_row_ind = row_ind;
+			remove_redundant_rows_from_solution(candidate_rows);
+			float candidate_cost = bound(candidate_rows);
+			if (candidate_cost < cost) {
+				solution_rows = candidate_rows;
+				cost = candidate_cost;
+				improved = true;
+				break;
 			}
-			row_ind++;
 		}
-		//Add the best-found row to the initial solution, and remove its overlap with the target set from the target set:
-		greedy_solution_rows.add(best_row_ind);
-		set_cover_row best_row = rows[best_row_ind];
-		uncovered ^= uncovered & best_row.explained;
 	}
+	return;
+}
+
+/**
+ * Returns the bitmap representing the set cover solution found by the basic greedy heuristic.
+ * If the local search flag is set, then the greedy solution is further improved by local search,
+ * which yields a tighter initial upper bound at some additional cost.
+ */
+Roaring set_cover_solver::get_greedy_solution(bool local_search) const {
+	Roaring greedy_solution_rows = Roaring();
+	add_greedy_rows_to_solution(greedy_solution_rows, Roaring());
 	//Now remove any redundant columns from this solution:
 	remove_redundant_rows_from_solution(greedy_solution_rows);
+	//Then improve it further if specified:
+	if (local_search) {
+		improve_solution_by_local_search(greedy_solution_rows);
+	}
 	return greedy_solution_rows;
 }
 
@@ -225,6 +620,8 @@ Roaring set_cover_solver::get_greedy_solution() const {
  * adds the a candidate solution node for the next row to the stack.
  */
 void set_cover_solver::branch(const Roaring & remaining, stack<branch_and_bound_node> & nodes) {
+	//Build the feasibility kernel, if this is the first step of the search:
+	build_kernel();
 	//If there are no remaining rows, then do nothing:
 	if (remaining.isEmpty()) {
 		return;
@@ -239,6 +636,107 @@ void set_cover_solver::branch(const Roaring & remaining, stack<branch_and_bound_
 	return;
 }
 
+/**
+ * Given bitmaps representing the rows accepted into the current candidate solution and the rows remaining to be processed,
+ * recounts, for each target column, how many accepted rows and how many remaining rows cover it.
+ * Branch-and-bound searches that branch on columns call this once and then keep the counts current with update_column_counts.
+ */
+void set_cover_solver::reset_column_counts(const Roaring & accepted, const Roaring & remaining) {
+	//Build the row and column indices, if this is the first time branching on a column:
+	build_row_index();
+	build_column_index();
+	column_accepted_counts = vector<unsigned int>(column_rows.size(), 0);
+	column_remaining_counts = vector<unsigned int>(column_rows.size(), 0);
+	for (Roaring::const_iterator it = accepted.begin(); it != accepted.end(); it++) {
+		for (unsigned int col_rank : row_columns[*it]) {
+			column_accepted_counts[col_rank]++;
+		}
+	}
+	for (Roaring::const_iterator it = remaining.begin(); it != remaining.end(); it++) {
+		for (unsigned int col_rank : row_columns[*it]) {
+			column_remaining_counts[col_rank]++;
+		}
+	}
+	return;
+}
+
+/**
+ * Given the row of a branch-and-bound node and the state it is being processed in,
+ * updates the per-column counts of accepted and remaining rows for the row's move between the sets:
+ * an accepted row moves from the remaining rows to the accepted rows, a rejected row leaves the accepted rows,
+ * and a row whose node is done returns to the remaining rows.
+ */
+void set_cover_solver::update_column_counts(unsigned int row, node_state state) {
+	for (unsigned int col_rank : row_columns[row]) {
+		if (state == node_state::ACCEPT) {
+			column_remaining_counts[col_rank]--;
+			column_accepted_counts[col_rank]++;
+		}
+		else if (state == node_state::REJECT) {
+			column_accepted_counts[col_rank]--;
+		}
+		else {
+			column_remaining_counts[col_rank]++;
+		}
+	}
+	return;
+}
+
+/**
+ * Given a bitmap representing the rows remaining to be processed and a stack of branch-and-bound nodes,
+ * adds a candidate solution node for a row that covers the most constrained uncovered column
+ * (i.e., the uncovered target column covered by the fewest remaining rows), as counted by the current per-column counts.
+ * Ties are broken in favor of lower-index columns, and among the rows covering the chosen column, the lowest-cost row is chosen.
+ * If some uncovered column cannot be covered by any remaining row, then no solution lies under the current node, and no node is added.
+ */
+void set_cover_solver::branch_on_counted_column(const Roaring & remaining, stack<branch_and_bound_node> & nodes) {
+	unsigned int min_coverage = numeric_limits<unsigned int>::max();
+	unsigned int min_col_ind = 0;
+	for (unsigned int col_ind = 0; col_ind < column_rows.size(); col_ind++) {
+		//Skip this column if it is already covered:
+		if (column_accepted_counts[col_ind] > 0) {
+			continue;
+		}
+		unsigned int coverage = column_remaining_counts[col_ind];
+		if (coverage < min_coverage) {
+			min_coverage = coverage;
+			min_col_ind = col_ind;
+			//If no remaining rows cover this column, then this subtree is infeasible, and we're done:
+			if (coverage == 0) {
+				return;
+			}
+		}
+	}
+	//If every column is covered, then there is nothing to branch on:
+	if (min_coverage == numeric_limits<unsigned int>::max()) {
+		return;
+	}
+	//Otherwise, add a node for the first remaining row covering the chosen column:
+	const Roaring & covering_rows = column_rows[min_col_ind];
+	for (Roaring::const_iterator it = covering_rows.begin(); it != covering_rows.end(); it++) {
+		if (remaining.contains(*it)) {
+			branch_and_bound_node node;
+			node.row = *it;
+			node.state = node_state::ACCEPT;
+			nodes.push(node);
+			break;
+		}
+	}
+	return;
+}
+
+/**
+ * Given bitmaps representing the rows accepted into the current candidate solution and the rows remaining to be processed
+ * and a stack of branch-and-bound nodes, adds a candidate solution node for a row that covers the most constrained uncovered column,
+ * as described for branch_on_counted_column.
+ * The per-column counts are recomputed from the given bitmaps, so this is meant for single calls outside of a search.
+ */
+void set_cover_solver::branch_on_column(const Roaring & accepted, const Roaring & remaining, stack<branch_and_bound_node> & nodes) {
+	reset_column_counts(accepted, remaining);
+	branch_on_counted_column(remaining, nodes);
+	return;
+}
+
 /**
  * Given a bitmap of solution rows,
  * returns a lower bound on the cost of any solution that contains those rows.
@@ -259,6 +757,8 @@ float set_cover_solver::bound(const Roaring & solution_rows) const {
  * If the set cover solver was constructed with a fixed upper bound, then this method will enumerate all solutions with costs within that bound.
  */
 void set_cover_solver::branch_and_bound(list<set_cover_solution> & solutions) {
+	//Build the feasibility kernel, if it has not been built yet:
+	build_kernel();
 	//Initialize a map of solution row set bitmaps, keyed by their serializations:
 	unordered_map<string, Roaring> distinct_row_sets = unordered_map<string, Roaring>();
 	//Initialize bitmaps representing rows included in the current solution and rows to be processed:
@@ -267,21 +767,37 @@ void set_cover_solver::branch_and_bound(list<set_cover_solution> & solutions) {
 	remaining.addRange(0, rows.size());
 	//Initialize a stack of branch-and-bound nodes:
 	stack<branch_and_bound_node> nodes = stack<branch_and_bound_node>();
-	//If no fixed upper bound is specified, then obtain a good initial upper bound quickly using the greedy solution:
+	//If no fixed upper bound is specified, then obtain a good initial upper bound quickly using the greedy solution
+	//(since every minimum-cost solution will be found regardless, local search can be used to tighten this bound further):
 	float ub = fixed_ub;
 	bool is_ub_fixed = fixed_ub < numeric_limits<float>::infinity();
 	if (!is_ub_fixed) {
-		Roaring greedy_solution_rows = get_greedy_solution();
+		chrono::steady_clock::time_point greedy_start = chrono::steady_clock::now();
+		Roaring greedy_solution_rows = get_greedy_solution(true);
 		ub = bound(greedy_solution_rows);
+		stats.greedy_bound = ub;
+		stats.greedy_time += seconds_since(greedy_start);
+	}
+	//Initialize the stack of branch and bound nodes with the first node
+	//(if we're just looking for minimum-cost solutions, then we can branch on the most constrained column,
+	//but otherwise, we must branch on rows in order so that redundant solutions are enumerated as well):
+	if (is_ub_fixed) {
+		branch(remaining, nodes);
+	}
+	else {
+		reset_column_counts(accepted, remaining);
+		branch_on_counted_column(remaining, nodes);
 	}
-	//Initialize the stack of branch and bound nodes with the first node:
-	branch(remaining, nodes);
 	//Then continue with branch and bound until there is nothing left to be processed:
 	while (!nodes.empty()) {
 		//Get the current node from the stack:
 		branch_and_bound_node & node = nodes.top();
 		//Adjust the set partitions to reflect the candidate solution representing by the current node:
 		unsigned int row = node.row;
+		//Keep the per-column counts in step with the set partitions if we're branching on columns:
+		if (!is_ub_fixed) {
+			update_column_counts(row, node.state);
+		}
 		if (node.state == node_state::ACCEPT) {
 			//Add the candidate row to the solution:
 			remaining.remove(row);
@@ -301,6 +817,7 @@ void set_cover_solver::branch_and_bound(list<set_cover_solution> & solutions) {
 			nodes.pop();
 			continue;
 		}
+		stats.nodes_expanded++;
 		//Check if current set of accepted rows represents a feasible solution:
 		if (is_feasible(accepted)) {
 			//If it does, then calculate the cost of the solution:
@@ -332,8 +849,19 @@ void set_cover_solver::branch_and_bound(list<set_cover_solution> & solutions) {
 			float lb = bound(accepted);
 			//If this lower bound is within the upper bound, then branch on this node:
 			if (lb <= ub) {
-				branch(remaining, nodes);
+				if (is_ub_fixed) {
+					branch(remaining, nodes);
+				}
+				else {
+					branch_on_counted_column(remaining, nodes);
+				}
 			}
+			else {
+				stats.nodes_pruned_by_bound++;
+			}
+		}
+		else {
+			stats.nodes_pruned_by_infeasibility++;
 		}
 	}
 	//For each distinct set of solution rows, add a set cover solution data structure to the solutions list:
@@ -346,34 +874,37 @@ void set_cover_solver::branch_and_bound(list<set_cover_solution> & solutions) {
 }
 
 /**
- * Populates a list of set cover solutions via branch and bound, under the assumption that only a single lowest-cost solution is needed.
- * Any fixed upper bound for the solver will be ignored.
- * This is an optimization intended to be used for global stemma construction, where only one solution is used even if there are multiple of equal cost.
+ * Searches for a set cover solution with cost strictly below the given upper bound via branch and bound.
+ * Every time a solution cheaper than the current upper bound is found, it is stored in the given bitmap, and the upper bound is lowered to its cost.
+ * If the flag for column branching is set, then the search branches on the rows covering the most constrained uncovered column;
+ * otherwise, it branches on rows in order of increasing cost.
+ * Returns the final upper bound (i.e., the cost of the last solution found, or the initial upper bound if none was found).
  */
-void set_cover_solver::branch_and_bound_single_solution(list<set_cover_solution> & solutions) {
-	//Initialize a map of solution row set bitmaps, keyed by their serializations:
-	unordered_map<string, Roaring> distinct_row_sets = unordered_map<string, Roaring>();
+float set_cover_solver::branch_and_bound_single_solution_search(Roaring & solution_rows, float ub, bool column_branching) {
 	//Initialize bitmaps representing rows included in the current solution and rows to be processed:
 	Roaring accepted = Roaring();
 	Roaring remaining = Roaring();
 	remaining.addRange(0, rows.size());
 	//Initialize a stack of branch-and-bound nodes:
 	stack<branch_and_bound_node> nodes = stack<branch_and_bound_node>();
-	//Obtain a good initial upper bound quickly using the greedy solution:
-	float ub = numeric_limits<float>::infinity();
-	Roaring greedy_solution_rows = get_greedy_solution();
-	ub = bound(greedy_solution_rows);
-	//Add the solution row bitmap to the solution set:
-	string serialized = greedy_solution_rows.toString();
-	distinct_row_sets[serialized] = greedy_solution_rows;
 	//Initialize the stack of branch and bound nodes with the first node:
-	branch(remaining, nodes);
+	if (column_branching) {
+		reset_column_counts(accepted, remaining);
+		branch_on_counted_column(remaining, nodes);
+	}
+	else {
+		branch(remaining, nodes);
+	}
 	//Then continue with branch and bound until there is nothing left to be processed:
 	while (!nodes.empty()) {
 		//Get the current node from the stack:
 		branch_and_bound_node & node = nodes.top();
 		//Adjust the set partitions to reflect the candidate solution representing by the current node:
 		unsigned int row = node.row;
+		//Keep the per-column counts in step with the set partitions if we're branching on columns:
+		if (column_branching) {
+			update_column_counts(row, node.state);
+		}
 		if (node.state == node_state::ACCEPT) {
 			//Add the candidate row to the solution:
 			remaining.remove(row);
@@ -393,21 +924,23 @@ void set_cover_solver::branch_and_bound_single_solution(list<set_cover_solution>
 			nodes.pop();
 			continue;
 		}
+		stats.nodes_expanded++;
 		//Check if current set of accepted rows represents a feasible solution:
 		if (is_feasible(accepted)) {
 			//If it does, then calculate the cost of the solution:
-			Roaring solution_rows = Roaring(accepted);
+			Roaring candidate_rows = Roaring(accepted);
 			//Remove redundant rows:
-			remove_redundant_rows_from_solution(solution_rows);
-			float cost = bound(solution_rows);
+			remove_redundant_rows_from_solution(candidate_rows);
+			float cost = bound(candidate_rows);
 			//Check if this cost is strictly below the current upper bound:
 			if (cost < ub) {
-				//If it is, then update the upper bound and solution set:
+				//If it is, then update the upper bound and solution:
 				ub = cost;
-				distinct_row_sets = unordered_map<string, Roaring>();
-				//Then add the solution row bitmap to the solution set:
-				string serialized = solution_rows.toString();
-				distinct_row_sets[serialized] = solution_rows;
+				solution_rows = candidate_rows;
+			}
+			//Under column branching, every row added past this point would be redundant, so there is no need to branch further:
+			if (column_branching) {
+				continue;
 			}
 		}
 		//Check if there is any feasible solution under the current node:
@@ -416,163 +949,629 @@ void set_cover_solver::branch_and_bound_single_solution(list<set_cover_solution>
 			float lb = bound(accepted);
 			//If this lower bound is strictly below the upper bound, then branch on this node:
 			if (lb < ub) {
-				branch(remaining, nodes);
+				if (column_branching) {
+					branch_on_counted_column(remaining, nodes);
+				}
+				else {
+					branch(remaining, nodes);
+				}
+			}
+			else {
+				stats.nodes_pruned_by_bound++;
 			}
 		}
+		else {
+			stats.nodes_pruned_by_infeasibility++;
+		}
 	}
-	//For each distinct set of solution rows, add a set cover solution data structure to the solutions list:
-	for (pair<string, Roaring> kv : distinct_row_sets) {
-		Roaring solution_rows = kv.second;
-		set_cover_solution solution = get_solution_from_rows(solution_rows);
-		solutions.push_back(solution);
+	return ub;
+}
+
+/**
+ * Populates a list of set cover solutions via branch and bound, under the assumption that only a single lowest-cost solution is needed.
+ * Any fixed upper bound for the solver will be ignored.
+ * This is an optimization intended to be used for global stemma construction, where only one solution is used even if there are multiple of equal cost.
+ * Optionally, an initial upper bound can be specified, in which case only solutions with costs strictly below it will be considered,
+ * and the greedy solution will not be computed.
+ * Alternatively, the cost of a known feasible solution (e.g., the previous optimum of a problem that has since changed) can be specified as a warm-start bound;
+ * this prunes the search for the minimum cost without changing which solution is returned.
+ */
+void set_cover_solver::branch_and_bound_single_solution(list<set_cover_solution> & solutions, float initial_ub, float warm_start_ub) {
+	//Build the feasibility kernel, if it has not been built yet:
+	build_kernel();
+	Roaring solution_rows = Roaring();
+	bool found = false;
+	float ub = initial_ub;
+	if (ub == numeric_limits<float>::infinity()) {
+		//If no initial upper bound is specified, then obtain a good one quickly using the greedy solution
+		//(local search is not used here, since the greedy solution is kept unless a strictly cheaper solution is found,
+		//and the solution returned should not depend on how the initial bound was obtained):
+		chrono::steady_clock::time_point greedy_start = chrono::steady_clock::now();
+		solution_rows = get_greedy_solution();
+		ub = bound(solution_rows);
+		found = true;
+		stats.greedy_bound = ub;
+		stats.greedy_time += seconds_since(greedy_start);
+		//Then find the minimum cost quickly using column branching,
+		//pruning with the warm-start bound instead if it is tighter (a solution at that cost is known to exist, so the bound is just above it):
+		float search_ub = warm_start_ub < ub ? nextafter(warm_start_ub, numeric_limits<float>::infinity()) : ub;
+		Roaring min_cost_rows = Roaring();
+		float min_cost = branch_and_bound_single_solution_search(min_cost_rows, search_ub, true);
+		//If it does not improve on the greedy solution, then the greedy solution is the one to return:
+		if (min_cost == search_ub || min_cost == ub) {
+			solutions.push_back(get_solution_from_rows(solution_rows));
+			return;
+		}
+		//Otherwise, the solution returned should be the first minimum-cost solution found when branching in row order,
+		//so prune that search with an upper bound just above the minimum cost:
+		ub = nextafter(min_cost, numeric_limits<float>::infinity());
+	}
+	if (branch_and_bound_single_solution_search(solution_rows, ub, false) < ub) {
+		found = true;
+	}
+	//If a solution was found, then add a set cover solution data structure for it to the solutions list:
+	if (found) {
+		solutions.push_back(get_solution_from_rows(solution_rows));
 	}
 	return;
 }
 
 /**
- * Populates the given solution list with solutions to the set cover problem.
- * If the set cover solver was constructed with a fixed upper bound, then this method will enumerate all solutions with costs within that bound.
- * If the flag for single solutions is set (which should happen for the construction of the global stemma), 
- * then the fixed upper bound is ignored, and a slightly more optimized version of the branch and bound procedure is used.
+ * Populates a list of set cover solutions using the meet-in-the-middle backend of this solver's dense kernel.
+ * This is an exact alternative to branch and bound for problems with few rows, and it yields the same solutions:
+ * all irredundant minimum-cost solutions, or, if the flag for single solutions is set, the same single solution that branch_and_bound_single_solution would return
+ * (which is found by pruning branch and bound against the minimum cost found here).
+ * Any fixed upper bound for the solver will be ignored.
+ * Returns false without doing anything if this problem has too many rows or columns for the backend; otherwise, returns true.
  */
-void set_cover_solver::solve(list<set_cover_solution> & solutions, bool single_solution) {
+bool set_cover_solver::meet_in_the_middle(list<set_cover_solution> & solutions, bool single_solution) {
+	//Build the feasibility kernel, if it has not been built yet:
+	build_kernel();
+	if (!kernel || rows.empty() || rows.size() > MEET_IN_THE_MIDDLE_MAX_ROWS) {
+		return false;
+	}
 	solutions = list<set_cover_solution>();
-	//If the single solution flag is set, the set the fixed upper bound to infinity:
-	if (single_solution) {
-		fixed_ub = std::numeric_limits<float>::infinity();
+	vector<float> costs = vector<float>();
+	for (const set_cover_row & row : rows) {
+		costs.push_back(row.cost);
 	}
-	//Create a map of row IDs to their indices:
-	unordered_map<string, unsigned int> row_ids_to_inds = unordered_map<string, unsigned int>();
-	unsigned int row_ind = 0;
-	for (set_cover_row row : rows) {
-		string row_id = row.id;
-		row_ids_to_inds[row_id] = row_ind;
-		row_ind++;
+	list<Roaring> covers = list<Roaring>();
+	kernel->get_cheapest_irredundant_covers(costs, covers);
+	//If there are no solutions, then we're done:
+	if (covers.empty()) {
+		return true;
+	}
+	//Otherwise, recompute the costs of the solutions exactly, and get the minimum cost:
+	float min_cost = numeric_limits<float>::infinity();
+	for (const Roaring & cover : covers) {
+		float cost = bound(cover);
+		if (cost < min_cost) {
+			min_cost = cost;
+		}
+	}
+	if (!single_solution) {
+		for (const Roaring & cover : covers) {
+			if (bound(cover) == min_cost) {
+				solutions.push_back(get_solution_from_rows(cover));
+			}
+		}
+		return true;
+	}
+	//If only a single solution is needed, then the greedy solution is returned if it has the minimum cost:
+	chrono::steady_clock::time_point greedy_start = chrono::steady_clock::now();
+	Roaring greedy_solution_rows = get_greedy_solution();
+	stats.greedy_bound = bound(greedy_solution_rows);
+	stats.greedy_time += seconds_since(greedy_start);
+	if (stats.greedy_bound <= min_cost) {
+		solutions.push_back(get_solution_from_rows(greedy_solution_rows));
+		return true;
+	}
+	//Otherwise, branch and bound would return the first minimum-cost solution it finds,
+	//so run it with an upper bound just above the minimum cost to prune everything else:
+	branch_and_bound_single_solution(solutions, nextafter(min_cost, numeric_limits<float>::infinity()));
+	return true;
+}
+
+/**
+ * Returns true if the first set cover solution should be ordered before the second.
+ * Solutions are ordered first by cost, then by cardinality, then by number of agreements,
+ * and then lexicographically by the indices of their rows in the given map.
+ */
+bool set_cover_solution_precedes(const set_cover_solution & s1, const set_cover_solution & s2, const unordered_map<string, unsigned int> & row_ids_to_inds) {
+	//Sort first by cost:
+	if (s1.cost < s2.cost) {
+		return true;
+	}
+	else if (s1.cost > s2.cost) {
+		return false;
+	}
+	//Then sort by cardinality:
+	if (s1.rows.size() < s2.rows.size()) {
+		return true;
+	}
+	else if (s1.rows.size() > s2.rows.size()) {
+		return false;
 	}
-	//If any column cannot be covered by the rows provided, then we're done:
+	//Then sort by number of agreements:
+	if (s1.agreements > s2.agreements) {
+		return true;
+	}
+	else if (s1.agreements < s2.agreements) {
+		return false;
+	}
+	//Then sort lexicographically by the indices of the rows in the solutions:
+	Roaring rs1 = Roaring();
+	for (const set_cover_row & row : s1.rows) {
+		rs1.add(row_ids_to_inds.at(row.id));
+	}
+	Roaring rs2 = Roaring();
+	for (const set_cover_row & row : s2.rows) {
+		rs2.add(row_ids_to_inds.at(row.id));
+	}
+	while (!rs1.isEmpty()) {
+		unsigned int rs1_min = rs1.minimum();
+		unsigned int rs2_min = rs2.minimum();
+		if (rs1_min < rs2_min) {
+			return true;
+		}
+		else if (rs1_min > rs2_min) {
+			return false;
+		}
+		rs1.remove(rs1_min);
+		rs2.remove(rs2_min);
+	}
+	return false;
+}
+
+/**
+ * Reduces this set cover problem to an easier subproblem by setting aside the rows that uniquely cover one or more columns.
+ * The given containers are populated with the bitmap of unique coverage rows, the indices of the rows that remain in the subproblem,
+ * the bitmap of target columns left to cover, and the upper bound on the cost of the subproblem.
+ * Returns false if the problem has no solution (i.e., if some column cannot be covered
+ * or if the unique coverage rows alone exceed the upper bound); otherwise, returns true.
+ */
+bool set_cover_solver::get_subproblem(Roaring & unique_rows, vector<unsigned int> & subproblem_row_inds, Roaring & subproblem_target, float & subproblem_ub) const {
+	//If any column cannot be covered by the rows provided, then there is no solution:
 	if (!get_uncovered_columns().isEmpty()) {
-		return;
+		return false;
 	}
 	//If any rows uniquely cover one or more columns, then those rows must be set aside to be included in the solution:
-	Roaring unique_rows = get_unique_rows();
+	unique_rows = get_unique_rows();
 	//Reduce the current problem to an easier subproblem by removing all columns covered by the unique coverage rows from the target set:
-	Roaring subproblem_target = Roaring(target);
-	float subproblem_ub = fixed_ub;
+	subproblem_target = Roaring(target);
+	subproblem_ub = fixed_ub;
 	for (Roaring::const_iterator it = unique_rows.begin(); it != unique_rows.end(); it++) {
 		unsigned int row_ind = *it;
-		set_cover_row row = rows[row_ind];
+		const set_cover_row & row = rows[row_ind];
 		subproblem_target ^= subproblem_target & row.explained;
 		subproblem_ub -= row.cost;
 	}
 	//If the total cost of the unique coverage rows exceeds the upper bound, then there is no solution:
 	if (subproblem_ub < 0) {
-		return;
-	}
-	//If no columns need to be covered anymore, then the unique coverage rows constitute a feasible solution:
-	if (subproblem_target.isEmpty()) {
-		set_cover_solution solution = get_solution_from_rows(unique_rows);
-		solutions.push_back(solution);
-		//If we're just looking for a minimum-cost solution, then this is the unique lowest-cost solution, and we're done:
-		if (fixed_ub == numeric_limits<float>::infinity()) {
-			return;
-		}
+		return false;
 	}
-	//Otherwise, solve the subproblem using branch-and-bound:
-	vector<set_cover_row> subproblem_rows = vector<set_cover_row>();
+	subproblem_row_inds = vector<unsigned int>();
 	for (unsigned int row_ind = 0; row_ind < rows.size(); row_ind++) {
 		//Exclude all rows that uniquely cover one or more columns (and therefore must already be included in the solution of the original problem):
 		if (unique_rows.contains(row_ind)) {
 			continue;
 		}
-		set_cover_row row = rows[row_ind];
+		const set_cover_row & row = rows[row_ind];
 		//If the row has a cost that exceeds the upper bound of the subproblem, then exclude it:
 		if (row.cost > subproblem_ub) {
 			continue;
 		}
 		//If we're just looking for a minimum-cost solution,
 		//then exclude any rows that have no overlap with the remaining target set:
-		if (fixed_ub == numeric_limits<float>::infinity() && (row.explained & target).cardinality() == 0) {
+		if (fixed_ub == numeric_limits<float>::infinity() && row.explained.and_cardinality(target) == 0) {
 			continue;
 		}
-		subproblem_rows.push_back(row);
+		subproblem_row_inds.push_back(row_ind);
 	}
-	list<set_cover_solution> subproblem_solutions = list<set_cover_solution>();
-	set_cover_solver subproblem_solver = fixed_ub != numeric_limits<float>::infinity() ? set_cover_solver(subproblem_rows, subproblem_target, subproblem_ub) : set_cover_solver(subproblem_rows, subproblem_target);
+	return true;
+}
+
+/**
+ * Populates the given solution list with solutions to the set cover problem.
+ * If the set cover solver was constructed with a fixed upper bound, then this method will enumerate all solutions with costs within that bound.
+ * If the flag for single solutions is set (which should happen for the construction of the global stemma), 
+ * then the fixed upper bound is ignored, and a slightly more optimized version of the branch and bound procedure is used.
+ * In that case, a bitmap of rows forming a known solution (e.g., the previous optimum of a problem that has since changed) can also be specified;
+ * if these rows still constitute a feasible solution, then their cost is used to warm-start the branch and bound procedure.
+ */
+void set_cover_solver::solve(list<set_cover_solution> & solutions, bool single_solution, const Roaring & warm_start_rows) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	stats = set_cover_solver_stats();
+	stats.rows = (unsigned int) rows.size();
+	solutions = list<set_cover_solution>();
+	//If the single solution flag is set, the set the fixed upper bound to infinity:
 	if (single_solution) {
-		subproblem_solver.branch_and_bound_single_solution(subproblem_solutions);
-	} else {
-		subproblem_solver.branch_and_bound(subproblem_solutions);
+		fixed_ub = std::numeric_limits<float>::infinity();
+	}
+	//Create a map of row IDs to their indices:
+	unordered_map<string, unsigned int> row_ids_to_inds = unordered_map<string, unsigned int>();
+	unsigned int row_ind = 0;
+	for (const set_cover_row & row : rows) {
+		row_ids_to_inds[row.id] = row_ind;
+		row_ind++;
 	}
-	//Then add the unique coverage rows found earlier to the subproblem solutions:
-	set_cover_solution unique_rows_solution = get_solution_from_rows(unique_rows);
-	for (set_cover_solution subproblem_solution : subproblem_solutions) {
+	//If there is a fixed upper bound, then every solution within it is drawn from a lazy enumerator,
+	//which yields each distinct solution exactly once and therefore does not need to keep track of the solutions it has already found
+	//(the solutions are still collected here, since this method returns them sorted; callers that do not need them sorted can use the enumerator directly):
+	if (fixed_ub != numeric_limits<float>::infinity()) {
+		set_cover_solution_enumerator enumerator = set_cover_solution_enumerator(rows, target, fixed_ub);
 		set_cover_solution solution;
-		solution.rows = list<set_cover_row>();
-		Roaring row_set = Roaring();
-		for (set_cover_row row : subproblem_solution.rows) {
-			row_set.add(row_ids_to_inds.at(row.id));
+		while (enumerator.next(solution)) {
+			solutions.push_back(solution);
 		}
-		for (set_cover_row row : unique_rows_solution.rows) {
-			row_set.add(row_ids_to_inds.at(row.id));
+		//The enumerator keeps track of its own statistics:
+		stats = enumerator.get_stats();
+		stats.search_time = seconds_since(start) - stats.reduction_time;
+	}
+	else {
+		//Otherwise, reduce the problem to a subproblem, if there is a solution at all:
+		Roaring unique_rows = Roaring();
+		vector<unsigned int> subproblem_row_inds = vector<unsigned int>();
+		Roaring subproblem_target = Roaring();
+		float subproblem_ub = fixed_ub;
+		bool has_subproblem = get_subproblem(unique_rows, subproblem_row_inds, subproblem_target, subproblem_ub);
+		stats.unique_rows = (unsigned int) unique_rows.cardinality();
+		stats.subproblem_rows = (unsigned int) subproblem_row_inds.size();
+		stats.reduction_time = seconds_since(start);
+		if (!has_subproblem) {
+			stats.total_time = seconds_since(start);
+			return;
 		}
-		for (Roaring::const_iterator it = row_set.begin(); it != row_set.end(); it++) {
-			unsigned int row_ind = *it;
-			set_cover_row row = rows[row_ind];
-			solution.rows.push_back(row);
+		//If no columns need to be covered anymore, then the unique coverage rows constitute the unique lowest-cost solution, and we're done:
+		if (subproblem_target.isEmpty()) {
+			set_cover_solution solution = get_solution_from_rows(unique_rows);
+			solutions.push_back(solution);
+			stats.solutions_found = 1;
+			stats.total_time = seconds_since(start);
+			return;
 		}
-		solution.cost = subproblem_solution.cost + unique_rows_solution.cost;
-		Roaring agreements = Roaring();
-		for (set_cover_row row : solution.rows) {
-			agreements |= row.agreements;
+		//Otherwise, solve the subproblem using branch-and-bound:
+		vector<set_cover_row> subproblem_rows = vector<set_cover_row>();
+		for (unsigned int subproblem_row_ind : subproblem_row_inds) {
+			subproblem_rows.push_back(rows[subproblem_row_ind]);
+		}
+		list<set_cover_solution> subproblem_solutions = list<set_cover_solution>();
+		set_cover_solver subproblem_solver = set_cover_solver(subproblem_rows, subproblem_target);
+		//If the subproblem is small enough, then solve it exactly using meet-in-the-middle enumeration;
+		//otherwise, fall back on branch-and-bound:
+		chrono::steady_clock::time_point search_start = chrono::steady_clock::now();
+		if (subproblem_solver.meet_in_the_middle(subproblem_solutions, single_solution)) {
+			stats.backend = "meet_in_the_middle";
+		}
+		else {
+			stats.backend = "branch_and_bound";
+			if (single_solution) {
+				//If the warm-start rows are a feasible solution, then the ones left in the subproblem are a feasible solution to it,
+				//since the rows set aside belong to every solution:
+				float warm_start_ub = numeric_limits<float>::infinity();
+				if (!warm_start_rows.isEmpty() && is_feasible(warm_start_rows)) {
+					Roaring subproblem_warm_start_rows = Roaring();
+					for (unsigned int i = 0; i < subproblem_row_inds.size(); i++) {
+						if (warm_start_rows.contains(subproblem_row_inds[i])) {
+							subproblem_warm_start_rows.add(i);
+						}
+					}
+					warm_start_ub = subproblem_solver.bound(subproblem_warm_start_rows);
+				}
+				subproblem_solver.branch_and_bound_single_solution(subproblem_solutions, numeric_limits<float>::infinity(), warm_start_ub);
+			} else {
+				subproblem_solver.branch_and_bound(subproblem_solutions);
+			}
+		}
+		//Copy the search statistics from the subproblem solver, adjusting the greedy bound to include the unique coverage rows:
+		set_cover_solver_stats subproblem_stats = subproblem_solver.get_stats();
+		if (subproblem_stats.greedy_bound != numeric_limits<float>::infinity()) {
+			stats.greedy_bound = subproblem_stats.greedy_bound + bound(unique_rows);
+		}
+		stats.greedy_time = subproblem_stats.greedy_time;
+		stats.nodes_expanded = subproblem_stats.nodes_expanded;
+		stats.nodes_pruned_by_bound = subproblem_stats.nodes_pruned_by_bound;
+		stats.nodes_pruned_by_infeasibility = subproblem_stats.nodes_pruned_by_infeasibility;
+		stats.search_time = seconds_since(search_start) - stats.greedy_time;
+		//Then add the unique coverage rows found earlier to the subproblem solutions:
+		set_cover_solution unique_rows_solution = get_solution_from_rows(unique_rows);
+		for (set_cover_solution subproblem_solution : subproblem_solutions) {
+			set_cover_solution solution;
+			solution.rows = list<set_cover_row>();
+			Roaring row_set = Roaring();
+			for (set_cover_row row : subproblem_solution.rows) {
+				row_set.add(row_ids_to_inds.at(row.id));
+			}
+			for (set_cover_row row : unique_rows_solution.rows) {
+				row_set.add(row_ids_to_inds.at(row.id));
+			}
+			for (Roaring::const_iterator it = row_set.begin(); it != row_set.end(); it++) {
+				unsigned int row_ind = *it;
+				set_cover_row row = rows[row_ind];
+				solution.rows.push_back(row);
+			}
+			solution.cost = subproblem_solution.cost + unique_rows_solution.cost;
+			Roaring agreements = Roaring();
+			for (set_cover_row row : solution.rows) {
+				agreements |= row.agreements;
+			}
+			solution.agreements = (int) agreements.cardinality();
+			solutions.push_back(solution);
 		}
-		solution.agreements = (int) agreements.cardinality();
-		solutions.push_back(solution);
 	}
 	//Then sort the solutions:
 	solutions.sort([&](const set_cover_solution & s1, const set_cover_solution & s2) {
-		//Sort first by cost:
-		if (s1.cost < s2.cost) {
-			return true;
+		return set_cover_solution_precedes(s1, s2, row_ids_to_inds);
+	});
+	stats.solutions_found = solutions.size();
+	stats.total_time = seconds_since(start);
+	return;
+}
+
+/**
+ * Populates the given solution list with at most the given number of lowest-cost solutions within the fixed upper bound (if there is one),
+ * sorted in the same order as the solutions returned by solve().
+ * Solutions are streamed from a lazy enumerator through a bounded heap,
+ * so memory use is proportional to the number of solutions requested rather than the number of solutions within the bound.
+ * Once the heap is full, the enumerator's upper bound is tightened to the cost of the worst solution in the heap,
+ * so the search never explores branches that could not produce one of the requested solutions.
+ * As in solve(), if there is no fixed upper bound, then rows that do not cover any target columns are disregarded.
+ */
+void set_cover_solver::solve_cheapest(list<set_cover_solution> & solutions, unsigned int max_solutions) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	stats = set_cover_solver_stats();
+	stats.rows = (unsigned int) rows.size();
+	solutions = list<set_cover_solution>();
+	if (max_solutions == 0) {
+		return;
+	}
+	//Create a map of row IDs to their indices:
+	unordered_map<string, unsigned int> row_ids_to_inds = unordered_map<string, unsigned int>();
+	unsigned int row_ind = 0;
+	for (const set_cover_row & row : rows) {
+		row_ids_to_inds[row.id] = row_ind;
+		row_ind++;
+	}
+	//Maintain a max-heap of the best solutions found so far, so that the worst of them is always on top:
+	auto compare = [&](const set_cover_solution & s1, const set_cover_solution & s2) {
+		return set_cover_solution_precedes(s1, s2, row_ids_to_inds);
+	};
+	priority_queue<set_cover_solution, vector<set_cover_solution>, decltype(compare)> heap = priority_queue<set_cover_solution, vector<set_cover_solution>, decltype(compare)>(compare);
+	set_cover_solution_enumerator enumerator = set_cover_solution_enumerator(rows, target, fixed_ub);
+	set_cover_solution solution;
+	while (enumerator.next(solution)) {
+		//If the heap is full and this solution does not improve on the worst solution in it, then skip it:
+		if (heap.size() == max_solutions) {
+			if (!compare(solution, heap.top())) {
+				continue;
+			}
+			heap.pop();
 		}
-		else if (s1.cost > s2.cost) {
-			return false;
+		heap.push(solution);
+		//If the heap is full, then no solution costing more than the worst solution in it can be accepted anymore,
+		//so we can prune the remaining search accordingly:
+		if (heap.size() == max_solutions) {
+			enumerator.tighten_upper_bound(heap.top().cost);
 		}
-		//Then sort by cardinality:
-		if (s1.rows.size() < s2.rows.size()) {
+	}
+	//Then pop the solutions off of the heap from worst to best:
+	while (!heap.empty()) {
+		solutions.push_front(heap.top());
+		heap.pop();
+	}
+	stats = enumerator.get_stats();
+	stats.search_time = seconds_since(start) - stats.reduction_time;
+	stats.solutions_found = solutions.size();
+	stats.total_time = seconds_since(start);
+	return;
+}
+
+/**
+ * Returns the statistics collected during the last call to solve or solve_cheapest.
+ */
+set_cover_solver_stats set_cover_solver::get_stats() const {
+	return stats;
+}
+
+/**
+ * Given a JSON writer, writes the statistics collected during the last call to solve or solve_cheapest to it as a JSON object.
+ * JSON has no representation for infinity, so an unused greedy bound is written as null.
+ */
+void set_cover_solver::stats_to_json(json_writer & writer) const {
+	writer.begin_object();
+	writer.key("backend");
+	writer.value(stats.backend);
+	writer.key("rows");
+	writer.value(stats.rows);
+	writer.key("unique_rows");
+	writer.value(stats.unique_rows);
+	writer.key("subproblem_rows");
+	writer.value(stats.subproblem_rows);
+	writer.key("greedy_bound");
+	writer.value(stats.greedy_bound);
+	writer.key("nodes_expanded");
+	writer.value(stats.nodes_expanded);
+	writer.key("nodes_pruned_by_bound");
+	writer.value(stats.nodes_pruned_by_bound);
+	writer.key("nodes_pruned_by_infeasibility");
+	writer.value(stats.nodes_pruned_by_infeasibility);
+	writer.key("solutions_found");
+	writer.value(stats.solutions_found);
+	writer.key("reduction_time");
+	writer.value(stats.reduction_time);
+	writer.key("greedy_time");
+	writer.value(stats.greedy_time);
+	writer.key("search_time");
+	writer.value(stats.search_time);
+	writer.key("total_time");
+	writer.value(stats.total_time);
+	writer.end_object();
+	return;
+}
+
+/**
+ * Prints the statistics collected during the last call to solve or solve_cheapest to the given output stream as a JSON object.
+ */
+void set_cover_solver::stats_to_json(ostream & out) const {
+	json_writer writer(out);
+	stats_to_json(writer);
+	return;
+}
+
+/**
+ * Default constructor.
+ */
+set_cover_solution_enumerator::set_cover_solution_enumerator() {
+
+}
+
+/**
+ * Constructs a lazy enumerator of set cover solutions given a vector of row data structures (assumed to be sorted by ascending costs),
+ * a bitmap representing the target set to cover, and a fixed upper bound on solution costs.
+ */
+set_cover_solution_enumerator::set_cover_solution_enumerator(const vector<set_cover_row> & _rows, const Roaring & _target, float _fixed_ub) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	solver = set_cover_solver(_rows, _target, _fixed_ub);
+	//The fixed upper bound is applied only through the subproblem's upper bound,
+	//so that costs rounding onto it are accepted exactly as in branch_and_bound:
+	stats.rows = (unsigned int) _rows.size();
+	stats.backend = "enumerator";
+	//Reduce the problem to a subproblem, if there is a solution at all:
+	Roaring subproblem_target = Roaring();
+	bool has_subproblem = solver.get_subproblem(unique_rows, subproblem_row_inds, subproblem_target, subproblem_ub);
+	stats.unique_rows = (unsigned int) unique_rows.cardinality();
+	stats.subproblem_rows = (unsigned int) subproblem_row_inds.size();
+	stats.reduction_time = seconds_since(start);
+	if (!has_subproblem) {
+		return;
+	}
+	unique_rows_cost = solver.bound(unique_rows);
+	vector<set_cover_row> subproblem_rows = vector<set_cover_row>();
+	for (unsigned int row_ind : subproblem_row_inds) {
+		subproblem_rows.push_back(_rows[row_ind]);
+	}
+	subproblem_solver = set_cover_solver(subproblem_rows, subproblem_target, subproblem_ub);
+	//If no columns need to be covered anymore, then the unique coverage rows constitute the first solution:
+	unique_rows_pending = subproblem_target.isEmpty();
+	//Initialize the branch-and-bound state with the first node:
+	accepted = Roaring();
+	remaining = Roaring();
+	remaining.addRange(0, subproblem_rows.size());
+	nodes = stack<branch_and_bound_node>();
+	subproblem_solver.branch(remaining, nodes);
+}
+
+/**
+ * Default destructor.
+ */
+set_cover_solution_enumerator::~set_cover_solution_enumerator() {
+
+}
+
+/**
+ * Given a bitmap of solution rows in the subproblem,
+ * returns a set cover solution data structure for the original problem containing those rows and the unique coverage rows.
+ */
+set_cover_solution set_cover_solution_enumerator::get_solution_from_subproblem_rows(const Roaring & solution_rows) const {
+	Roaring row_set = Roaring(unique_rows);
+	for (Roaring::const_iterator it = solution_rows.begin(); it != solution_rows.end(); it++) {
+		row_set.add(subproblem_row_inds[*it]);
+	}
+	set_cover_solution solution = solver.get_solution_from_rows(row_set);
+	solution.cost = subproblem_solver.bound(solution_rows) + unique_rows_cost;
+	return solution;
+}
+
+/**
+ * Returns true if the given rows of the subproblem have a cost within the subproblem's upper bound
+ * and, together with the unique coverage rows, have a total cost within the current upper bound,
+ * which is unbounded unless it has been tightened.
+ */
+bool set_cover_solution_enumerator::within_bound(const Roaring & solution_rows) const {
+	float subproblem_cost = subproblem_solver.bound(solution_rows);
+	return subproblem_cost <= subproblem_ub && subproblem_cost + unique_rows_cost <= ub;
+}
+
+/**
+ * Lowers the upper bound on the costs of the remaining solutions to be enumerated to the given value.
+ * If the given value is not lower than the current upper bound, then nothing changes.
+ */
+void set_cover_solution_enumerator::tighten_upper_bound(float _ub) {
+	if (_ub < ub) {
+		ub = _ub;
+	}
+	return;
+}
+
+/**
+ * Advances the enumeration to the next set cover solution within the fixed upper bound.
+ * If there is one, then the given solution data structure is populated with it, and true is returned;
+ * otherwise, false is returned.
+ */
+bool set_cover_solution_enumerator::next(set_cover_solution & solution) {
+	//If the unique coverage rows alone constitute a solution, then yield them first:
+	if (unique_rows_pending) {
+		unique_rows_pending = false;
+		if (unique_rows_cost <= ub) {
+			solution = get_solution_from_subproblem_rows(Roaring());
+			stats.solutions_found++;
 			return true;
 		}
-		else if (s1.rows.size() > s2.rows.size()) {
-			return false;
+	}
+	//Otherwise, resume branch and bound from where we left off:
+	while (!nodes.empty()) {
+		//Get the current node from the stack:
+		branch_and_bound_node & node = nodes.top();
+		//Adjust the set partitions to reflect the candidate solution representing by the current node:
+		unsigned int row = node.row;
+		bool found = false;
+		if (node.state == node_state::ACCEPT) {
+			//Add the candidate row to the solution:
+			remaining.remove(row);
+			accepted.add(row);
+			//Update its state:
+			node.state = node_state::REJECT;
+			//Every set of rows is accepted at exactly one node, so solutions are only checked for here
+			//(rejecting a row restores a set of accepted rows that has already been checked):
+			found = subproblem_solver.is_feasible(accepted) && within_bound(accepted);
 		}
-		//Then sort by number of agreements:
-		if (s1.agreements > s2.agreements) {
-			return true;
+		else if (node.state == node_state::REJECT) {
+			//Exclude the candidate row from the solution:
+			accepted.remove(row);
+			//Update its state:
+			node.state = node_state::DONE;
 		}
-		else if (s1.agreements < s2.agreements) {
-			return false;
+		else {
+			//We're done processing this node, and we can add its row back to the set of available rows:
+			remaining.add(row);
+			nodes.pop();
+			continue;
 		}
-		//Then sort lexicographically by the indices of the rows in the solutions:
-		Roaring rs1 = Roaring();
-		for (set_cover_row row : s1.rows) {
-			rs1.add(row_ids_to_inds.at(row.id));
+		stats.nodes_expanded++;
+		//Check if there is any feasible solution under the current node,
+		//and if the lower bound on the cost of any such solution is within the upper bound, then branch on this node:
+		if (!subproblem_solver.is_feasible(accepted | remaining)) {
+			stats.nodes_pruned_by_infeasibility++;
 		}
-		Roaring rs2 = Roaring();
-		for (set_cover_row row : s2.rows) {
-			rs2.add(row_ids_to_inds.at(row.id));
+		else if (!within_bound(accepted)) {
+			stats.nodes_pruned_by_bound++;
 		}
-		while (!rs1.isEmpty()) {
-			unsigned int rs1_min = rs1.minimum();
-			unsigned int rs2_min = rs2.minimum();
-			if (rs1_min < rs2_min) {
-				return true;
-			}
-			else if (rs1_min > rs2_min) {
-				return false;
-			}
-			rs1.remove(rs1_min);
-			rs2.remove(rs2_min);
+		else {
+			subproblem_solver.branch(remaining, nodes);
 		}
-		return false;
-	});
-	return;
+		//If the accepted rows constitute a solution, then yield it:
+		if (found) {
+			solution = get_solution_from_subproblem_rows(accepted);
+			stats.solutions_found++;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Returns the statistics collected by this enumerator so far.
+ */
+set_cover_solver_stats set_cover_solution_enumerator::get_stats() const {
+	return stats;
 }
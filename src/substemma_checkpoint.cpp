@@ -0,0 +1,256 @@
+/*
+ * substemma_checkpoint.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <list>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <limits>
+#include <cstdlib>
+#include <cstdint>
+#include <stdexcept>
+
+#include "apparatus.h"
+#include "variation_unit.h"
+#include "local_stemma.h"
+#include "set_cover_solver.h"
+#include "substemma_checkpoint.h"
+
+using namespace std;
+
+//Header line prefix identifying a checkpoint file and its format version:
+const string SUBSTEMMA_CHECKPOINT_HEADER = "open-cbgm substemma checkpoint 1";
+//Number of tab-separated fields in each line for a solved witness:
+const unsigned int SUBSTEMMA_CHECKPOINT_FIELDS = 15;
+
+/**
+ * Constructs a checkpoint backed by the file at the given path, for runs with the given apparatus and options key.
+ * If the file exists with a complete header, then the witnesses already solved in it are loaded, and new entries are appended to it;
+ * otherwise, it is created (or overwritten, if its header was cut off) with a header line containing the key.
+ * Incomplete lines (e.g., those left by a run that was killed while writing) are skipped.
+ * Throws a runtime_error if the file was written for a different key or cannot be opened.
+ */
+substemma_checkpoint::substemma_checkpoint(const string & _path, const string & _key) {
+	path = _path;
+	key = _key;
+	entries = unordered_map<string, substemma_checkpoint_entry>();
+	bool has_header = false;
+	bool ends_with_newline = true;
+	ifstream in(path);
+	if (in.is_open()) {
+		string line;
+		bool first_line = true;
+		while (getline(in, line)) {
+			//A line that was cut off before its newline is ignored:
+			ends_with_newline = !in.eof();
+			if (!ends_with_newline) {
+				break;
+			}
+			//The first line must be the header for this key:
+			if (first_line) {
+				first_line = false;
+				if (line != SUBSTEMMA_CHECKPOINT_HEADER + " " + key) {
+					throw runtime_error("The checkpoint file " + path + " was written for a different apparatus or options.");
+				}
+				has_header = true;
+				continue;
+			}
+			//Split the line into its fields, and skip it if it is malformed:
+			vector<string> fields = vector<string>();
+			stringstream ss(line);
+			string field;
+			while (getline(ss, field, '\t')) {
+				fields.push_back(field);
+			}
+			if (!line.empty() && line.back() == '\t') {
+				fields.push_back("");
+			}
+			if (fields.size() != SUBSTEMMA_CHECKPOINT_FIELDS || fields[0].empty()) {
+				continue;
+			}
+			substemma_checkpoint_entry entry;
+			entry.wit_id = fields[0];
+			entry.stemmatic_ancestor_ids = list<string>();
+			stringstream ancestors_ss(fields[1]);
+			string ancestor_id;
+			while (ancestors_ss >> ancestor_id) {
+				entry.stemmatic_ancestor_ids.push_back(ancestor_id);
+			}
+			entry.stats.backend = fields[2];
+			entry.stats.rows = (unsigned int) strtoul(fields[3].c_str(), nullptr, 10);
+			entry.stats.unique_rows = (unsigned int) strtoul(fields[4].c_str(), nullptr, 10);
+			entry.stats.subproblem_rows = (unsigned int) strtoul(fields[5].c_str(), nullptr, 10);
+			entry.stats.greedy_bound = strtof(fields[6].c_str(), nullptr);
+			entry.stats.nodes_expanded = strtoull(fields[7].c_str(), nullptr, 10);
+			entry.stats.nodes_pruned_by_bound = strtoull(fields[8].c_str(), nullptr, 10);
+			entry.stats.nodes_pruned_by_infeasibility = strtoull(fields[9].c_str(), nullptr, 10);
+			entry.stats.solutions_found = strtoull(fields[10].c_str(), nullptr, 10);
+			entry.stats.reduction_time = strtod(fields[11].c_str(), nullptr);
+			entry.stats.greedy_time = strtod(fields[12].c_str(), nullptr);
+			entry.stats.search_time = strtod(fields[13].c_str(), nullptr);
+			entry.stats.total_time = strtod(fields[14].c_str(), nullptr);
+			//If a witness appears more than once, then its last entry is the one kept:
+			entries[entry.wit_id] = entry;
+		}
+		in.close();
+	}
+	//If the file has a complete header, then open it for appending, ending any line that was cut off so that the next entry starts on a line of its own:
+	if (has_header) {
+		out.open(path, ios::out | ios::app);
+		if (out.is_open() && !ends_with_newline) {
+			out << "\n";
+		}
+	}
+	//Otherwise, the file is new (or was killed before its header was complete), so (re)create it with a header:
+	else {
+		out.open(path, ios::out | ios::trunc);
+		if (out.is_open()) {
+			out << SUBSTEMMA_CHECKPOINT_HEADER << " " << key << "\n";
+		}
+	}
+	if (!out.is_open()) {
+		throw runtime_error("The checkpoint file " + path + " could not be opened for writing.");
+	}
+	out.flush();
+}
+
+/**
+ * Default destructor.
+ */
+substemma_checkpoint::~substemma_checkpoint() {
+
+}
+
+/**
+ * Returns a key identifying the given apparatus and options for substemma optimization runs,
+ * so that a checkpoint written for one run is not resumed by a run with different inputs.
+ * The key is a 64-bit FNV-1a hash (in hexadecimal) of the witness list, the readings, reading support, and local stemmata of the variation units,
+ * and the flag indicating whether the "classic" calculation of costs and explained readings is used.
+ */
+string substemma_checkpoint::get_key(const apparatus & app, bool classic) {
+	uint64_t hash = 14695981039346656037ULL;
+	//Each field is hashed with its terminating null byte, so that adjacent fields cannot run together:
+	auto add_field = [&](const string & field) {
+		for (unsigned int i = 0; i <= field.size(); i++) {
+			hash ^= (unsigned char) field.c_str()[i];
+			hash *= 1099511628211ULL;
+		}
+	};
+	add_field(classic ? "classic" : "open-cbgm");
+	for (const string & wit_id : app.get_list_wit()) {
+		add_field(wit_id);
+	}
+	for (const variation_unit & vu : app.get_variation_units()) {
+		add_field(vu.get_id());
+		for (const string & rdg : vu.get_readings()) {
+			add_field(rdg);
+		}
+		//Sort the reading support by witness, so that the key does not depend on the order of the map:
+		unordered_map<string, string> reading_support = vu.get_reading_support();
+		map<string, string> sorted_reading_support = map<string, string>(reading_support.begin(), reading_support.end());
+		for (const pair<const string, string> & kv : sorted_reading_support) {
+			add_field(kv.first);
+			add_field(kv.second);
+		}
+		local_stemma ls = vu.get_local_stemma();
+		for (const local_stemma_vertex & v : ls.get_vertices()) {
+			add_field(v.id);
+		}
+		for (const local_stemma_edge & e : ls.get_edges()) {
+			stringstream weight_ss;
+			weight_ss << setprecision(numeric_limits<float>::max_digits10) << e.weight;
+			add_field(e.prior);
+			add_field(e.posterior);
+			add_field(weight_ss.str());
+		}
+	}
+	stringstream ss;
+	ss << hex << setw(16) << setfill('0') << hash;
+	return ss.str();
+}
+
+/**
+ * Returns the path of this checkpoint's file.
+ */
+string substemma_checkpoint::get_path() const {
+	return path;
+}
+
+/**
+ * Returns the apparatus and options key of this checkpoint.
+ */
+string substemma_checkpoint::get_key() const {
+	return key;
+}
+
+/**
+ * Returns the number of witnesses solved in this checkpoint.
+ */
+unsigned int substemma_checkpoint::size() const {
+	lock_guard<mutex> lock(entries_mutex);
+	return (unsigned int) entries.size();
+}
+
+/**
+ * Returns a boolean value indicating whether the witness with the given ID has been solved in this checkpoint.
+ */
+bool substemma_checkpoint::contains(const string & wit_id) const {
+	lock_guard<mutex> lock(entries_mutex);
+	return entries.find(wit_id) != entries.end();
+}
+
+/**
+ * Returns the checkpoint entry for the witness with the given ID.
+ */
+substemma_checkpoint_entry substemma_checkpoint::get_entry(const string & wit_id) const {
+	lock_guard<mutex> lock(entries_mutex);
+	return entries.at(wit_id);
+}
+
+/**
+ * Records the given solved witness in this checkpoint, appending a line for it to the checkpoint file and flushing it immediately.
+ * This method is safe to call concurrently from different threads.
+ */
+void substemma_checkpoint::append(const substemma_checkpoint_entry & entry) {
+	//Format the line before taking the lock:
+	stringstream ss;
+	ss << entry.wit_id << "\t";
+	unsigned int ancestor_ind = 0;
+	for (const string & ancestor_id : entry.stemmatic_ancestor_ids) {
+		if (ancestor_ind > 0) {
+			ss << " ";
+		}
+		ss << ancestor_id;
+		ancestor_ind++;
+	}
+	ss << "\t" << entry.stats.backend;
+	ss << "\t" << entry.stats.rows;
+	ss << "\t" << entry.stats.unique_rows;
+	ss << "\t" << entry.stats.subproblem_rows;
+	ss << "\t" << setprecision(numeric_limits<float>::max_digits10) << entry.stats.greedy_bound;
+	ss << "\t" << entry.stats.nodes_expanded;
+	ss << "\t" << entry.stats.nodes_pruned_by_bound;
+	ss << "\t" << entry.stats.nodes_pruned_by_infeasibility;
+	ss << "\t" << entry.stats.solutions_found;
+	ss << setprecision(numeric_limits<double>::max_digits10);
+	ss << "\t" << entry.stats.reduction_time;
+	ss << "\t" << entry.stats.greedy_time;
+	ss << "\t" << entry.stats.search_time;
+	ss << "\t" << entry.stats.total_time;
+	ss << "\n";
+	lock_guard<mutex> lock(entries_mutex);
+	out << ss.str();
+	out.flush();
+	entries[entry.wit_id] = entry;
+	return;
+}
@@ -10,23 +10,27 @@
 #include <string>
 #include <list>
 #include <vector>
-#include <set> //for small sets keyed by readings
-#include <unordered_set> //for large sets keyed by witnesses
 #include <map> //for small maps keyed by readings
 #include <unordered_map> //for large maps keyed by witnesses
 #include <limits>
+#include <algorithm>
 
 #include "textual_flow.h"
 #include "witness.h"
 #include "variation_unit.h"
+#include "json_writer.h"
+#include "dot_writer.h"
 
 using namespace std;
 
+//Color attributes for edges, indexed by flow type (edges of type NONE are not drawn):
+const char * FLOW_TYPE_COLOR_ATTRIBUTES[] = {nullptr, "color=black", "color=blue", "color=gray"};
+
 /**
  * Default constructor.
  */
 textual_flow::textual_flow() {
-
+	arc_offsets = vector<unsigned int>(1, 0);
 }
 
 /**
@@ -41,30 +45,42 @@ textual_flow::textual_flow(const variation_unit & vu, const list<witness> & witn
 	connectivity = _connectivity;
 	//Get the variation unit's local stemma:
 	local_stemma ls = vu.get_local_stemma();
-	//Initialize the vertex and edge lists as empty:
-	vertices = list<textual_flow_vertex>();
-	edges = list<textual_flow_edge>();
 	//Get a copy of the variation unit's reading support map:
 	unordered_map<string, string> reading_support = vu.get_reading_support();
-	//Create a map of witnesses, keyed by ID:
-	unordered_map<string, witness> witnesses_by_id = unordered_map<string, witness>();
-	for (witness wit : witnesses) {
-		witnesses_by_id[wit.get_id()] = wit;
-	}
-	//Add vertices and edges for each witness in the input list:
-	for (witness wit : witnesses) {
-		//Get the witness's ID and its reading at this variation unit:
+	//Index the witnesses and their readings:
+	ids = vector<string>();
+	rdgs = vector<string>();
+	id_rdgs = vector<int>();
+	unordered_map<string, unsigned int> ids_to_inds = unordered_map<string, unsigned int>();
+	map<string, int> rdgs_to_inds = map<string, int>();
+	for (const witness & wit : witnesses) {
+		string wit_id = wit.get_id();
+		ids_to_inds[wit_id] = (unsigned int) ids.size();
+		ids.push_back(wit_id);
+		if (reading_support.find(wit_id) == reading_support.end()) {
+			id_rdgs.push_back(-1);
+			continue;
+		}
+		string wit_rdg = reading_support.at(wit_id);
+		if (rdgs_to_inds.find(wit_rdg) == rdgs_to_inds.end()) {
+			rdgs_to_inds[wit_rdg] = (int) rdgs.size();
+			rdgs.push_back(wit_rdg);
+		}
+		id_rdgs.push_back(rdgs_to_inds.at(wit_rdg));
+	}
+	n_vertices = (unsigned int) ids.size();
+	//Add edges for each witness in the input list:
+	arc_offsets = vector<unsigned int>(1, 0);
+	arcs = vector<textual_flow_arc>();
+	for (const witness & wit : witnesses) {
+		//Get the witness's reading at this variation unit:
 		string wit_id = wit.get_id();
 		string wit_rdg = reading_support.find(wit_id) != reading_support.end() ? reading_support.at(wit_id) : "";
-		//Add a vertex for this witness to the graph:
-		textual_flow_vertex v;
-		v.id = wit_id;
-		v.rdg = wit_rdg;
-		vertices.push_back(v);
 		//If this witness has no potential ancestors (i.e., if it has equal priority to the Ausgangstext),
 		//then there are no edges to add, and we can continue:
 		list<string> potential_ancestor_ids = wit.get_potential_ancestor_ids();
 		if (potential_ancestor_ids.empty()) {
+			arc_offsets.push_back((unsigned int) arcs.size());
 			continue;
 		}
 		//Otherwise, proceed to identify this witness's textual flow ancestor for this variation unit:
@@ -75,7 +91,7 @@ textual_flow::textual_flow(const variation_unit & vu, const list<witness> & witn
 		if (!wit_rdg.empty()) {
 			con = -1;
 			con_value = -1;
-			for (string potential_ancestor_id : potential_ancestor_ids) {
+			for (const string & potential_ancestor_id : potential_ancestor_ids) {
 				//Update the connectivity rank if the connectivity value changes:
 				genealogical_comparison comp = wit.get_genealogical_comparison_for_witness(potential_ancestor_id);
 				int agreements = (int) comp.agreements.cardinality();
@@ -93,16 +109,24 @@ textual_flow::textual_flow(const variation_unit & vu, const list<witness> & witn
 					if (ls.path_exists(potential_ancestor_rdg, wit_rdg) && ls.get_path(potential_ancestor_rdg, wit_rdg).weight == 0) {
 						//Set the flag indicating that we've found a textual_flow_ancestor:
 						textual_flow_ancestor_found = true;
-						//Calculate the stability of the textual flow:
-						float strength = float(comp.posterior.cardinality() - comp.prior.cardinality()) / float(comp.extant.cardinality());
+						//Index the ancestor's ID and reading if it is not one of the witnesses:
+						if (ids_to_inds.find(potential_ancestor_id) == ids_to_inds.end()) {
+							ids_to_inds[potential_ancestor_id] = (unsigned int) ids.size();
+							ids.push_back(potential_ancestor_id);
+							if (rdgs_to_inds.find(potential_ancestor_rdg) == rdgs_to_inds.end()) {
+								rdgs_to_inds[potential_ancestor_rdg] = (int) rdgs.size();
+								rdgs.push_back(potential_ancestor_rdg);
+							}
+							id_rdgs.push_back(rdgs_to_inds.at(potential_ancestor_rdg));
+						}
 						//Add an edge to the graph connecting the textual flow ancestor to this witness:
-						textual_flow_edge e;
-						e.descendant = wit_id;
-						e.ancestor = potential_ancestor_id;
-						e.type = flow_type::EQUAL;
-						e.connectivity = con;
-						e.strength = strength;
-						edges.push_back(e);
+						textual_flow_arc a;
+						a.ancestor = ids_to_inds.at(potential_ancestor_id);
+						a.type = flow_type::EQUAL;
+						a.connectivity = con;
+						//Calculate the stability of the textual flow:
+						a.strength = float(comp.posterior.cardinality() - comp.prior.cardinality()) / float(comp.extant.cardinality());
+						arcs.push_back(a);
 						break;
 					}
 				}
@@ -114,7 +138,7 @@ textual_flow::textual_flow(const variation_unit & vu, const list<witness> & witn
 			con = -1;
 			con_value = -1;
 			list<string> distinct_rdgs = list<string>();
-			for (string potential_ancestor_id : potential_ancestor_ids) {
+			for (const string & potential_ancestor_id : potential_ancestor_ids) {
 				//Update the connectivity rank if the connectivity value changes:
 				genealogical_comparison comp = wit.get_genealogical_comparison_for_witness(potential_ancestor_id);
 				int agreements = (int) comp.agreements.cardinality();
@@ -130,7 +154,7 @@ textual_flow::textual_flow(const variation_unit & vu, const list<witness> & witn
 				if (reading_support.find(potential_ancestor_id) != reading_support.end()) {
 					string potential_ancestor_rdg = reading_support.at(potential_ancestor_id);
 					bool new_rdg = true;
-					for (string rdg : distinct_rdgs) {
+					for (const string & rdg : distinct_rdgs) {
 						if (ls.path_exists(potential_ancestor_rdg, rdg) && ls.get_path(potential_ancestor_rdg, rdg).weight == 0) {
 							new_rdg = false;
 							break;
@@ -138,21 +162,32 @@ textual_flow::textual_flow(const variation_unit & vu, const list<witness> & witn
 					}
 					if (new_rdg) {
 						distinct_rdgs.push_back(potential_ancestor_rdg);
-						//Calculate the stability of the textual flow:
-						float strength = float(comp.posterior.cardinality() - comp.prior.cardinality()) / float(comp.extant.cardinality());
+						//Index the ancestor's ID and reading if it is not one of the witnesses:
+						if (ids_to_inds.find(potential_ancestor_id) == ids_to_inds.end()) {
+							ids_to_inds[potential_ancestor_id] = (unsigned int) ids.size();
+							ids.push_back(potential_ancestor_id);
+							if (rdgs_to_inds.find(potential_ancestor_rdg) == rdgs_to_inds.end()) {
+								rdgs_to_inds[potential_ancestor_rdg] = (int) rdgs.size();
+								rdgs.push_back(potential_ancestor_rdg);
+							}
+							id_rdgs.push_back(rdgs_to_inds.at(potential_ancestor_rdg));
+						}
 						//Add an edge to the graph connecting the textual flow ancestor to this witness:
-						textual_flow_edge e;
-						e.descendant = wit_id;
-						e.ancestor = potential_ancestor_id;
-						e.type = wit_rdg.empty() ? flow_type::LOSS : flow_type::CHANGE;
-						e.connectivity = con;
-						e.strength = strength;
-						edges.push_back(e);
+						textual_flow_arc a;
+						a.ancestor = ids_to_inds.at(potential_ancestor_id);
+						a.type = wit_rdg.empty() ? flow_type::LOSS : flow_type::CHANGE;
+						a.connectivity = con;
+						//Calculate the stability of the textual flow:
+						a.strength = float(comp.posterior.cardinality() - comp.prior.cardinality()) / float(comp.extant.cardinality());
+						arcs.push_back(a);
 					}
 				}
 			}
 		}
+		arc_offsets.push_back((unsigned int) arcs.size());
 	}
+	//No edges end at ancestors that are not witnesses:
+	arc_offsets.resize(ids.size() + 1, (unsigned int) arcs.size());
 }
 
 /**
@@ -162,6 +197,83 @@ textual_flow::textual_flow(const variation_unit & vu, const list<witness> & witn
  */
 textual_flow::textual_flow(const variation_unit & vu, const list<witness> & witnesses) : textual_flow::textual_flow(vu, witnesses, vu.get_connectivity()) {}
 
+/**
+ * Constructs a textual flow instance from its label, readings, connectivity, vertices, and edges.
+ * Edges are grouped by descendant, but edges ending at the same descendant are kept in their original order.
+ */
+textual_flow::textual_flow(const string & _label, const list<string> & _readings, int _connectivity, const list<textual_flow_vertex> & _vertices, const list<textual_flow_edge> & _edges) {
+	label = _label;
+	readings = _readings;
+	connectivity = _connectivity;
+	//Index the vertices and their readings:
+	ids = vector<string>();
+	rdgs = vector<string>();
+	id_rdgs = vector<int>();
+	unordered_map<string, unsigned int> ids_to_inds = unordered_map<string, unsigned int>();
+	map<string, int> rdgs_to_inds = map<string, int>();
+	for (const textual_flow_vertex & v : _vertices) {
+		ids_to_inds[v.id] = (unsigned int) ids.size();
+		ids.push_back(v.id);
+		if (v.rdg.empty()) {
+			id_rdgs.push_back(-1);
+			continue;
+		}
+		if (rdgs_to_inds.find(v.rdg) == rdgs_to_inds.end()) {
+			rdgs_to_inds[v.rdg] = (int) rdgs.size();
+			rdgs.push_back(v.rdg);
+		}
+		id_rdgs.push_back(rdgs_to_inds.at(v.rdg));
+	}
+	n_vertices = (unsigned int) ids.size();
+	//Then index any endpoints of the edges that are not vertices (whose readings are unknown):
+	for (const textual_flow_edge & e : _edges) {
+		for (const string & id : {e.ancestor, e.descendant}) {
+			if (ids_to_inds.find(id) == ids_to_inds.end()) {
+				ids_to_inds[id] = (unsigned int) ids.size();
+				ids.push_back(id);
+				id_rdgs.push_back(-1);
+			}
+		}
+	}
+	//Then count the edges ending at each descendant, and convert the counts to offsets:
+	arc_offsets = vector<unsigned int>(ids.size() + 1, 0);
+	for (const textual_flow_edge & e : _edges) {
+		arc_offsets[ids_to_inds.at(e.descendant) + 1]++;
+	}
+	for (unsigned int i = 0; i < ids.size(); i++) {
+		arc_offsets[i + 1] += arc_offsets[i];
+	}
+	//Then place each edge in the next free slot for its descendant:
+	arcs = vector<textual_flow_arc>(_edges.size());
+	vector<unsigned int> next_slots = vector<unsigned int>(arc_offsets.begin(), arc_offsets.end() - 1);
+	for (const textual_flow_edge & e : _edges) {
+		textual_flow_arc a;
+		a.ancestor = ids_to_inds.at(e.ancestor);
+		a.type = e.type;
+		a.connectivity = e.connectivity;
+		a.strength = e.strength;
+		arcs[next_slots[ids_to_inds.at(e.descendant)]++] = a;
+	}
+}
+
+/**
+ * Constructs a textual flow instance from its label, readings, and connectivity and its graph in index form:
+ * a vector of IDs whose first entries are those of the vertices, the number of vertices,
+ * a vector of readings, the index of the reading of each ID (or -1 if it is lacunose or unknown),
+ * and compressed sparse row offsets and arcs for the edges ending at each ID.
+ */
+textual_flow::textual_flow(const string & _label, const list<string> & _readings, int _connectivity, const vector<string> & _ids, unsigned int _n_vertices, const vector<string> & _rdgs, const vector<int> & _id_rdgs, const vector<unsigned int> & _arc_offsets, const vector<textual_flow_arc> & _arcs) {
+	label = _label;
+	readings = _readings;
+	connectivity = _connectivity;
+	ids = _ids;
+	n_vertices = _n_vertices;
+	rdgs = _rdgs;
+	id_rdgs = _id_rdgs;
+	arc_offsets = _arc_offsets;
+	arcs = _arcs;
+}
+
 /**
  * Default destructor.
  */
@@ -194,122 +306,288 @@ int textual_flow::get_connectivity() const {
  * Returns the this textual_flow's list of vertices.
  */
 list<textual_flow_vertex> textual_flow::get_vertices() const {
+	list<textual_flow_vertex> vertices = list<textual_flow_vertex>();
+	for (unsigned int i = 0; i < n_vertices; i++) {
+		textual_flow_vertex v;
+		v.id = ids[i];
+		v.rdg = id_rdgs[i] >= 0 ? rdgs[id_rdgs[i]] : "";
+		vertices.push_back(v);
+	}
 	return vertices;
 }
 
 /**
- * Returns the this textual_flow's list of edges.
+ * Returns the this textual_flow's list of edges, grouped by descendant.
  */
 list<textual_flow_edge> textual_flow::get_edges() const {
+	list<textual_flow_edge> edges = list<textual_flow_edge>();
+	for (unsigned int i = 0; i < ids.size(); i++) {
+		for (unsigned int j = arc_offsets[i]; j < arc_offsets[i + 1]; j++) {
+			textual_flow_edge e;
+			e.ancestor = ids[arcs[j].ancestor];
+			e.descendant = ids[i];
+			e.type = arcs[j].type;
+			e.connectivity = arcs[j].connectivity;
+			e.strength = arcs[j].strength;
+			edges.push_back(e);
+		}
+	}
 	return edges;
 }
 
 /**
- * Given an output stream, writes a complete textual flow diagram to output in .dot format.
+ * Returns the number of vertices of this textual_flow; the IDs after them are those of ancestors that are not vertices.
+ */
+unsigned int textual_flow::get_n_vertices() const {
+	return n_vertices;
+}
+
+/**
+ * Returns a reference to this textual_flow's vector of distinct readings.
+ * The reference is valid as long as this textual_flow is.
+ */
+const vector<string> & textual_flow::get_rdgs_ref() const {
+	return rdgs;
+}
+
+/**
+ * Returns a reference to this textual_flow's vector of the index of the reading of each ID (or -1 if it is lacunose or unknown),
+ * with the vertices first and any ancestors that are not vertices after them.
+ * The reference is valid as long as this textual_flow is.
+ */
+const vector<int> & textual_flow::get_id_rdgs_ref() const {
+	return id_rdgs;
+}
+
+/**
+ * Returns a reference to this textual_flow's compressed sparse row offsets;
+ * the edges ending at the ID with index i are the arcs from index arc_offsets[i] up to index arc_offsets[i + 1].
+ * The reference is valid as long as this textual_flow is.
+ */
+const vector<unsigned int> & textual_flow::get_arc_offsets_ref() const {
+	return arc_offsets;
+}
+
+/**
+ * Returns a reference to this textual_flow's arcs, grouped by descendant.
+ * The reference is valid as long as this textual_flow is.
+ */
+const vector<textual_flow_arc> & textual_flow::get_arcs_ref() const {
+	return arcs;
+}
+
+/**
+ * Returns the slot of the given reading in a partition of this textual flow diagram by reading:
+ * 0 for the empty reading of lacunose witnesses, one more than the reading's index for a reading of some vertex, and -1 otherwise.
+ */
+int textual_flow::get_rdg_slot(const string & rdg) const {
+	if (rdg.empty()) {
+		return 0;
+	}
+	for (unsigned int i = 0; i < rdgs.size(); i++) {
+		if (rdgs[i] == rdg) {
+			return (int) i + 1;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Partitions the vertices of this textual flow diagram by reading.
+ * The coherence in attestations diagram for a reading consists of the vertices with that reading,
+ * the first edge ending at each of them, and the vertices at the other ends of these edges that do not have that reading;
+ * a single pass over the vertices and edges collects these for every reading at once.
+ */
+textual_flow_partition textual_flow::partition_by_reading() const {
+	textual_flow_partition partition;
+	partition.rdg_vertices = vector<vector<unsigned int>>(rdgs.size() + 1);
+	partition.rdg_descendants = vector<vector<unsigned int>>(rdgs.size() + 1);
+	//Group the vertices by reading, noting the ones with edges ending at them:
+	for (unsigned int i = 0; i < n_vertices; i++) {
+		unsigned int slot = (unsigned int) (id_rdgs[i] + 1);
+		partition.rdg_vertices[slot].push_back(i);
+		if (arc_offsets[i + 1] > arc_offsets[i]) {
+			partition.rdg_descendants[slot].push_back(i);
+		}
+	}
+	//Then add the ancestors on each reading's first edges that do not have that reading or are not vertices, in their original order:
+	for (unsigned int slot = 0; slot < partition.rdg_descendants.size(); slot++) {
+		vector<unsigned int> ancestors_without_rdg = vector<unsigned int>();
+		for (unsigned int descendant_ind : partition.rdg_descendants[slot]) {
+			unsigned int ancestor_ind = arcs[arc_offsets[descendant_ind]].ancestor;
+			if (ancestor_ind >= n_vertices || (unsigned int) (id_rdgs[ancestor_ind] + 1) != slot) {
+				ancestors_without_rdg.push_back(ancestor_ind);
+			}
+		}
+		sort(ancestors_without_rdg.begin(), ancestors_without_rdg.end());
+		ancestors_without_rdg.erase(unique(ancestors_without_rdg.begin(), ancestors_without_rdg.end()), ancestors_without_rdg.end());
+		partition.rdg_vertices[slot].insert(partition.rdg_vertices[slot].end(), ancestors_without_rdg.begin(), ancestors_without_rdg.end());
+	}
+	return partition;
+}
+
+/**
+ * Given a .dot writer, the index of a descendant, and an arc ending at it,
+ * writes a line describing the corresponding edge to it in .dot format,
+ * with the edge formatted to reflect flow strength if the given flag is set.
+ */
+void textual_flow::arc_to_dot(dot_writer & writer, unsigned int descendant_ind, const textual_flow_arc & a, bool flow_strengths) const {
+	writer.begin_edge(a.ancestor, descendant_ind);
+	//If the connectivity index is not direct (i.e., 0), then print it in one-based format:
+	if (a.connectivity > 0) {
+		writer.attribute("label=\"");
+		writer.write(a.connectivity + 1);
+		writer.write("\", fontsize=10");
+	}
+	//Format the color based on the flow type:
+	if (FLOW_TYPE_COLOR_ATTRIBUTES[a.type] != nullptr) {
+		writer.attribute(FLOW_TYPE_COLOR_ATTRIBUTES[a.type]);
+	}
+	//Format the line style based on the flow strength:
+	if (flow_strengths) {
+		writer.attribute(dot_writer::strength_style(a.strength));
+	}
+	writer.end_edge();
+	return;
+}
+
+/**
+ * Given a JSON writer, the index of a descendant, and an arc ending at it,
+ * writes the corresponding edge to it as a JavaScript Object Notation (JSON) object.
+ */
+void textual_flow::arc_to_json(json_writer & writer, unsigned int descendant_ind, const textual_flow_arc & a) const {
+	writer.begin_object();
+	writer.key("ancestor");
+	writer.value(ids[a.ancestor]);
+	writer.key("descendant");
+	writer.value(ids[descendant_ind]);
+	writer.key("type");
+	writer.value((int) a.type);
+	writer.key("connectivity");
+	writer.value(a.connectivity);
+	writer.key("strength");
+	writer.value(a.strength);
+	writer.end_object();
+	return;
+}
+
+/**
+ * Given a .dot writer, writes a complete textual flow diagram to it in .dot format.
  * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
  */
-void textual_flow::textual_flow_to_dot(ostream & out, bool flow_strengths) {
+void textual_flow::textual_flow_to_dot(dot_writer & writer, bool flow_strengths) {
 	//Add the graph first:
-	out << "digraph textual_flow {\n";
+	writer.write("digraph textual_flow {\n");
 	//Add a subgraph for the legend:
-	out << "\tsubgraph cluster_legend {\n";
+	writer.write("\tsubgraph cluster_legend {\n");
 	//Add a box node indicating the label of this graph:
-	out << "\t\tlabel [shape=plaintext, label=\"" << label << "\\nCon = " << (connectivity == numeric_limits<int>::max() ? "Absolute" : to_string(connectivity)) << "\"];\n";
-	out << "\t}\n";
+	writer.write("\t\tlabel [shape=plaintext, label=\"");
+	writer.write(label);
+	writer.write("\\nCon = ");
+	writer.write((connectivity == numeric_limits<int>::max() ? "Absolute" : to_string(connectivity)));
+	writer.write("\"];\n");
+	writer.write("\t}\n");
 	//Add a subgraph for the plot:
-	out << "\tsubgraph cluster_plot {\n";
+	writer.write("\tsubgraph cluster_plot {\n");
 	//Make its border invisible:
-	out << "\t\tstyle=invis;\n";
+	writer.write("\t\tstyle=invis;\n");
 	//Add a line indicating that nodes have an ellipse shape:
-	out << "\t\tnode [shape=ellipse];\n";
-	//Add all of the graph nodes, keeping track of their numerical indices:
-	unordered_map<string, int> id_to_index = unordered_map<string, int>();
-	for (textual_flow_vertex v : vertices) {
-		//Map the ID of this vertex to its numerical index:
-		string wit_id = v.id;
-		string wit_rdg = v.rdg;
-		unsigned int i = (unsigned int) id_to_index.size();
-		id_to_index[wit_id] = i;
-		int wit_ind = id_to_index.at(wit_id);
-		//Then add the node:
-		out << "\t\t" << wit_ind;
+	writer.write("\t\tnode [shape=ellipse];\n");
+	//Add all of the graph nodes:
+	for (unsigned int wit_ind = 0; wit_ind < n_vertices; wit_ind++) {
+		writer.write("\t\t");
+		writer.write(wit_ind);
+		writer.write(" [label=\"");
+		writer.write(ids[wit_ind]);
 		//Format the node based on its readings list:
-		if (wit_rdg.empty()) {
+		if (id_rdgs[wit_ind] < 0) {
 			//The witness is lacunose at this variation unit:
-			out << " [label=\"" << wit_id << "\", color=gray, style=dashed]";
+			writer.write("\", color=gray, style=dashed];\n");
 		}
 		else {
 			//The witness has a reading at this variation unit:
-			out << " [label=\"" << wit_id << " (" << wit_rdg << ")\"]";
+			writer.write(" (");
+			writer.write(rdgs[id_rdgs[wit_ind]]);
+			writer.write(")\"];\n");
 		}
-		out << ";\n";
 	}
-	//Add all of the graph edges, except for secondary graph edges for changes:
-	unordered_set<string> processed_destinations = unordered_set<string>();
-	for (textual_flow_edge e : edges) {
-		//Get the endpoints' IDs:
-		string ancestor_id = e.ancestor;
-		string descendant_id = e.descendant;
-		//If the destination already has an edge drawn to it, then skip this edge:
-		if (processed_destinations.find(descendant_id) != processed_destinations.end()) {
+	//Then add nodes for any ancestors that are not vertices but start one of the edges to be drawn:
+	vector<bool> drawn_ancestors = vector<bool>(ids.size(), false);
+	for (unsigned int descendant_ind = 0; descendant_ind < ids.size(); descendant_ind++) {
+		if (arc_offsets[descendant_ind + 1] > arc_offsets[descendant_ind]) {
+			drawn_ancestors[arcs[arc_offsets[descendant_ind]].ancestor] = true;
+		}
+	}
+	for (unsigned int wit_ind = n_vertices; wit_ind < ids.size(); wit_ind++) {
+		if (!drawn_ancestors[wit_ind]) {
 			continue;
 		}
-		//Otherwise, add the destination node's ID to the processed set:
-		processed_destinations.insert(descendant_id);
-		//Get the indices corresponding to the endpoints' IDs:
-		int ancestor_ind = id_to_index.at(ancestor_id);
-		int descendant_ind = id_to_index.at(descendant_id);
-		//Handle the conditional formatting of the edge:
-		list<string> format_cmds = list<string>();
-		//If the connectivity index is not direct (i.e., 0), then print it in one-based format:
-		if (e.connectivity > 0) {
-			string edge_label = "label=\"" + to_string(e.connectivity + 1) + "\", fontsize=10";
-			format_cmds.push_back(edge_label);
-		}
-		//Format the color based on the flow type:
-		if (e.type == flow_type::EQUAL) {
-			string edge_color = "color=black";
-			format_cmds.push_back(edge_color);
-		}
-		else if (e.type == flow_type::CHANGE) {
-			string edge_color = "color=blue";
-			format_cmds.push_back(edge_color);
-		}
-		else if (e.type == flow_type::LOSS) {
-			string edge_color = "color=gray";
-			format_cmds.push_back(edge_color);
-		}
-		if (flow_strengths) {
-			//Format the line style based on the flow strength:
-			if (e.strength < 0.01) {
-				string edge_style = "style=dotted";
-				format_cmds.push_back(edge_style);
-			}
-			else if (e.strength < 0.05) {
-				string edge_style = "style=dashed";
-				format_cmds.push_back(edge_style);
-			}
-			else if (e.strength < 0.1) {
-				string edge_style = "style=solid";
-				format_cmds.push_back(edge_style);
-			}
-			else {
-				string edge_style = "style=bold";
-				format_cmds.push_back(edge_style);
-			}
+		writer.write("\t\t");
+		writer.write(wit_ind);
+		writer.write(" [label=\"");
+		writer.write(ids[wit_ind]);
+		if (id_rdgs[wit_ind] >= 0) {
+			writer.write(" (");
+			writer.write(rdgs[id_rdgs[wit_ind]]);
+			writer.write(")");
 		}
-		//Add a line describing the edge:
-		out << "\t\t" << ancestor_ind << " -> " << descendant_ind << " [";
-		for (string format_cmd : format_cmds) {
-			if (format_cmd != format_cmds.front()) {
-				out << ", ";
-			}
-			out << format_cmd;
+		writer.write("\"];\n");
+	}
+	//Add all of the graph edges, except for secondary graph edges for changes:
+	for (unsigned int descendant_ind = 0; descendant_ind < ids.size(); descendant_ind++) {
+		if (arc_offsets[descendant_ind + 1] > arc_offsets[descendant_ind]) {
+			arc_to_dot(writer, descendant_ind, arcs[arc_offsets[descendant_ind]], flow_strengths);
+		}
+	}
+	writer.write("\t}\n");
+	writer.write("}\n");
+	return;
+}
+
+/**
+ * Given an output stream, writes a complete textual flow diagram to output in .dot format.
+ * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
+ */
+void textual_flow::textual_flow_to_dot(ostream & out, bool flow_strengths) {
+	dot_writer writer(out);
+	textual_flow_to_dot(writer, flow_strengths);
+	return;
+}
+
+/**
+ * Given a JSON writer, writes a complete textual flow diagram to it as a JavaScript Object Notation (JSON) object.
+ */
+void textual_flow::textual_flow_to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("label");
+	writer.value(label);
+	writer.key("connectivity");
+	writer.value(connectivity);
+	//Add the vertices array, with each vertex as an object:
+	writer.key("vertices");
+	writer.begin_array();
+	for (unsigned int wit_ind = 0; wit_ind < n_vertices; wit_ind++) {
+		writer.begin_object();
+		writer.key("id");
+		writer.value(ids[wit_ind]);
+		writer.key("rdg");
+		writer.value(id_rdgs[wit_ind] >= 0 ? rdgs[id_rdgs[wit_ind]] : "");
+		writer.end_object();
+	}
+	writer.end_array();
+	//Add the edges array, with each edge as an object, except for secondary graph edges for changes:
+	writer.key("edges");
+	writer.begin_array();
+	for (unsigned int descendant_ind = 0; descendant_ind < ids.size(); descendant_ind++) {
+		if (arc_offsets[descendant_ind + 1] > arc_offsets[descendant_ind]) {
+			arc_to_json(writer, descendant_ind, arcs[arc_offsets[descendant_ind]]);
 		}
-		out << "];\n";
 	}
-	out << "\t}\n";
-	out << "}" << endl;
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
 	return;
 }
 
@@ -317,215 +595,134 @@ void textual_flow::textual_flow_to_dot(ostream & out, bool flow_strengths) {
  * Given an output stream, writes a complete textual flow diagram to output in JavaScript Object Notation (JSON) format.
  */
 void textual_flow::textual_flow_to_json(ostream & out) {
-	//Open the root object:
-    out << "{";
-    //Add the metadata fields:
-	out << "\"label\":" << "\"" << label << "\"" << ",";
-	out << "\"connectivity\":" << connectivity << ",";
-	//Add all of the original vertices:
-	list<textual_flow_vertex> textual_flow_vertices = list<textual_flow_vertex>(vertices);
-	//Add all of the graph edges, except for secondary graph edges for changes:
-    unordered_set<string> processed_descendants = unordered_set<string>();
-    list<textual_flow_edge> textual_flow_edges = list<textual_flow_edge>();
-    for (textual_flow_edge e : edges) {
-	    if (processed_descendants.find(e.descendant) != processed_descendants.end()) {
-	        continue;
-	    }
-	    processed_descendants.insert(e.descendant);
-	    textual_flow_edges.push_back(e);
-	}
-    //Open the vertices array:
-    out << "\"vertices\":" << "[";
-    //Print each vertex as an object:
-	unsigned int vertex_num = 0;
-	for (textual_flow_vertex v : textual_flow_vertices) {
-        //Open the vertex object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"id\":" << "\"" << v.id << "\"" << ",";
-        out << "\"rdg\":" << "\"" << v.rdg << "\"" << ",";
-        //Close the vertex object:
-        out << "}";
-        //Add a comma if this is not the last vertex:
-        if (vertex_num != textual_flow_vertices.size() - 1) {
-            out << ",";
-        }
-		vertex_num++;
-	}
-	//Close the vertices array:
-    out << "]" << ",";
-	//Open the edges array:
-    out << "\"edges\":" << "[";
-    //Print each edge as an object:
-	unsigned int edge_num = 0;
-	for (textual_flow_edge e : textual_flow_edges) {
-        //Open the edge object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"ancestor\":" << "\"" << e.ancestor << "\"" << ",";
-        out << "\"descendant\":" << "\"" << e.descendant << "\"" << ",";
-        out << "\"type\":" << e.type << ",";
-        out << "\"connectivity\":" << e.connectivity << ",";
-        out << "\"strength\":" << e.strength;
-        //Close the edge object:
-        out << "}";
-        //Add a comma if this is not the last edge:
-        if (edge_num != textual_flow_edges.size() - 1) {
-            out << ",";
-        }
-		edge_num++;
-	}
-	//Close the edges array:
-    out << "]";
-    //Close the root object:
-    out << "}";
+	json_writer writer(out);
+	textual_flow_to_json(writer);
 	return;
 }
 
 /**
- * Given a reading ID and an output stream,
- * writes a coherence in attestations diagram for that reading to output in .dot format.
- * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
+ * Given a .dot writer, a partition of this textual flow diagram by reading, and a reading ID,
+ * writes the coherence in attestations diagram for that reading to it in .dot format,
+ * with edges formatted to reflect flow strength if the given flag is set.
  */
-void textual_flow::coherence_in_attestations_to_dot(ostream & out, const string & rdg, bool flow_strengths) {
+void textual_flow::attestation_graph_to_dot(dot_writer & writer, const textual_flow_partition & partition, const string & rdg, bool flow_strengths) const {
 	//Add the graph first:
-	out << "digraph textual_flow_diagram {\n";
+	writer.write("digraph textual_flow_diagram {\n");
 	//Add a subgraph for the legend:
-	out << "\tsubgraph cluster_legend {\n";
+	writer.write("\tsubgraph cluster_legend {\n");
 	//Add a box node indicating the label of this graph:
-	out << "\t\tlabel [shape=plaintext, label=\"" << label << ", " << rdg << "\\nCon = " << (connectivity == numeric_limits<int>::max() ? "Absolute" : to_string(connectivity)) << "\"];\n";
-	out << "\t}\n";
+	writer.write("\t\tlabel [shape=plaintext, label=\"");
+	writer.write(label);
+	writer.write(", ");
+	writer.write(rdg);
+	writer.write("\\nCon = ");
+	writer.write((connectivity == numeric_limits<int>::max() ? "Absolute" : to_string(connectivity)));
+	writer.write("\"];\n");
+	writer.write("\t}\n");
 	//Add a subgraph for the plot:
-	out << "\tsubgraph cluster_plot {\n";
+	writer.write("\tsubgraph cluster_plot {\n");
 	//Make its border invisible:
-	out << "\t\tstyle=invis;\n";
+	writer.write("\t\tstyle=invis;\n");
 	//Add a line indicating that nodes have an ellipse shape:
-	out << "\t\tnode [shape=ellipse];\n";
-	//Maintain a map of node IDs to numerical indices
-	//and a vector of vertex data structures:
-	unordered_map<string, int> id_to_index = unordered_map<string, int>();
-	vector<textual_flow_vertex> indexed_vertices = vector<textual_flow_vertex>();
-	for (textual_flow_vertex v : vertices) {
-		//Map the ID of this vertex to its numerical index:
-		string wit_id = v.id;
-		unsigned int i = (unsigned int) id_to_index.size();
-		id_to_index[wit_id] = i;
-		indexed_vertices.push_back(v);
-	}
-	//Initially filter out any vertices that do not have the given reading:
-    list<textual_flow_vertex> coherence_in_attestations_vertices = list<textual_flow_vertex>(vertices);
-    coherence_in_attestations_vertices.remove_if([&](const textual_flow_vertex & v) {
-		return v.rdg != rdg;
-	});
-    //Add all of the graph edges ending at one of the remaining vertices, except for secondary graph edges for changes:
-    unordered_set<string> witnesses_with_rdg = unordered_set<string>();
-	for (textual_flow_vertex v : coherence_in_attestations_vertices) {
-		witnesses_with_rdg.insert(v.id);
-	}
-    list<textual_flow_edge> edges_with_descendants_with_rdg = list<textual_flow_edge>(edges);
-    edges_with_descendants_with_rdg.remove_if([&](const textual_flow_edge & e) {
-		return witnesses_with_rdg.find(e.descendant) == witnesses_with_rdg.end();
-	});
-	//Then add the secondary graph edges, taking only the first one for each descendant:
-	unordered_set<string> processed_descendants = unordered_set<string>();
-	list<textual_flow_edge> distinct_descendant_edges = list<textual_flow_edge>();
-    for (textual_flow_edge e : edges_with_descendants_with_rdg) {
-	    if (processed_descendants.find(e.descendant) != processed_descendants.end()) {
-	        continue;
-	    }
-	    processed_descendants.insert(e.descendant);
-	    distinct_descendant_edges.push_back(e);
-	}
-	list<textual_flow_edge> coherence_in_attestations_edges = list<textual_flow_edge>(distinct_descendant_edges);
-	//Add any ancestors on these edges that do not have the given reading:
-	unordered_set<string> ancestors_without_rdg = unordered_set<string>();
-	for (textual_flow_edge e : distinct_descendant_edges) {
-	    if (witnesses_with_rdg.find(e.ancestor) == witnesses_with_rdg.end()) {
-	        ancestors_without_rdg.insert(e.ancestor);
-	    }
-	}
-	for (textual_flow_vertex v : vertices) {
-	    if (ancestors_without_rdg.find(v.id) != ancestors_without_rdg.end()) {
-	        coherence_in_attestations_vertices.push_back(v);
-	    }
-	}
-	//Now draw the vertices:
-	for (textual_flow_vertex v : coherence_in_attestations_vertices) {
-		//Does this vertex correspond to a witness with the specified reading?
-		string wit_id = v.id;
-		int wit_ind = id_to_index.at(wit_id);
-		string wit_rdg = v.rdg;
-		if (witnesses_with_rdg.find(v.id) != witnesses_with_rdg.end()) {
-			//If so, then draw it normally:
-			out << "\t\t" << wit_ind;
-			out << " [label=\"" << wit_id << " (" << wit_rdg << ")\"]";
-			out << ";\n";
-		} else {
-			//Otherwise, it has a distinct reading and should be drawn differently:
-			out << "\t\t" << wit_ind;
-			out << " [label=\"" << wit_id << " (" << wit_rdg << ")\", color=blue, style=dashed]";
-			out << ";\n";
-		}
-	}
-	//The draw the edges:
-	for (textual_flow_edge e : coherence_in_attestations_edges) {
-		//Get the endpoints' IDs:
-		string ancestor_id = e.ancestor;
-		string descendant_id = e.descendant;
-		//Get the indices of the endpoints:
-		int ancestor_ind = id_to_index.at(ancestor_id);
-		int descendant_ind = id_to_index.at(descendant_id);
-		//Handle the conditional formatting of the edge:
-		list<string> format_cmds = list<string>();
-		//If the connectivity index is not direct (i.e., 0), then print it in one-based format:
-		if (e.connectivity > 0) {
-			string edge_label = "label=\"" + to_string(e.connectivity + 1) + "\", fontsize=10";
-			format_cmds.push_back(edge_label);
-		}
-		//Format the color based on the flow type:
-		if (e.type == flow_type::EQUAL) {
-			string edge_color = "color=black";
-			format_cmds.push_back(edge_color);
-		}
-		else if (e.type == flow_type::CHANGE) {
-			string edge_color = "color=blue";
-			format_cmds.push_back(edge_color);
-		}
-		else if (e.type == flow_type::LOSS) {
-			string edge_color = "color=gray";
-			format_cmds.push_back(edge_color);
-		}
-		if (flow_strengths) {
-			//Format the line style based on the flow strength:
-			if (e.strength < 0.01) {
-				string edge_style = "style=dotted";
-				format_cmds.push_back(edge_style);
-			}
-			else if (e.strength < 0.05) {
-				string edge_style = "style=dashed";
-				format_cmds.push_back(edge_style);
-			}
-			else if (e.strength < 0.1) {
-				string edge_style = "style=solid";
-				format_cmds.push_back(edge_style);
+	writer.write("\t\tnode [shape=ellipse];\n");
+	int slot = get_rdg_slot(rdg);
+	if (slot >= 0) {
+		//Now draw the vertices:
+		for (unsigned int wit_ind : partition.rdg_vertices[slot]) {
+			writer.write("\t\t");
+			writer.write(wit_ind);
+			writer.write(" [label=\"");
+			writer.write(ids[wit_ind]);
+			writer.write(" (");
+			if (id_rdgs[wit_ind] >= 0) {
+				writer.write(rdgs[id_rdgs[wit_ind]]);
 			}
-			else {
-				string edge_style = "style=bold";
-				format_cmds.push_back(edge_style);
+			//Does this vertex correspond to a witness with the specified reading?
+			if (id_rdgs[wit_ind] + 1 == slot) {
+				//If so, then draw it normally:
+				writer.write(")\"];\n");
+			} else {
+				//Otherwise, it has a distinct reading and should be drawn differently:
+				writer.write(")\", color=blue, style=dashed];\n");
 			}
 		}
-		//Add a line describing the edge:
-		out << "\t\t" << ancestor_ind << " -> " << descendant_ind << " [";
-		for (string format_cmd : format_cmds) {
-			if (format_cmd != format_cmds.front()) {
-				out << ", ";
-			}
-			out << format_cmd;
+		//The draw the edges:
+		for (unsigned int descendant_ind : partition.rdg_descendants[slot]) {
+			arc_to_dot(writer, descendant_ind, arcs[arc_offsets[descendant_ind]], flow_strengths);
 		}
-		out << "];\n";
 	}
-	out << "\t}\n";
-	out << "}" << endl;
+	writer.write("\t}\n");
+	writer.write("}\n");
+	return;
+}
+
+/**
+ * Given a JSON writer, a partition of this textual flow diagram by reading, and a reading ID,
+ * writes the coherence in attestations diagram for that reading to it as a JavaScript Object Notation (JSON) object.
+ */
+void textual_flow::attestation_graph_to_json(json_writer & writer, const textual_flow_partition & partition, const string & rdg) const {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("label");
+	writer.value(label + ", " + rdg);
+	writer.key("connectivity");
+	writer.value(connectivity);
+	int slot = get_rdg_slot(rdg);
+	//Add the vertices array, with each vertex as an object:
+	writer.key("vertices");
+	writer.begin_array();
+	if (slot >= 0) {
+		for (unsigned int wit_ind : partition.rdg_vertices[slot]) {
+			writer.begin_object();
+			writer.key("id");
+			writer.value(ids[wit_ind]);
+			writer.key("rdg");
+			writer.value(id_rdgs[wit_ind] >= 0 ? rdgs[id_rdgs[wit_ind]] : "");
+			writer.end_object();
+		}
+	}
+	writer.end_array();
+	//Add the edges array, with each edge as an object:
+	writer.key("edges");
+	writer.begin_array();
+	if (slot >= 0) {
+		for (unsigned int descendant_ind : partition.rdg_descendants[slot]) {
+			arc_to_json(writer, descendant_ind, arcs[arc_offsets[descendant_ind]]);
+		}
+	}
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
+	return;
+}
+
+/**
+ * Given a .dot writer and a reading ID,
+ * writes a coherence in attestations diagram for that reading to it in .dot format.
+ * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
+ */
+void textual_flow::coherence_in_attestations_to_dot(dot_writer & writer, const string & rdg, bool flow_strengths) {
+	attestation_graph_to_dot(writer, partition_by_reading(), rdg, flow_strengths);
+	return;
+}
+
+/**
+ * Given a reading ID and an output stream,
+ * writes a coherence in attestations diagram for that reading to output in .dot format.
+ * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
+ */
+void textual_flow::coherence_in_attestations_to_dot(ostream & out, const string & rdg, bool flow_strengths) {
+	dot_writer writer(out);
+	coherence_in_attestations_to_dot(writer, rdg, flow_strengths);
+	return;
+}
+
+/**
+ * Given a JSON writer and a reading ID, writes a coherence in attestations textual flow diagram for that reading to it as a JavaScript Object Notation (JSON) object.
+ */
+void textual_flow::coherence_in_attestations_to_json(json_writer & writer, const string & rdg) {
+	attestation_graph_to_json(writer, partition_by_reading(), rdg);
 	return;
 }
 
@@ -533,220 +730,238 @@ void textual_flow::coherence_in_attestations_to_dot(ostream & out, const string
  * Given a reading ID and an output stream, writes a coherence in attestations textual flow diagram to output in JavaScript Object Notation (JSON) format.
  */
 void textual_flow::coherence_in_attestations_to_json(ostream & out, const string & rdg) {
-	//Open the root object:
-    out << "{";
-    //Add the metadata fields:
-	out << "\"label\":" << "\"" << label << ", " << rdg << "\"" << ",";
-	out << "\"connectivity\":" << connectivity << ",";
-    //Initially filter out any vertices that do not have the given reading:
-    list<textual_flow_vertex> coherence_in_attestations_vertices = list<textual_flow_vertex>(vertices);
-    coherence_in_attestations_vertices.remove_if([&](const textual_flow_vertex & v) {
-		return v.rdg != rdg;
-	});
-    //Add all of the graph edges ending at one of the remaining vertices, except for secondary graph edges for changes:
-    unordered_set<string> witnesses_with_rdg = unordered_set<string>();
-    for (textual_flow_vertex v : coherence_in_attestations_vertices) {
-        witnesses_with_rdg.insert(v.id);
-    }
-    list<textual_flow_edge> edges_with_descendants_with_rdg = list<textual_flow_edge>(edges);
-    edges_with_descendants_with_rdg.remove_if([&](const textual_flow_edge & e) {
-		return witnesses_with_rdg.find(e.descendant) == witnesses_with_rdg.end();
-	});
-	unordered_set<string> processed_descendants = unordered_set<string>();
-	list<textual_flow_edge> distinct_descendant_edges = list<textual_flow_edge>();
-    for (textual_flow_edge e : edges_with_descendants_with_rdg) {
-	    if (processed_descendants.find(e.descendant) != processed_descendants.end()) {
-	        continue;
-	    }
-	    processed_descendants.insert(e.descendant);
-	    distinct_descendant_edges.push_back(e);
-	}
-	list<textual_flow_edge> coherence_in_attestations_edges = list<textual_flow_edge>(distinct_descendant_edges);
-	//Add any ancestors on these edges that do not have the given reading:
-	unordered_set<string> ancestors_without_rdg = unordered_set<string>();
-	for (textual_flow_edge e : distinct_descendant_edges) {
-	    if (witnesses_with_rdg.find(e.ancestor) == witnesses_with_rdg.end()) {
-	        ancestors_without_rdg.insert(e.ancestor);
-	    }
-	}
-	for (textual_flow_vertex v : vertices) {
-	    if (ancestors_without_rdg.find(v.id) != ancestors_without_rdg.end()) {
-	        coherence_in_attestations_vertices.push_back(v);
-	    }
-	}
-	//Open the vertices array:
-    out << "\"vertices\":" << "[";
-	//Print each vertex as an object:
-	unsigned int vertex_num = 0;
-	for (textual_flow_vertex v : coherence_in_attestations_vertices) {
-        //Open the vertex object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"id\":" << "\"" << v.id << "\"" << ",";
-        out << "\"rdg\":" << "\"" << v.rdg << "\"" << ",";
-        //Close the vertex object:
-        out << "}";
-        //Add a comma if this is not the last vertex:
-        if (vertex_num != coherence_in_attestations_vertices.size() - 1) {
-            out << ",";
-        }
-		vertex_num++;
-	}
-	//Close the vertices array:
-    out << "]" << ",";
-	//Open the edges array:
-    out << "\"edges\":" << "[";
-    //Print each edge as an object:
-	unsigned int edge_num = 0;
-	for (textual_flow_edge e : coherence_in_attestations_edges) {
-        //Open the edge object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"ancestor\":" << "\"" << e.ancestor << "\"" << ",";
-        out << "\"descendant\":" << "\"" << e.descendant << "\"" << ",";
-        out << "\"type\":" << e.type << ",";
-        out << "\"connectivity\":" << e.connectivity << ",";
-        out << "\"strength\":" << e.strength;
-        //Close the edge object:
-        out << "}";
-        //Add a comma if this is not the last edge:
-        if (edge_num != coherence_in_attestations_edges.size() - 1) {
-            out << ",";
-        }
-		edge_num++;
-	}
-	//Close the edges array:
-    out << "]";
-    //Close the root object:
-    out << "}";
+	json_writer writer(out);
+	coherence_in_attestations_to_json(writer, rdg);
 	return;
 }
 
 /**
- * Given an output stream, writes a coherence in variant passages diagram to output in .dot format.
+ * Given a .dot writer, writes the coherence in attestations diagrams for all readings to it in .dot format,
+ * one graph after another, in the order of this textual flow's readings list.
+ * The diagram is partitioned by reading only once, rather than once per reading.
  * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
  */
-void textual_flow::coherence_in_variant_passages_to_dot(ostream & out, bool flow_strengths) {
+void textual_flow::coherence_in_all_attestations_to_dot(dot_writer & writer, bool flow_strengths) {
+	textual_flow_partition partition = partition_by_reading();
+	for (const string & rdg : readings) {
+		attestation_graph_to_dot(writer, partition, rdg, flow_strengths);
+	}
+	return;
+}
+
+/**
+ * Given an output stream, writes the coherence in attestations diagrams for all readings to output in .dot format,
+ * one graph after another, in the order of this textual flow's readings list.
+ * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
+ */
+void textual_flow::coherence_in_all_attestations_to_dot(ostream & out, bool flow_strengths) {
+	dot_writer writer(out);
+	coherence_in_all_attestations_to_dot(writer, flow_strengths);
+	return;
+}
+
+/**
+ * Given a map of output streams keyed by reading ID, writes the coherence in attestations diagram for each reading in .dot format
+ * to the output stream for that reading; readings without an output stream in the map are skipped.
+ * The diagram is partitioned by reading only once, rather than once per reading.
+ * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
+ */
+void textual_flow::coherence_in_all_attestations_to_dot(const map<string, ostream *> & outs, bool flow_strengths) {
+	textual_flow_partition partition = partition_by_reading();
+	for (const string & rdg : readings) {
+		map<string, ostream *>::const_iterator it = outs.find(rdg);
+		if (it == outs.end()) {
+			continue;
+		}
+		dot_writer writer(*it->second);
+		attestation_graph_to_dot(writer, partition, rdg, flow_strengths);
+	}
+	return;
+}
+
+/**
+ * Given a JSON writer, writes the coherence in attestations diagrams for all readings to it
+ * as a JavaScript Object Notation (JSON) array, in the order of this textual flow's readings list.
+ * The diagram is partitioned by reading only once, rather than once per reading.
+ */
+void textual_flow::coherence_in_all_attestations_to_json(json_writer & writer) {
+	textual_flow_partition partition = partition_by_reading();
+	writer.begin_array();
+	for (const string & rdg : readings) {
+		attestation_graph_to_json(writer, partition, rdg);
+	}
+	writer.end_array();
+	return;
+}
+
+/**
+ * Given an output stream, writes the coherence in attestations diagrams for all readings to output
+ * as a JavaScript Object Notation (JSON) array, in the order of this textual flow's readings list.
+ */
+void textual_flow::coherence_in_all_attestations_to_json(ostream & out) {
+	json_writer writer(out);
+	coherence_in_all_attestations_to_json(writer);
+	return;
+}
+
+/**
+ * Given a map of output streams keyed by reading ID, writes the coherence in attestations diagram for each reading
+ * in JavaScript Object Notation (JSON) format to the output stream for that reading; readings without an output stream in the map are skipped.
+ * The diagram is partitioned by reading only once, rather than once per reading.
+ */
+void textual_flow::coherence_in_all_attestations_to_json(const map<string, ostream *> & outs) {
+	textual_flow_partition partition = partition_by_reading();
+	for (const string & rdg : readings) {
+		map<string, ostream *>::const_iterator it = outs.find(rdg);
+		if (it == outs.end()) {
+			continue;
+		}
+		json_writer writer(*it->second);
+		attestation_graph_to_json(writer, partition, rdg);
+	}
+	return;
+}
+
+/**
+ * Given a .dot writer, writes a coherence in variant passages diagram to it in .dot format.
+ * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
+ */
+void textual_flow::coherence_in_variant_passages_to_dot(dot_writer & writer, bool flow_strengths) {
 	//Add the graph first:
-	out << "digraph textual_flow_diagram {\n";
+	writer.write("digraph textual_flow_diagram {\n");
 	//Add a subgraph for the legend:
-	out << "\tsubgraph cluster_legend {\n";
+	writer.write("\tsubgraph cluster_legend {\n");
 	//Add a box node indicating the label of this graph:
-	out << "\t\tlabel [shape=plaintext, label=\"" << label << "\\nCon = " << (connectivity == numeric_limits<int>::max() ? "Absolute" : to_string(connectivity)) << "\"];\n";
-	out << "\t}\n";
+	writer.write("\t\tlabel [shape=plaintext, label=\"");
+	writer.write(label);
+	writer.write("\\nCon = ");
+	writer.write((connectivity == numeric_limits<int>::max() ? "Absolute" : to_string(connectivity)));
+	writer.write("\"];\n");
+	writer.write("\t}\n");
 	//Add a subgraph for the plot:
-	out << "\tsubgraph cluster_plot {\n";
+	writer.write("\tsubgraph cluster_plot {\n");
 	//Make its border invisible:
-	out << "\t\tstyle=invis;\n";
+	writer.write("\t\tstyle=invis;\n");
 	//Add a line indicating that nodes have an ellipse shape:
-	out << "\t\tnode [shape=ellipse];\n";
-	//Maintain a map of node IDs to numerical indices
-	//and a vector of vertex data structures:
-	unordered_map<string, int> id_to_index = unordered_map<string, int>();
-	for (textual_flow_vertex v : vertices) {
-		//Map the ID of this vertex to its numerical index:
-		string wit_id = v.id;
-		unsigned int i = (unsigned int) id_to_index.size();
-		id_to_index[wit_id] = i;
-	}
-	//Maintain a map of support lists for each reading:
-	map<string, list<string>> clusters = map<string, list<string>>();
-	for (string rdg : readings) {
-		clusters[rdg] = list<string>();
-	}
-	for (textual_flow_vertex v : vertices) {
-		string wit_id = v.id;
-		string wit_rdg = v.rdg;
-		clusters[wit_rdg].push_back(wit_id);
-	}
-	//Maintain a set of IDs for nodes between which there exists an edge of flow type CHANGE:
-	unordered_set<string> change_wit_ids = unordered_set<string>();
-	for (textual_flow_edge e : edges) {
-		if (e.type == flow_type::CHANGE) {
-			change_wit_ids.insert(e.ancestor);
-			change_wit_ids.insert(e.descendant);
+	writer.write("\t\tnode [shape=ellipse];\n");
+	//Mark the IDs at either end of an edge of flow type CHANGE:
+	vector<bool> change_wits = vector<bool>(ids.size(), false);
+	for (unsigned int descendant_ind = 0; descendant_ind < ids.size(); descendant_ind++) {
+		for (unsigned int j = arc_offsets[descendant_ind]; j < arc_offsets[descendant_ind + 1]; j++) {
+			if (arcs[j].type == flow_type::CHANGE) {
+				change_wits[arcs[j].ancestor] = true;
+				change_wits[descendant_ind] = true;
+			}
 		}
 	}
 	//Add a cluster for each reading, including all of the nodes it contains:
-	for (string rdg : readings) {
-		list<string> cluster = clusters.at(rdg);
-		out << "\t\tsubgraph cluster_" << rdg << " {\n";
-		out << "\t\t\tlabeljust=\"c\";\n";
-		out << "\t\t\tlabel=\"" << rdg << "\";\n";
-		out << "\t\t\tstyle=solid;\n";
-		for (string wit_id : cluster) {
-			//If this witness is not at either end of a CHANGE flow edge, then skip it:
-			if (change_wit_ids.find(wit_id) == change_wit_ids.end()) {
+	for (const string & rdg : readings) {
+		int slot = get_rdg_slot(rdg);
+		writer.write("\t\tsubgraph cluster_");
+		writer.write(rdg);
+		writer.write(" {\n");
+		writer.write("\t\t\tlabeljust=\"c\";\n");
+		writer.write("\t\t\tlabel=\"");
+		writer.write(rdg);
+		writer.write("\";\n");
+		writer.write("\t\t\tstyle=solid;\n");
+		for (unsigned int wit_ind = 0; wit_ind < ids.size(); wit_ind++) {
+			//If this witness (or ancestor that is not a vertex) does not have this reading or is not at either end of a CHANGE flow edge, then skip it:
+			if (id_rdgs[wit_ind] + 1 != slot || !change_wits[wit_ind]) {
 				continue;
 			}
 			//Otherwise, add a vertex for it:
-			int wit_ind = id_to_index.at(wit_id);
-			out << "\t\t\t" << wit_ind;
-			out << " [label=\"" << wit_id << "\"]";
-			out << ";\n";
+			writer.write("\t\t\t");
+			writer.write(wit_ind);
+			writer.write(" [label=\"");
+			writer.write(ids[wit_ind]);
+			writer.write("\"];\n");
 		}
-		out << "\t\t}\n";
+		writer.write("\t\t}\n");
 	}
-	//Finally, add the "CHANGE" edges:
-	for (textual_flow_edge e : edges) {
-		//Only add "CHANGE" edges:
-		if (e.type != flow_type::CHANGE) {
+	//Then add nodes outside of the clusters for any ancestors at either end of these edges whose readings are unknown:
+	for (unsigned int wit_ind = n_vertices; wit_ind < ids.size(); wit_ind++) {
+		if (id_rdgs[wit_ind] >= 0 || !change_wits[wit_ind]) {
 			continue;
 		}
-		//Get the indices corresponding to the endpoints' IDs:
-		int ancestor_ind = id_to_index.at(e.ancestor);
-		int descendant_ind = id_to_index.at(e.descendant);
-		//Handle the conditional formatting of the edge:
-		list<string> format_cmds = list<string>();
-		//If the connectivity index is not direct (i.e., 0), then print it in one-based format:
-		if (e.connectivity > 0) {
-			string edge_label = "label=\"" + to_string(e.connectivity + 1) + "\", fontsize=10";
-			format_cmds.push_back(edge_label);
-		}
-		//Format the color based on the flow type:
-		if (e.type == flow_type::EQUAL) {
-			string edge_color = "color=black";
-			format_cmds.push_back(edge_color);
-		}
-		else if (e.type == flow_type::CHANGE) {
-			string edge_color = "color=blue";
-			format_cmds.push_back(edge_color);
-		}
-		else if (e.type == flow_type::LOSS) {
-			string edge_color = "color=gray";
-			format_cmds.push_back(edge_color);
-		}
-		if (flow_strengths) {
-			//Format the line style based on the flow strength:
-			if (e.strength < 0.01) {
-				string edge_style = "style=dotted";
-				format_cmds.push_back(edge_style);
-			}
-			else if (e.strength < 0.05) {
-				string edge_style = "style=dashed";
-				format_cmds.push_back(edge_style);
-			}
-			else if (e.strength < 0.1) {
-				string edge_style = "style=solid";
-				format_cmds.push_back(edge_style);
+		writer.write("\t\t");
+		writer.write(wit_ind);
+		writer.write(" [label=\"");
+		writer.write(ids[wit_ind]);
+		writer.write("\"];\n");
+	}
+	//Finally, add the "CHANGE" edges:
+	for (unsigned int descendant_ind = 0; descendant_ind < ids.size(); descendant_ind++) {
+		for (unsigned int j = arc_offsets[descendant_ind]; j < arc_offsets[descendant_ind + 1]; j++) {
+			if (arcs[j].type == flow_type::CHANGE) {
+				arc_to_dot(writer, descendant_ind, arcs[j], flow_strengths);
 			}
-			else {
-				string edge_style = "style=bold";
-				format_cmds.push_back(edge_style);
+		}
+	}
+	writer.write("\t}\n");
+	writer.write("}\n");
+	return;
+}
+
+/**
+ * Given an output stream, writes a coherence in variant passages diagram to output in .dot format.
+ * An optional flag indicating whether to format edges to reflect flow strength can also be specified.
+ */
+void textual_flow::coherence_in_variant_passages_to_dot(ostream & out, bool flow_strengths) {
+	dot_writer writer(out);
+	coherence_in_variant_passages_to_dot(writer, flow_strengths);
+	return;
+}
+
+/**
+ * Given a JSON writer, writes a coherence in variant passages textual flow diagram to it as a JavaScript Object Notation (JSON) object.
+ */
+void textual_flow::coherence_in_variant_passages_to_json(json_writer & writer) {
+	//Open the root object:
+	writer.begin_object();
+	//Add the metadata fields:
+	writer.key("label");
+	writer.value(label);
+	writer.key("connectivity");
+	writer.value(connectivity);
+	//Mark the IDs at either end of an edge of flow type CHANGE:
+	vector<bool> change_wits = vector<bool>(ids.size(), false);
+	for (unsigned int descendant_ind = 0; descendant_ind < ids.size(); descendant_ind++) {
+		for (unsigned int j = arc_offsets[descendant_ind]; j < arc_offsets[descendant_ind + 1]; j++) {
+			if (arcs[j].type == flow_type::CHANGE) {
+				change_wits[arcs[j].ancestor] = true;
+				change_wits[descendant_ind] = true;
 			}
 		}
-		//Add a line describing the edge:
-		out << "\t\t" << ancestor_ind << " -> " << descendant_ind << " [";
-		for (string format_cmd : format_cmds) {
-			if (format_cmd != format_cmds.front()) {
-				out << ", ";
+	}
+	//Add the vertices array, with each vertex (or ancestor that is not a vertex) at either end of these edges as an object:
+	writer.key("vertices");
+	writer.begin_array();
+	for (unsigned int wit_ind = 0; wit_ind < ids.size(); wit_ind++) {
+		if (!change_wits[wit_ind]) {
+			continue;
+		}
+		writer.begin_object();
+		writer.key("id");
+		writer.value(ids[wit_ind]);
+		writer.key("rdg");
+		writer.value(id_rdgs[wit_ind] >= 0 ? rdgs[id_rdgs[wit_ind]] : "");
+		writer.end_object();
+	}
+	writer.end_array();
+	//Add the edges array, with each edge representing a change in reading as an object:
+	writer.key("edges");
+	writer.begin_array();
+	for (unsigned int descendant_ind = 0; descendant_ind < ids.size(); descendant_ind++) {
+		for (unsigned int j = arc_offsets[descendant_ind]; j < arc_offsets[descendant_ind + 1]; j++) {
+			if (arcs[j].type == flow_type::CHANGE) {
+				arc_to_json(writer, descendant_ind, arcs[j]);
 			}
-			out << format_cmd;
 		}
-		out << "];\n";
 	}
-	out << "\t}\n";
-	out << "}" << endl;
+	writer.end_array();
+	//Close the root object:
+	writer.end_object();
 	return;
 }
 
@@ -754,72 +969,7 @@ void textual_flow::coherence_in_variant_passages_to_dot(ostream & out, bool flow
  * Given an output stream, writes a coherence in variant passages textual flow diagram to output in JavaScript Object Notation (JSON) format.
  */
 void textual_flow::coherence_in_variant_passages_to_json(ostream & out) {
-	//Open the root object:
-    out << "{";
-    //Add the metadata fields:
-	out << "\"label\":" << "\"" << label << "\"" << ",";
-	out << "\"connectivity\":" << connectivity << ",";
-	//Start with an initially empty vertex list:
-	list<textual_flow_vertex> coherence_in_variant_passages_vertices = list<textual_flow_vertex>();
-	//Add all of the graph edges representing changes in reading:
-    list<textual_flow_edge> coherence_in_variant_passages_edges = list<textual_flow_edge>(edges);
-    coherence_in_variant_passages_edges.remove_if([&](const textual_flow_edge & e) {
-        return e.type != flow_type::CHANGE;
-    });
-    //Then add all vertices at either endpoint of these edges:
-    unordered_set<string> processed_vertex_ids = unordered_set<string>();
-    for (textual_flow_edge e : coherence_in_variant_passages_edges) {
-        processed_vertex_ids.insert(e.ancestor);
-        processed_vertex_ids.insert(e.descendant);
-    }
-    coherence_in_variant_passages_vertices = list<textual_flow_vertex>(vertices);
-    coherence_in_variant_passages_vertices.remove_if([&](const textual_flow_vertex & v) {
-        return processed_vertex_ids.find(v.id) == processed_vertex_ids.end();
-    });
-    //Open the vertices array:
-    out << "\"vertices\":" << "[";
-    //Print each vertex as an object:
-	unsigned int vertex_num = 0;
-	for (textual_flow_vertex v : coherence_in_variant_passages_vertices) {
-        //Open the vertex object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"id\":" << "\"" << v.id << "\"" << ",";
-        out << "\"rdg\":" << "\"" << v.rdg << "\"" << ",";
-        //Close the vertex object:
-        out << "}";
-        //Add a comma if this is not the last vertex:
-        if (vertex_num != coherence_in_variant_passages_vertices.size() - 1) {
-            out << ",";
-        }
-		vertex_num++;
-	}
-	//Close the vertices array:
-    out << "]" << ",";
-	//Open the edges array:
-    out << "\"edges\":" << "[";
-    //Print each edge as an object:
-	unsigned int edge_num = 0;
-	for (textual_flow_edge e : coherence_in_variant_passages_edges) {
-        //Open the edge object:
-        out << "{";
-        //Add its key-value pairs:
-        out << "\"ancestor\":" << "\"" << e.ancestor << "\"" << ",";
-        out << "\"descendant\":" << "\"" << e.descendant << "\"" << ",";
-        out << "\"type\":" << e.type << ",";
-        out << "\"connectivity\":" << e.connectivity << ",";
-        out << "\"strength\":" << e.strength;
-        //Close the edge object:
-        out << "}";
-        //Add a comma if this is not the last edge:
-        if (edge_num != coherence_in_variant_passages_edges.size() - 1) {
-            out << ",";
-        }
-		edge_num++;
-	}
-	//Close the edges array:
-    out << "]";
-    //Close the root object:
-    out << "}";
+	json_writer writer(out);
+	coherence_in_variant_passages_to_json(writer);
 	return;
 }
@@ -0,0 +1,517 @@
+/*
+ * textual_flow_builder.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjmccollum
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <list>
+#include <vector>
+#include <unordered_map> //for large maps keyed by witnesses
+#include <map> //for small maps keyed by readings
+#include <algorithm>
+#include <memory>
+
+#include "textual_flow_builder.h"
+#include "textual_flow.h"
+#include "witness.h"
+#include "variation_unit.h"
+#include "local_stemma.h"
+#include "parallel_for.h"
+#include "json_writer.h"
+#include "dot_writer.h"
+
+using namespace std;
+
+/**
+ * Default constructor.
+ */
+textual_flow_builder::textual_flow_builder() {
+	pool = make_shared<thread_pool>(threads);
+}
+
+/**
+ * Constructs a textual flow builder from a list of witnesses (whose lists of potential ancestors are assumed to be populated)
+ * and the number of worker threads to use for batch operations (0 for as many as the hardware supports).
+ * The connectivity rank and flow strength of each witness's potential ancestors do not depend on the variation unit,
+ * so they are computed here once, rather than once per variation unit.
+ */
+textual_flow_builder::textual_flow_builder(const list<witness> & witnesses, unsigned int _threads) {
+	threads = _threads;
+	pool = make_shared<thread_pool>(threads);
+	ids = vector<string>();
+	ranked_ancestors = vector<vector<ranked_ancestor>>();
+	//Index the input witnesses first, so that their vertices keep the same order as in the input list:
+	unordered_map<string, unsigned int> ids_to_inds = unordered_map<string, unsigned int>();
+	for (const witness & wit : witnesses) {
+		ids_to_inds[wit.get_id()] = (unsigned int) ids.size();
+		ids.push_back(wit.get_id());
+	}
+	n_witnesses = (unsigned int) ids.size();
+	//Then rank the potential ancestors of each witness:
+	for (const witness & wit : witnesses) {
+		vector<ranked_ancestor> wit_ranked_ancestors = vector<ranked_ancestor>();
+		int con = -1;
+		int con_value = -1; //connectivity rank only changes when this value changes
+		for (const string & potential_ancestor_id : wit.get_potential_ancestor_ids()) {
+			//Update the connectivity rank if the connectivity value changes:
+			genealogical_comparison comp = wit.get_genealogical_comparison_for_witness(potential_ancestor_id);
+			int agreements = (int) comp.agreements.cardinality();
+			if (agreements != con_value) {
+				con_value = agreements;
+				con++;
+			}
+			//Index the potential ancestor's ID if it has not been indexed yet:
+			if (ids_to_inds.find(potential_ancestor_id) == ids_to_inds.end()) {
+				ids_to_inds[potential_ancestor_id] = (unsigned int) ids.size();
+				ids.push_back(potential_ancestor_id);
+			}
+			ranked_ancestor ra;
+			ra.index = ids_to_inds.at(potential_ancestor_id);
+			ra.rank = con;
+			//Calculate the stability of the textual flow:
+			ra.strength = float(comp.posterior.cardinality() - comp.prior.cardinality()) / float(comp.extant.cardinality());
+			wit_ranked_ancestors.push_back(ra);
+		}
+		ranked_ancestors.push_back(wit_ranked_ancestors);
+	}
+}
+
+/**
+ * Default destructor.
+ */
+textual_flow_builder::~textual_flow_builder() {
+
+}
+
+/**
+ * Resolves the readings of the given variation unit to indices for fast textual flow construction.
+ * The readings attested by this builder's witnesses and potential ancestors are placed in the given readings vector,
+ * the index of each ID's reading (or -1 if it is lacunose) is placed in the given reading indices vector,
+ * and the given equal flow vector is populated as a row-major matrix indicating, for each pair of readings,
+ * whether the first explains the second without any change (i.e., via a path of weight 0 in the local stemma).
+ */
+void textual_flow_builder::index_readings(const variation_unit & vu, vector<string> & rdgs, vector<int> & rdg_inds, vector<bool> & equal_flow) const {
+	local_stemma ls = vu.get_local_stemma();
+	unordered_map<string, string> reading_support = vu.get_reading_support();
+	//Map each ID to the index of its reading at this variation unit (or -1 if it is lacunose):
+	rdgs = vector<string>();
+	map<string, int> rdgs_to_inds = map<string, int>();
+	rdg_inds = vector<int>(ids.size(), -1);
+	for (unsigned int i = 0; i < ids.size(); i++) {
+		unordered_map<string, string>::const_iterator it = reading_support.find(ids[i]);
+		if (it == reading_support.end()) {
+			continue;
+		}
+		const string & rdg = it->second;
+		if (rdgs_to_inds.find(rdg) == rdgs_to_inds.end()) {
+			rdgs_to_inds[rdg] = (int) rdgs.size();
+			rdgs.push_back(rdg);
+		}
+		rdg_inds[i] = rdgs_to_inds.at(rdg);
+	}
+	//Then determine, for each pair of readings, whether the first explains the second without any change:
+	unsigned int n_rdgs = (unsigned int) rdgs.size();
+	equal_flow = vector<bool>(n_rdgs * n_rdgs, false);
+	for (unsigned int i = 0; i < n_rdgs; i++) {
+		for (unsigned int j = 0; j < n_rdgs; j++) {
+			equal_flow[i * n_rdgs + j] = ls.path_exists(rdgs[i], rdgs[j]) && ls.get_path(rdgs[i], rdgs[j]).weight == 0;
+		}
+	}
+}
+
+/**
+ * Returns the number of worker threads this builder uses for batch operations.
+ */
+unsigned int textual_flow_builder::get_threads() const {
+	return threads;
+}
+
+/**
+ * Sets the number of worker threads this builder uses for batch operations (0 for as many as the hardware supports).
+ */
+void textual_flow_builder::set_threads(unsigned int _threads) {
+	threads = _threads;
+	pool = make_shared<thread_pool>(threads);
+}
+
+/**
+ * Returns the IDs of the witnesses this builder was constructed from, in order.
+ */
+vector<string> textual_flow_builder::get_witness_ids() const {
+	return vector<string>(ids.begin(), ids.begin() + n_witnesses);
+}
+
+/**
+ * Returns the ranked potential ancestors of the witness at the given index.
+ */
+vector<ranked_ancestor> textual_flow_builder::get_ranked_ancestors(unsigned int wit_ind) const {
+	return ranked_ancestors[wit_ind];
+}
+
+/**
+ * Constructs a textual flow instance for the given variation unit with the given connectivity limit.
+ * The result is the same as that of the textual_flow constructor for the same variation unit, witnesses, and connectivity,
+ * but readings and local stemma paths are resolved to indices once per variation unit rather than once per potential ancestor,
+ * and the graph is passed to the textual flow in index form.
+ */
+textual_flow textual_flow_builder::get_textual_flow(const variation_unit & vu, int connectivity) const {
+	vector<string> rdgs;
+	vector<int> rdg_inds;
+	vector<bool> equal_flow;
+	index_readings(vu, rdgs, rdg_inds, equal_flow);
+	unsigned int n_rdgs = (unsigned int) rdgs.size();
+	//Add edges for each witness, grouped by witness:
+	vector<unsigned int> arc_offsets = vector<unsigned int>(1, 0);
+	vector<textual_flow_arc> arcs = vector<textual_flow_arc>();
+	for (unsigned int wit_ind = 0; wit_ind < n_witnesses; wit_ind++) {
+		int wit_rdg_ind = rdg_inds[wit_ind];
+		//If this witness has no potential ancestors (i.e., if it has equal priority to the Ausgangstext),
+		//then there are no edges to add, and we can continue:
+		const vector<ranked_ancestor> & wit_ranked_ancestors = ranked_ancestors[wit_ind];
+		if (wit_ranked_ancestors.empty()) {
+			arc_offsets.push_back((unsigned int) arcs.size());
+			continue;
+		}
+		//If the witness is extant, then attempt to find an ancestor within the connectivity limit that agrees with it here:
+		bool textual_flow_ancestor_found = false;
+		if (wit_rdg_ind >= 0) {
+			for (const ranked_ancestor & ra : wit_ranked_ancestors) {
+				//If we reach the connectivity limit, then exit the loop early:
+				if (ra.rank == connectivity) {
+					break;
+				}
+				int ancestor_rdg_ind = rdg_inds[ra.index];
+				if (ancestor_rdg_ind >= 0 && equal_flow[ancestor_rdg_ind * n_rdgs + wit_rdg_ind]) {
+					textual_flow_ancestor_found = true;
+					textual_flow_arc a;
+					a.ancestor = ra.index;
+					a.type = flow_type::EQUAL;
+					a.connectivity = ra.rank;
+					a.strength = ra.strength;
+					arcs.push_back(a);
+					break;
+				}
+			}
+		}
+		//If the witness is lacunose or it does not have a potential ancestor that agrees with it within the connectivity limit,
+		//then each potential ancestor with a distinct reading within the connectivity limit is a textual flow ancestor:
+		if (!textual_flow_ancestor_found) {
+			vector<int> distinct_rdg_inds = vector<int>();
+			for (const ranked_ancestor & ra : wit_ranked_ancestors) {
+				//If we reach the connectivity limit, then exit the loop early:
+				if (ra.rank == connectivity) {
+					break;
+				}
+				int ancestor_rdg_ind = rdg_inds[ra.index];
+				if (ancestor_rdg_ind < 0) {
+					continue;
+				}
+				bool new_rdg = true;
+				for (int rdg_ind : distinct_rdg_inds) {
+					if (equal_flow[ancestor_rdg_ind * n_rdgs + rdg_ind]) {
+						new_rdg = false;
+						break;
+					}
+				}
+				if (new_rdg) {
+					distinct_rdg_inds.push_back(ancestor_rdg_ind);
+					textual_flow_arc a;
+					a.ancestor = ra.index;
+					a.type = wit_rdg_ind < 0 ? flow_type::LOSS : flow_type::CHANGE;
+					a.connectivity = ra.rank;
+					a.strength = ra.strength;
+					arcs.push_back(a);
+				}
+			}
+		}
+		arc_offsets.push_back((unsigned int) arcs.size());
+	}
+	//No edges end at potential ancestors that are not among the witnesses:
+	arc_offsets.resize(ids.size() + 1, (unsigned int) arcs.size());
+	return textual_flow(vu.get_label(), vu.get_readings(), connectivity, ids, n_witnesses, rdgs, rdg_inds, arc_offsets, arcs);
+}
+
+/**
+ * Constructs a textual flow instance for the given variation unit,
+ * using the variation unit's default connectivity value as the connectivity value.
+ */
+textual_flow textual_flow_builder::get_textual_flow(const variation_unit & vu) const {
+	return get_textual_flow(vu, vu.get_connectivity());
+}
+
+/**
+ * Constructs textual flow instances for the given variation unit at each of the given connectivity limits,
+ * returning them in the same order as the connectivity limits.
+ * Rather than scanning each witness's potential ancestors once per connectivity limit,
+ * this scans them once, recording the position of the first ancestor that agrees with the witness
+ * and the positions of the ancestors that introduce distinct readings;
+ * the textual flow ancestors at any connectivity limit are then the recorded ancestors whose ranks fall under that limit.
+ */
+vector<textual_flow> textual_flow_builder::get_textual_flow_sweep(const variation_unit & vu, const vector<int> & connectivities) const {
+	vector<string> rdgs;
+	vector<int> rdg_inds;
+	vector<bool> equal_flow;
+	index_readings(vu, rdgs, rdg_inds, equal_flow);
+	unsigned int n_rdgs = (unsigned int) rdgs.size();
+	//A negative connectivity limit is never reached, so it is equivalent to absolute connectivity:
+	int max_connectivity = -1;
+	for (int connectivity : connectivities) {
+		if (connectivity < 0) {
+			max_connectivity = -1;
+			break;
+		}
+		max_connectivity = max(max_connectivity, connectivity);
+	}
+	//Then scan each witness's potential ancestors once, up to the largest connectivity limit:
+	vector<int> equal_positions = vector<int>(n_witnesses, -1);
+	vector<vector<unsigned int>> distinct_positions = vector<vector<unsigned int>>(n_witnesses);
+	for (unsigned int wit_ind = 0; wit_ind < n_witnesses; wit_ind++) {
+		int wit_rdg_ind = rdg_inds[wit_ind];
+		const vector<ranked_ancestor> & wit_ranked_ancestors = ranked_ancestors[wit_ind];
+		vector<int> distinct_rdg_inds = vector<int>();
+		for (unsigned int pos = 0; pos < wit_ranked_ancestors.size(); pos++) {
+			const ranked_ancestor & ra = wit_ranked_ancestors[pos];
+			if (ra.rank == max_connectivity) {
+				break;
+			}
+			int ancestor_rdg_ind = rdg_inds[ra.index];
+			if (ancestor_rdg_ind < 0) {
+				continue;
+			}
+			//Record the first potential ancestor that agrees with this witness:
+			if (wit_rdg_ind >= 0 && equal_positions[wit_ind] < 0 && equal_flow[ancestor_rdg_ind * n_rdgs + wit_rdg_ind]) {
+				equal_positions[wit_ind] = (int) pos;
+			}
+			//Record each potential ancestor that has a reading we haven't encountered yet:
+			bool new_rdg = true;
+			for (int rdg_ind : distinct_rdg_inds) {
+				if (equal_flow[ancestor_rdg_ind * n_rdgs + rdg_ind]) {
+					new_rdg = false;
+					break;
+				}
+			}
+			if (new_rdg) {
+				distinct_rdg_inds.push_back(ancestor_rdg_ind);
+				distinct_positions[wit_ind].push_back(pos);
+			}
+		}
+	}
+	//Then add the edges for each connectivity limit:
+	vector<textual_flow> textual_flows = vector<textual_flow>();
+	textual_flows.reserve(connectivities.size());
+	for (int connectivity : connectivities) {
+		vector<unsigned int> arc_offsets = vector<unsigned int>(1, 0);
+		vector<textual_flow_arc> arcs = vector<textual_flow_arc>();
+		for (unsigned int wit_ind = 0; wit_ind < n_witnesses; wit_ind++) {
+			const vector<ranked_ancestor> & wit_ranked_ancestors = ranked_ancestors[wit_ind];
+			//If the first agreeing ancestor falls within the connectivity limit, then it is the only textual flow ancestor:
+			int equal_pos = equal_positions[wit_ind];
+			if (equal_pos >= 0 && (connectivity < 0 || wit_ranked_ancestors[equal_pos].rank < connectivity)) {
+				const ranked_ancestor & ra = wit_ranked_ancestors[equal_pos];
+				textual_flow_arc a;
+				a.ancestor = ra.index;
+				a.type = flow_type::EQUAL;
+				a.connectivity = ra.rank;
+				a.strength = ra.strength;
+				arcs.push_back(a);
+				arc_offsets.push_back((unsigned int) arcs.size());
+				continue;
+			}
+			//Otherwise, each ancestor with a distinct reading within the connectivity limit is a textual flow ancestor:
+			for (unsigned int pos : distinct_positions[wit_ind]) {
+				const ranked_ancestor & ra = wit_ranked_ancestors[pos];
+				if (connectivity >= 0 && ra.rank >= connectivity) {
+					break;
+				}
+				textual_flow_arc a;
+				a.ancestor = ra.index;
+				a.type = rdg_inds[wit_ind] < 0 ? flow_type::LOSS : flow_type::CHANGE;
+				a.connectivity = ra.rank;
+				a.strength = ra.strength;
+				arcs.push_back(a);
+			}
+			arc_offsets.push_back((unsigned int) arcs.size());
+		}
+		arc_offsets.resize(ids.size() + 1, (unsigned int) arcs.size());
+		textual_flows.push_back(textual_flow(vu.get_label(), vu.get_readings(), connectivity, ids, n_witnesses, rdgs, rdg_inds, arc_offsets, arcs));
+	}
+	return textual_flows;
+}
+
+/**
+ * Constructs textual flow instances for all of the given variation units with the given connectivity limit,
+ * returning them in the same order as the variation units.
+ * The textual flow for each variation unit is independent of the others, so they are constructed in parallel over this builder's worker threads.
+ */
+vector<textual_flow> textual_flow_builder::get_textual_flows(const vector<variation_unit> & vus, int connectivity) const {
+	vector<textual_flow> textual_flows = vector<textual_flow>(vus.size());
+	pool->parallel_for((unsigned int) vus.size(), [&](unsigned int i) {
+		textual_flows[i] = get_textual_flow(vus[i], connectivity);
+	});
+	return textual_flows;
+}
+
+/**
+ * Constructs textual flow instances for all of the given variation units, using each variation unit's default connectivity value,
+ * and returns them in the same order as the variation units.
+ * The textual flow for each variation unit is independent of the others, so they are constructed in parallel over this builder's worker threads.
+ */
+vector<textual_flow> textual_flow_builder::get_textual_flows(const vector<variation_unit> & vus) const {
+	vector<textual_flow> textual_flows = vector<textual_flow>(vus.size());
+	pool->parallel_for((unsigned int) vus.size(), [&](unsigned int i) {
+		textual_flows[i] = get_textual_flow(vus[i]);
+	});
+	return textual_flows;
+}
+
+/**
+ * Constructs textual flow instances for all of the given variation units at each of the given connectivity limits,
+ * returning, for each variation unit in order, its textual flow instances in the same order as the connectivity limits.
+ * The variation units are processed in parallel over this builder's worker threads.
+ */
+vector<vector<textual_flow>> textual_flow_builder::get_textual_flow_sweeps(const vector<variation_unit> & vus, const vector<int> & connectivities) const {
+	vector<vector<textual_flow>> textual_flow_sweeps = vector<vector<textual_flow>>(vus.size());
+	pool->parallel_for((unsigned int) vus.size(), [&](unsigned int i) {
+		textual_flow_sweeps[i] = get_textual_flow_sweep(vus[i], connectivities);
+	});
+	return textual_flow_sweeps;
+}
+
+/**
+ * Given a .dot writer, writes the textual flow diagrams for all of the given variation units (using their default connectivity values)
+ * to it in .dot format, one graph after another, in the same order as the variation units.
+ * The diagrams are constructed and serialized in parallel over this builder's worker threads, a batch at a time,
+ * and each batch is written in order, so the output is the same for any number of threads.
+ */
+void textual_flow_builder::textual_flows_to_dot(dot_writer & writer, const vector<variation_unit> & vus, bool flow_strengths) const {
+	unsigned int n = (unsigned int) vus.size();
+	unsigned int batch_size = 4 * pool->size();
+	vector<string> batch = vector<string>(batch_size);
+	for (unsigned int start = 0; start < n; start += batch_size) {
+		unsigned int end = start + batch_size < n ? start + batch_size : n;
+		pool->parallel_for(end - start, [&](unsigned int i) {
+			textual_flow tf = get_textual_flow(vus[start + i]);
+			stringstream ss;
+			dot_writer diagram_writer(ss);
+			tf.textual_flow_to_dot(diagram_writer, flow_strengths);
+			diagram_writer.flush();
+			batch[i] = ss.str();
+		});
+		for (unsigned int i = 0; i < end - start; i++) {
+			writer.write(batch[i]);
+		}
+	}
+	return;
+}
+
+/**
+ * Prints the textual flow diagrams for all of the given variation units (using their default connectivity values)
+ * to the given output stream in .dot format, one graph after another, in the same order as the variation units.
+ */
+void textual_flow_builder::textual_flows_to_dot(ostream & out, const vector<variation_unit> & vus, bool flow_strengths) const {
+	dot_writer writer(out);
+	textual_flows_to_dot(writer, vus, flow_strengths);
+	return;
+}
+
+/**
+ * Given a JSON writer, writes the textual flow diagrams for all of the given variation units (using their default connectivity values)
+ * to it as a JSON array, in the same order as the variation units.
+ * The diagrams are constructed and serialized in parallel over this builder's worker threads, a batch at a time,
+ * and each batch is written in order, so the output is the same for any number of threads.
+ */
+void textual_flow_builder::textual_flows_to_json(json_writer & writer, const vector<variation_unit> & vus) const {
+	unsigned int n = (unsigned int) vus.size();
+	unsigned int batch_size = 4 * pool->size();
+	vector<string> batch = vector<string>(batch_size);
+	writer.begin_array();
+	for (unsigned int start = 0; start < n; start += batch_size) {
+		unsigned int end = start + batch_size < n ? start + batch_size : n;
+		pool->parallel_for(end - start, [&](unsigned int i) {
+			textual_flow tf = get_textual_flow(vus[start + i]);
+			stringstream ss;
+			json_writer diagram_writer(ss);
+			tf.textual_flow_to_json(diagram_writer);
+			diagram_writer.flush();
+			batch[i] = ss.str();
+		});
+		for (unsigned int i = 0; i < end - start; i++) {
+			writer.raw_value(batch[i]);
+		}
+	}
+	writer.end_array();
+	return;
+}
+
+/**
+ * Prints the textual flow diagrams for all of the given variation units (using their default connectivity values)
+ * to the given output stream as a JSON array, in the same order as the variation units.
+ */
+void textual_flow_builder::textual_flows_to_json(ostream & out, const vector<variation_unit> & vus) const {
+	json_writer writer(out);
+	textual_flows_to_json(writer, vus);
+	return;
+}
+
+/**
+ * Given a JSON writer, writes one record per given variation unit to it in newline-delimited JSON (NDJSON) format,
+ * in the same order as the variation units.
+ * Each record is a JSON object on its own line holding the variation unit's ID and label, its local stemma, and its textual flow diagram (using its default connectivity value).
+ * Optional flags indicating whether to add the coherence in attestations diagrams for all readings and the coherence in variant passages diagram to each record can also be specified.
+ * The records are constructed and serialized in parallel over this builder's worker threads, a batch at a time,
+ * and each batch is written in order, so the output is the same for any number of threads.
+ */
+void textual_flow_builder::textual_flows_to_ndjson(json_writer & writer, const vector<variation_unit> & vus, bool attestations, bool variant_passages) const {
+	unsigned int n = (unsigned int) vus.size();
+	unsigned int batch_size = 4 * pool->size();
+	vector<string> batch = vector<string>(batch_size);
+	for (unsigned int start = 0; start < n; start += batch_size) {
+		unsigned int end = start + batch_size < n ? start + batch_size : n;
+		pool->parallel_for(end - start, [&](unsigned int i) {
+			const variation_unit & vu = vus[start + i];
+			textual_flow tf = get_textual_flow(vu);
+			stringstream ss;
+			json_writer record_writer(ss);
+			record_writer.begin_object();
+			record_writer.key("id");
+			record_writer.value(vu.get_id());
+			record_writer.key("label");
+			record_writer.value(vu.get_label());
+			record_writer.key("local_stemma");
+			vu.get_local_stemma().to_json(record_writer);
+			record_writer.key("textual_flow");
+			tf.textual_flow_to_json(record_writer);
+			if (attestations) {
+				record_writer.key("coherence_in_attestations");
+				tf.coherence_in_all_attestations_to_json(record_writer);
+			}
+			if (variant_passages) {
+				record_writer.key("coherence_in_variant_passages");
+				tf.coherence_in_variant_passages_to_json(record_writer);
+			}
+			record_writer.end_object();
+			record_writer.flush();
+			batch[i] = ss.str();
+		});
+		for (unsigned int i = 0; i < end - start; i++) {
+			writer.raw_value(batch[i]);
+			writer.newline();
+		}
+	}
+	return;
+}
+
+/**
+ * Prints one record per given variation unit to the given output stream in newline-delimited JSON (NDJSON) format,
+ * in the same order as the variation units.
+ * Optional flags indicating whether to add the coherence in attestations diagrams for all readings and the coherence in variant passages diagram to each record can also be specified.
+ */
+void textual_flow_builder::textual_flows_to_ndjson(ostream & out, const vector<variation_unit> & vus, bool attestations, bool variant_passages) const {
+	json_writer writer(out);
+	textual_flows_to_ndjson(writer, vus, attestations, variant_passages);
+	return;
+}
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
 #include <unordered_map>
 #include <algorithm>
 #include <limits>
@@ -23,6 +24,73 @@
 using namespace std;
 using namespace roaring;
 
+/**
+ * Given a genealogical comparison, a variation unit, its index, and a flag indicating whether the "classic" calculation of costs and explained readings should be used,
+ * adds the index to the comparison's bitmaps according to the relationship between the primary and secondary witnesses' readings at the variation unit.
+ * Returns the cost contributed by the variation unit to the comparison, which the caller is responsible for adding.
+ */
+float compare_at_variation_unit(genealogical_comparison & comp, const variation_unit & vu, unsigned int vu_ind, bool classic) {
+	//Try to get the reading of each witness at this variation unit:
+	unordered_map<string, string> reading_support = vu.get_reading_support();
+	//If either witness is lacunose, then there is no relationship
+	//(including equality, as two lacunae should not be treated as equal):
+	if (reading_support.find(comp.primary_wit) == reading_support.end() || reading_support.find(comp.secondary_wit) == reading_support.end()) {
+		return 0;
+	}
+	//Otherwise, mark this passage as a place where both witnesses are extant
+	//and determine the relationship of their readings in the local stemma:
+	comp.extant.add(vu_ind);
+	string reading_for_this = reading_support.at(comp.primary_wit);
+	string reading_for_other = reading_support.at(comp.secondary_wit);
+	local_stemma ls = vu.get_local_stemma();
+	//If either witness's reading agrees with the other's, then we can move on:
+	if (ls.readings_agree(reading_for_this, reading_for_other)) {
+		comp.agreements.add(vu_ind);
+		comp.explained.add(vu_ind);
+		return 0;
+	}
+	float cost = 0;
+	//Otherwise, because we allow for cycles in the local stemma, it is necessary to check for a non-trivial path between the readings in both directions:
+	float path_length = numeric_limits<float>::infinity();
+	if (ls.path_exists(reading_for_this, reading_for_other) || ls.path_exists(reading_for_other, reading_for_this)) {
+		if (ls.path_exists(reading_for_this, reading_for_other)) {
+			comp.prior.add(vu_ind);
+		}
+		if (ls.path_exists(reading_for_other, reading_for_this)) {
+			path_length = ls.get_path(reading_for_other, reading_for_this).weight;
+			comp.posterior.add(vu_ind);
+			//The classic criterion is that only a reading equivalent or directly prior to another reading explains it:
+			if (classic) {
+				if (ls.get_path(reading_for_other, reading_for_this).cardinality <= 1) {
+					comp.explained.add(vu_ind);
+				}
+			}
+			//The open-cbgm criterion is more relaxed; any equivalent or prior reading explains another, 
+			//and the cost is equal to the length of the path from the prior reading to the posterior reading:
+			else {
+				comp.explained.add(vu_ind);
+				cost += path_length;
+			}
+		}
+	}
+	//If the readings have no path connecting them in either direction, then check if they have a common ancestor:
+	else {
+		//If they do, then they are known to have no directed relationship:
+		if (ls.common_ancestor_exists(reading_for_this, reading_for_other)) {
+			comp.norel.add(vu_ind);
+		}
+		//If they do not, then their relationship is unclear:
+		else {
+			comp.unclear.add(vu_ind);
+		}
+	}
+	//The classic calculation of costs is just 1 in the case of any disagreement:
+	if (classic) {
+		cost += 1;
+	}
+	return cost;
+}
+
 /**
  * Default constructor.
  */
@@ -53,92 +121,17 @@ witness::witness(const string & _id, const apparatus & app, bool classic) {
 		comp.unclear = Roaring();
 		comp.explained = Roaring();
 		comp.cost = 0;
+		//Compare the witnesses at each variation unit:
 		int vu_ind = 0;
 		for (variation_unit vu : app.get_variation_units()) {
-			//Try to get the reading of each witness at this variation unit:
-			unordered_map<string, string> reading_support = vu.get_reading_support();
-			//If either witness is lacunose, then there is no relationship
-			//(including equality, as two lacunae should not be treated as equal):
-			if (reading_support.find(id) == reading_support.end() || reading_support.find(other_id) == reading_support.end()) {
-				vu_ind++;
-				continue;
-			}
-			//Otherwise, mark this passage as a place where both witnesses are extant
-			//and determine the relationship of their readings in the local stemma:
-			comp.extant.add(vu_ind);
-			string reading_for_this = reading_support.at(id);
-			string reading_for_other = reading_support.at(other_id);
-			local_stemma ls = vu.get_local_stemma();
-			//If either witness's reading agrees with the other's, then we can move on:
-			if (ls.readings_agree(reading_for_this, reading_for_other)) {
-				comp.agreements.add(vu_ind);
-				comp.explained.add(vu_ind);
-				vu_ind++;
-				continue;
-			}
-			//Otherwise, because we allow for cycles in the local stemma, it is necessary to check for a non-trivial path between the readings in both directions:
-			float path_length = numeric_limits<float>::infinity();
-			if (ls.path_exists(reading_for_this, reading_for_other) || ls.path_exists(reading_for_other, reading_for_this)) {
-				if (ls.path_exists(reading_for_this, reading_for_other)) {
-					comp.prior.add(vu_ind);
-				}
-				if (ls.path_exists(reading_for_other, reading_for_this)) {
-					path_length = ls.get_path(reading_for_other, reading_for_this).weight;
-					comp.posterior.add(vu_ind);
-					//The classic criterion is that only a reading equivalent or directly prior to another reading explains it:
-					if (classic) {
-						if (ls.get_path(reading_for_other, reading_for_this).cardinality <= 1) {
-							comp.explained.add(vu_ind);
-						}
-					}
-					//The open-cbgm criterion is more relaxed; any equivalent or prior reading explains another, 
-					//and the cost is equal to the length of the path from the prior reading to the posterior reading:
-					else {
-						comp.explained.add(vu_ind);
-						comp.cost += path_length;
-					}
-				}
-			}
-			//If the readings have no path connecting them in either direction, then check if they have a common ancestor:
-			else {
-				//If they do, then they are known to have no directed relationship:
-				if (ls.common_ancestor_exists(reading_for_this, reading_for_other)) {
-					comp.norel.add(vu_ind);
-				}
-				//If they do not, then their relationship is unclear:
-				else {
-					comp.unclear.add(vu_ind);
-				}
-			}
-			//The classic calculation of costs is just 1 in the case of any disagreement:
-			if (classic) {
-				comp.cost += 1;
-			}
+			comp.cost += compare_at_variation_unit(comp, vu, vu_ind, classic);
 			vu_ind++;
 		}
 		//Add the completed genealogical_comparison to this witness's map:
 		genealogical_comparisons[other_id] = comp;
 	}
 	//Next, populate this witness's list of potential ancestors:
-	potential_ancestor_ids = list<string>();
-	//Start by constructing a list of genealogical comparisons with all other witnesses:
-	list<genealogical_comparison> comps = list<genealogical_comparison>();
-	for (string other_id : list_wit) {
-		genealogical_comparison comp = genealogical_comparisons.at(other_id);
-		comps.push_back(comp);
-	}
-	//Then sort this list by number of agreements:
-	comps.sort([](const genealogical_comparison & c1, const genealogical_comparison & c2) {
-		return c1.agreements.cardinality() > c2.agreements.cardinality();
-	});
-	//Now iterate through the sorted list,
-	//copying only the IDs of the witnesses that are genealogically prior to this witness:
-	for (genealogical_comparison comp : comps) {
-		string other_id = comp.secondary_wit;
-		if (comp.posterior.cardinality() > comp.prior.cardinality()) {
-			potential_ancestor_ids.push_back(other_id);
-		}
-	}
+	populate_potential_ancestor_ids(list_wit);
 	//Initialize the stemmatic ancestors list as empty:
 	stemmatic_ancestor_ids = list<string>();
 }
@@ -158,9 +151,34 @@ witness::witness(const string & _id, const list<genealogical_comparison> & _gene
 		genealogical_comparisons[other_id] = comp;
 	}
 	//Next, populate this witness's list of potential ancestors:
+	list<string> other_ids = list<string>();
+	for (const genealogical_comparison & comp : _genealogical_comparisons) {
+		other_ids.push_back(comp.secondary_wit);
+	}
+	populate_potential_ancestor_ids(other_ids);
+	//Initialize the stemmatic ancestors list as empty:
+	stemmatic_ancestor_ids = list<string>();
+}
+
+/**
+ * Default destructor.
+ */
+witness::~witness() {
+
+}
+
+/**
+ * Populates this witness's list of potential ancestors from its genealogical comparisons with the witnesses whose IDs are given,
+ * sorting them by number of agreements (with ties broken by the order of the given IDs).
+ */
+void witness::populate_potential_ancestor_ids(const list<string> & other_ids) {
 	potential_ancestor_ids = list<string>();
 	//Start by constructing a list of genealogical comparisons with all other witnesses:
-	list<genealogical_comparison> comps = list<genealogical_comparison>(_genealogical_comparisons);
+	list<genealogical_comparison> comps = list<genealogical_comparison>();
+	for (string other_id : other_ids) {
+		genealogical_comparison comp = genealogical_comparisons.at(other_id);
+		comps.push_back(comp);
+	}
 	//Then sort this list by number of agreements:
 	comps.sort([](const genealogical_comparison & c1, const genealogical_comparison & c2) {
 		return c1.agreements.cardinality() > c2.agreements.cardinality();
@@ -173,15 +191,7 @@ witness::witness(const string & _id, const list<genealogical_comparison> & _gene
 			potential_ancestor_ids.push_back(other_id);
 		}
 	}
-	//Initialize the stemmatic ancestors list as empty:
-	stemmatic_ancestor_ids = list<string>();
-}
-
-/**
- * Default destructor.
- */
-witness::~witness() {
-
+	return;
 }
 
 /**
@@ -205,6 +215,15 @@ genealogical_comparison witness::get_genealogical_comparison_for_witness(const s
 	return genealogical_comparisons.at(other_id);
 }
 
+/**
+ * Returns a constant reference to the genealogical comparison between this witness and the witness with the given ID,
+ * so that callers that only read it (e.g., for its cardinalities) do not copy its bitmaps.
+ * The reference is valid as long as this witness is and its genealogical comparisons are not updated.
+ */
+const genealogical_comparison & witness::get_genealogical_comparison_ref(const string & other_id) const {
+	return genealogical_comparisons.at(other_id);
+}
+
 /**
  * Returns a list of this witness's potential ancestors' IDs, sorted by pregenealogical coherence.
  */
@@ -213,18 +232,14 @@ list<string> witness::get_potential_ancestor_ids() const {
 }
 
 /**
- * Returns a list of all minimum-cost substemmata for this witness.
- * Optionally, an upper bound on substemma cost can be specified,
- * in which case all substemmata within that cost bound will be returned.
- * A boolean flag indicating whether a single solution is desired can also be specified,
- * in which case the cost bound will be ignored and an optimized version of the branch-and-bound procedure will be used.
+ * Returns a vector of set cover rows for the genealogical comparisons with this witness's potential ancestors,
+ * sorted by increasing cost and decreasing number of agreements.
  */
- list<set_cover_solution> witness::get_substemmata(float ub, bool single_solution) const {
-	list<set_cover_solution> substemmata = list<set_cover_solution>();
+vector<set_cover_row> witness::get_set_cover_rows() const {
 	//Populate a vector of set cover rows using genealogical comparisons with this witness's potential ancestors:
 	vector<set_cover_row> rows = vector<set_cover_row>();
 	for (string ancestor_id : potential_ancestor_ids) {
-		genealogical_comparison comp = genealogical_comparisons.at(ancestor_id);
+		const genealogical_comparison & comp = genealogical_comparisons.at(ancestor_id);
 		set_cover_row row;
 		row.id = ancestor_id;
 		row.agreements = comp.agreements;
@@ -236,13 +251,177 @@ list<string> witness::get_potential_ancestor_ids() const {
 	stable_sort(begin(rows), end(rows), [](const set_cover_row & r1, const set_cover_row & r2) {
 		return r1.cost < r2.cost ? true : (r1.cost > r2.cost ? false : (r1.agreements.cardinality() > r2.agreements.cardinality()));
 	});
+	return rows;
+}
+
+/**
+ * Returns a list of all minimum-cost substemmata for this witness.
+ * Optionally, an upper bound on substemma cost can be specified,
+ * in which case all substemmata within that cost bound will be returned.
+ * A boolean flag indicating whether a single solution is desired can also be specified,
+ * in which case the cost bound will be ignored and an optimized version of the branch-and-bound procedure will be used.
+ */
+ list<set_cover_solution> witness::get_substemmata(float ub, bool single_solution) const {
+	set_cover_solver_stats stats;
+	return get_substemmata(ub, single_solution, stats);
+ }
+
+/**
+ * Returns a list of substemmata for this witness, as get_substemmata does with the same upper bound and single solution flag,
+ * and populates the given data structure with statistics on the set cover search that produced them.
+ */
+list<set_cover_solution> witness::get_substemmata(float ub, bool single_solution, set_cover_solver_stats & stats) const {
+	list<set_cover_solution> substemmata = list<set_cover_solution>();
+	vector<set_cover_row> rows = get_set_cover_rows();
 	//Initialize the bitmap of the target set to be covered:
 	Roaring target = genealogical_comparisons.at(id).extant;
 	//Then populate the rows of this table using the solver:
 	set_cover_solver solver = (ub > 0 && !single_solution) ? set_cover_solver(rows, target, ub) : set_cover_solver(rows, target);
 	solver.solve(substemmata, single_solution);
+	stats = solver.get_stats();
 	return substemmata;
- }
+}
+
+/**
+ * Returns a list containing a single minimum-cost substemma for this witness, as get_substemmata does with the single solution flag set,
+ * using the given list of witness IDs (e.g., the witness's stemmatic ancestors before an edit to the apparatus) to warm-start the search.
+ * If these witnesses no longer constitute a substemma, then the search proceeds as if they had not been given.
+ * The given data structure is populated with statistics on the set cover search.
+ */
+list<set_cover_solution> witness::get_warm_started_substemmata(const list<string> & warm_start_ids, set_cover_solver_stats & stats) const {
+	list<set_cover_solution> substemmata = list<set_cover_solution>();
+	vector<set_cover_row> rows = get_set_cover_rows();
+	Roaring target = genealogical_comparisons.at(id).extant;
+	//Map the warm-start IDs to their row indices, ignoring them altogether if any of them is no longer a potential ancestor:
+	unordered_map<string, unsigned int> row_ids_to_inds = unordered_map<string, unsigned int>();
+	for (unsigned int i = 0; i < rows.size(); i++) {
+		row_ids_to_inds[rows[i].id] = i;
+	}
+	Roaring warm_start_rows = Roaring();
+	for (const string & warm_start_id : warm_start_ids) {
+		if (row_ids_to_inds.find(warm_start_id) == row_ids_to_inds.end()) {
+			warm_start_rows = Roaring();
+			break;
+		}
+		warm_start_rows.add(row_ids_to_inds.at(warm_start_id));
+	}
+	set_cover_solver solver = set_cover_solver(rows, target);
+	solver.solve(substemmata, true, warm_start_rows);
+	stats = solver.get_stats();
+	return substemmata;
+}
+
+/**
+ * Returns a list of at most the given number of lowest-cost substemmata for this witness, sorted in the same order as in get_substemmata.
+ * Optionally, an upper bound on substemma cost can be specified, in which case only substemmata within that cost bound will be considered.
+ * Redundant substemmata (i.e., supersets of cheaper substemmata) are included, so the list is not limited to the minimum-cost substemmata.
+ */
+list<set_cover_solution> witness::get_cheapest_substemmata(unsigned int max_substemmata, float ub) const {
+	list<set_cover_solution> substemmata = list<set_cover_solution>();
+	vector<set_cover_row> rows = get_set_cover_rows();
+	Roaring target = genealogical_comparisons.at(id).extant;
+	set_cover_solver solver = set_cover_solver(rows, target, ub > 0 ? ub : numeric_limits<float>::infinity());
+	solver.solve_cheapest(substemmata, max_substemmata);
+	return substemmata;
+}
+
+/**
+ * Returns a lazy enumerator over all substemmata for this witness with costs within the given upper bound.
+ * Unlike get_substemmata, this does not store or sort the substemmata, so it can be used to stream them out when the bound is generous
+ * (e.g., by an optimize substemmata table constructed from it).
+ */
+set_cover_solution_enumerator witness::get_substemmata_enumerator(float ub) const {
+	vector<set_cover_row> rows = get_set_cover_rows();
+	Roaring target = genealogical_comparisons.at(id).extant;
+	return set_cover_solution_enumerator(rows, target, ub);
+}
+
+/**
+ * Updates this witness's genealogical comparisons after changes to the variation units at the indices in the given maps,
+ * which contain the variation units before and after the changes, respectively.
+ * The given vector should contain all of the variation units after the changes; the costs of comparisons that change are summed again over it,
+ * so that they are exactly the costs that constructing the witness from scratch would compute.
+ * The given list of witness IDs should be the apparatus's list_wit member; it is used to break ties in the order of potential ancestors.
+ * An optional flag indicates whether the "classic" calculation of costs and explained readings should be used;
+ * it should be the same flag used to construct this witness.
+ * Only the changed variation units are compared again, so this is much faster than constructing the witness from scratch.
+ * Returns a value indicating whether the changes left the comparisons unchanged, changed them without affecting the set cover problem for this witness's substemmata,
+ * or changed the set cover problem (i.e., its target set or the explained passages, agreements, costs, or order of its rows), in which case the substemmata should be optimized again.
+ */
+genealogical_comparison_update witness::update_genealogical_comparisons(const list<string> & list_wit, const map<unsigned int, variation_unit> & old_vus, const map<unsigned int, variation_unit> & new_vus, const vector<variation_unit> & vus, bool classic) {
+	vector<set_cover_row> old_rows = get_set_cover_rows();
+	Roaring old_target = genealogical_comparisons.at(id).extant;
+	bool comparisons_changed = false;
+	for (pair<const string, genealogical_comparison> & kv : genealogical_comparisons) {
+		genealogical_comparison & comp = kv.second;
+		bool cost_changed = false;
+		for (const pair<const unsigned int, variation_unit> & kv_vu : new_vus) {
+			unsigned int vu_ind = kv_vu.first;
+			//Compare the witnesses at this variation unit before and after the change, in isolation:
+			genealogical_comparison old_unit_comp;
+			old_unit_comp.primary_wit = comp.primary_wit;
+			old_unit_comp.secondary_wit = comp.secondary_wit;
+			float old_unit_cost = compare_at_variation_unit(old_unit_comp, old_vus.at(vu_ind), vu_ind, classic);
+			genealogical_comparison new_unit_comp;
+			new_unit_comp.primary_wit = comp.primary_wit;
+			new_unit_comp.secondary_wit = comp.secondary_wit;
+			float new_unit_cost = compare_at_variation_unit(new_unit_comp, kv_vu.second, vu_ind, classic);
+			//If nothing changed for this pair of witnesses, then leave the comparison as it is
+			//(so that its cost does not have to be summed again):
+			if (old_unit_cost == new_unit_cost && old_unit_comp.extant == new_unit_comp.extant && old_unit_comp.agreements == new_unit_comp.agreements
+				&& old_unit_comp.prior == new_unit_comp.prior && old_unit_comp.posterior == new_unit_comp.posterior && old_unit_comp.norel == new_unit_comp.norel
+				&& old_unit_comp.unclear == new_unit_comp.unclear && old_unit_comp.explained == new_unit_comp.explained) {
+				continue;
+			}
+			//Otherwise, replace the old contribution of this variation unit with the new one:
+			comp.extant.remove(vu_ind);
+			comp.agreements.remove(vu_ind);
+			comp.prior.remove(vu_ind);
+			comp.posterior.remove(vu_ind);
+			comp.norel.remove(vu_ind);
+			comp.unclear.remove(vu_ind);
+			comp.explained.remove(vu_ind);
+			comp.extant |= new_unit_comp.extant;
+			comp.agreements |= new_unit_comp.agreements;
+			comp.prior |= new_unit_comp.prior;
+			comp.posterior |= new_unit_comp.posterior;
+			comp.norel |= new_unit_comp.norel;
+			comp.unclear |= new_unit_comp.unclear;
+			comp.explained |= new_unit_comp.explained;
+			cost_changed = cost_changed || old_unit_cost != new_unit_cost;
+			comparisons_changed = true;
+		}
+		//If the cost changed, then sum it again in the same order as the constructor, so that it is exactly the cost a rebuild would compute
+		//(only the passages where the witnesses disagree can contribute to it, and adding the zero costs of the others would not change the sum):
+		if (cost_changed) {
+			Roaring cost_passages = classic ? comp.extant - comp.agreements : comp.posterior;
+			comp.cost = 0;
+			for (Roaring::const_iterator it = cost_passages.begin(); it != cost_passages.end(); it++) {
+				genealogical_comparison unit_comp;
+				unit_comp.primary_wit = comp.primary_wit;
+				unit_comp.secondary_wit = comp.secondary_wit;
+				comp.cost += compare_at_variation_unit(unit_comp, vus[*it], *it, classic);
+			}
+		}
+	}
+	if (!comparisons_changed) {
+		return genealogical_comparison_update::UNCHANGED;
+	}
+	//Then repopulate this witness's list of potential ancestors and check if the set cover problem for its substemmata changed:
+	populate_potential_ancestor_ids(list_wit);
+	vector<set_cover_row> new_rows = get_set_cover_rows();
+	if (!(genealogical_comparisons.at(id).extant == old_target) || new_rows.size() != old_rows.size()) {
+		return genealogical_comparison_update::SET_COVER_CHANGED;
+	}
+	for (unsigned int i = 0; i < new_rows.size(); i++) {
+		const set_cover_row & old_row = old_rows[i];
+		const set_cover_row & new_row = new_rows[i];
+		if (new_row.id != old_row.id || new_row.cost != old_row.cost || !(new_row.agreements == old_row.agreements) || !(new_row.explained == old_row.explained)) {
+			return genealogical_comparison_update::SET_COVER_CHANGED;
+		}
+	}
+	return genealogical_comparison_update::COMPARISONS_CHANGED;
+}
 
 /**
  * Populates this witness's substemma with the witness IDs in the given list.
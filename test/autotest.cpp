@@ -6,15 +6,21 @@
  */
 
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <list>
+#include <stack>
 #include <vector>
 #include <set>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
 #include <limits>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
 
 #include "cxxopts.hpp"
 #include "config.h" //generated by cmake using template config.h.in
@@ -22,9 +28,22 @@
 #include <roaring/roaring.hh>
 #include "pugixml.hpp"
 #include "global_stemma.h"
+#include "global_stemma_pipeline.h"
+#include "substemma_checkpoint.h"
 #include "textual_flow.h"
+#include "textual_flow_builder.h"
+#include "coherence_metrics_table.h"
+#include "compare_witnesses_table.h"
+#include "comparison_matrix.h"
+#include "enumerate_relationships_table.h"
+#include "find_relatives_table.h"
+#include "find_relatives_wide_table.h"
 #include "witness.h"
 #include "set_cover_solver.h"
+#include "dense_bitset.h"
+#include "parallel_for.h"
+#include "json_writer.h"
+#include "dot_writer.h"
 #include "apparatus.h"
 #include "variation_unit.h"
 #include "local_stemma.h"
@@ -176,6 +195,234 @@ void autotest::run() {
 			}
 			mod_test.units.push_back(u_test);
 		}
+		/**
+		 * Unit common_dense_bitset
+		 */
+		current_unit = "common_dense_bitset";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Populate two bitsets that span multiple words:
+				dense_bitset<2> bs1 = dense_bitset<2>();
+				bs1.add(0);
+				bs1.add(63);
+				bs1.add(64);
+				dense_bitset<2> bs2 = dense_bitset<2>();
+				bs2.add(63);
+				bs2.add(127);
+				if (!bs1.contains(64) || bs1.contains(127)) {
+					u_test.msg += "Expected bs1 to contain 64 but not 127\n";
+				}
+				//Neither should be a subset of the other, but both should be subsets of their union:
+				if (bs1.is_subset(bs2) || bs2.is_subset(bs1)) {
+					u_test.msg += "Expected bs1.is_subset(bs2) || bs2.is_subset(bs1) == false, got true\n";
+				}
+				dense_bitset<2> bs_union = dense_bitset<2>(bs1);
+				bs_union |= bs2;
+				if (!bs1.is_subset(bs_union) || !bs2.is_subset(bs_union)) {
+					u_test.msg += "Expected bs1.is_subset(bs_union) && bs2.is_subset(bs_union) == true, got false\n";
+				}
+				if (!bs_union.contains(0) || !bs_union.contains(127)) {
+					u_test.msg += "Expected bs_union to contain 0 and 127\n";
+				}
+				//Clearing the union should leave a subset of every bitset:
+				bs_union.clear();
+				if (!bs_union.is_subset(bs2) || bs_union.contains(63)) {
+					u_test.msg += "Expected a cleared bs_union to be empty\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit common_parallel_for
+		 */
+		current_unit = "common_parallel_for";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Each index should be visited exactly once, with its result written to its own slot:
+				unsigned int n = 1000;
+				vector<unsigned int> squares = vector<unsigned int>(n, 0);
+				parallel_for(n, 4, [&](unsigned int i) {
+					squares[i] += i * i;
+				});
+				unsigned int n_wrong = 0;
+				for (unsigned int i = 0; i < n; i++) {
+					if (squares[i] != i * i) {
+						n_wrong++;
+					}
+				}
+				if (n_wrong > 0) {
+					u_test.msg += "Expected squares[i] == i * i for all i, got " + to_string(n_wrong) + " wrong values\n";
+				}
+				//An exception thrown on a worker thread should be rethrown on the calling thread:
+				bool exception_rethrown = false;
+				try {
+					parallel_for(n, 4, [&](unsigned int i) {
+						if (i == n / 2) {
+							throw runtime_error("index " + to_string(i));
+						}
+					});
+				}
+				catch (const runtime_error & e) {
+					exception_rethrown = true;
+				}
+				if (!exception_rethrown) {
+					u_test.msg += "Expected parallel_for to rethrow the exception thrown by its body, but it did not\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit common_json_writer
+		 */
+		current_unit = "common_json_writer";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Write nested containers with strings that need escaping and numbers that need formatting,
+				//once with the default buffer and once with a buffer small enough to be flushed after every value:
+				string expected_json = "{\"s\":\"a\\\"b\\\\c\\n\\u0001\",\"n\":[1,-2,0.1,0.1,1.5,null,null],\"b\":true,\"e\":{},\"a\":[]}";
+				for (size_t buffer_size : {(size_t) 65536, (size_t) 1}) {
+					stringstream ss;
+					json_writer writer(ss, buffer_size);
+					writer.begin_object();
+					writer.key("s");
+					writer.value(string("a\"b\\c\n\x01"));
+					writer.key("n");
+					writer.begin_array();
+					writer.value(1);
+					writer.value(-2);
+					writer.value(0.1f);
+					writer.value(0.1);
+					writer.value(1.5f);
+					writer.value(numeric_limits<float>::infinity());
+					writer.null_value();
+					writer.end_array();
+					writer.key("b");
+					writer.value(true);
+					writer.key("e");
+					writer.begin_object();
+					writer.end_object();
+					writer.key("a");
+					writer.begin_array();
+					writer.end_array();
+					writer.end_object();
+					writer.flush();
+					string json = ss.str();
+					if (json != expected_json) {
+						u_test.msg += "Expected JSON " + expected_json + " with a buffer of size " + to_string(buffer_size) + ", got " + json + "\n";
+					}
+				}
+				//Numbers should be written in the shortest form that reads back as the same number:
+				float x = 2.0f / 3.0f;
+				string formatted_x = json_writer::format_number(x);
+				if (strtof(formatted_x.c_str(), nullptr) != x || formatted_x.size() > 11) {
+					u_test.msg += "Expected a representation of 2/3 in single precision that reads back as the same number, got " + formatted_x + "\n";
+				}
+				double y = 1.0 / 3.0;
+				string formatted_y = json_writer::format_number(y);
+				if (strtod(formatted_y.c_str(), nullptr) != y) {
+					u_test.msg += "Expected a representation of 1/3 in double precision that reads back as the same number, got " + formatted_y + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit common_dot_writer
+		 */
+		current_unit = "common_dot_writer";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Write a small graph with edges with and without attributes,
+				//once with the default buffer and once with a buffer small enough to be flushed after every write:
+				string expected_dot = "digraph g {\n\t\t0 [label=\"A\"];\n\t\t0 -> 12 [len=0.500000, style=dotted];\n\t\t-3 -> 4 [];\n\t\t4 -> 0 [label=\"2.250\", style=bold];\n}\n";
+				for (size_t buffer_size : {(size_t) 65536, (size_t) 1}) {
+					stringstream ss;
+					dot_writer writer(ss, buffer_size);
+					writer.write("digraph g {\n");
+					writer.write(string("\t\t"));
+					writer.write(0u);
+					writer.write(" [label=\"A\"];");
+					writer.write('\n');
+					writer.begin_edge(0, 12);
+					writer.attribute("len=");
+					writer.write_fixed(0.5, 6);
+					writer.attribute(dot_writer::strength_style(0.005f));
+					writer.end_edge();
+					writer.write("\t\t");
+					writer.write(-3);
+					writer.write(" -> 4 [];\n");
+					writer.begin_edge(4, 0);
+					writer.attribute(string("label=\""));
+					writer.write_fixed(2.25, 3);
+					writer.write('"');
+					writer.attribute(dot_writer::strength_style(0.5f));
+					writer.end_edge();
+					writer.write("}\n");
+					writer.flush();
+					string dot = ss.str();
+					if (dot != expected_dot) {
+						u_test.msg += "Expected .dot output\n" + expected_dot + "with a buffer of size " + to_string(buffer_size) + ", got\n" + dot;
+					}
+				}
+				//Anything left in the buffer should be written when the writer is destroyed:
+				stringstream destroyed_ss;
+				{
+					dot_writer writer(destroyed_ss);
+					writer.write("digraph g {}\n");
+				}
+				if (destroyed_ss.str() != "digraph g {}\n") {
+					u_test.msg += "Expected the buffer to be written when the writer is destroyed, got " + destroyed_ss.str() + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
 		lib_test.modules.push_back(mod_test);
 	}
 	/**
@@ -974,32 +1221,10 @@ void autotest::run() {
 			}
 			mod_test.units.push_back(u_test);
 		}
-		lib_test.modules.push_back(mod_test);
-	}
-	/**
-	 * Module witness
-	 */
-	current_module = "witness";
-	if (target_module.empty() || target_module == current_module) {
-		//Initialize a container for module-wide test results:
-		module_test mod_test;
-		mod_test.name = current_module;
-		mod_test.units = list<unit_test>();
-		//Then proceed for each unit test:
-		string current_unit;
-		//Do pre-test work:
-		pugi::xml_document doc;
-		doc.load_file(TEST_XML.c_str());
-		pugi::xml_node tei_node = doc.child("TEI");
-		bool merge_splits = false;
-		set<string> trivial_reading_types = set<string>({"defective", "orthographic"});
-		set<string> dropped_reading_types = set<string>({"ambiguous"});
-		list<string> ignored_suffixes = list<string>({"*", "T"});
-		apparatus app = apparatus(tei_node, merge_splits, trivial_reading_types, dropped_reading_types, ignored_suffixes);
 		/**
-		 * Unit witness_constructor_1
+		 * Unit set_cover_solver_get_greedy_solution_local_search
 		 */
-		current_unit = "witness_constructor_1";
+		current_unit = "set_cover_solver_get_greedy_solution_local_search";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1008,25 +1233,42 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				//Construct a new witness with genealogical relationships to all other witnesses:
-				witness wit = witness("A", app);
-				//Check that the ID is correct:
-				string expected_id = "A";
-				string id = wit.get_id();
-				if (id != expected_id) {
-					u_test.msg += "Expected witness ID to be " + expected_id + ", got " + id + "\n";
+				//Set up a problem where the greedy heuristic is fooled by the densest row:
+				vector<set_cover_row> ls_rows = vector<set_cover_row>();
+				set_cover_row row_p;
+				row_p.id = "P";
+				row_p.agreements = Roaring::bitmapOf(2, 0, 1);
+				row_p.explained = Roaring::bitmapOf(2, 0, 1);
+				row_p.cost = 1;
+				ls_rows.push_back(row_p);
+				set_cover_row row_q;
+				row_q.id = "Q";
+				row_q.agreements = Roaring::bitmapOf(2, 2, 3);
+				row_q.explained = Roaring::bitmapOf(2, 2, 3);
+				row_q.cost = 1;
+				ls_rows.push_back(row_q);
+				set_cover_row row_r;
+				row_r.id = "R";
+				row_r.agreements = Roaring::bitmapOf(3, 0, 1, 2);
+				row_r.explained = Roaring::bitmapOf(3, 0, 1, 2);
+				row_r.cost = 1.25;
+				ls_rows.push_back(row_r);
+				set_cover_solver ls_scs = set_cover_solver(ls_rows, target);
+				//Without local search, the greedy solution should consist of rows R and Q:
+				float expected_cost = 2.25;
+				float cost = ls_scs.bound(ls_scs.get_greedy_solution());
+				if (cost != expected_cost) {
+					u_test.msg += "Expected greedy_solution.cost == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
 				}
-				//Check that the size of the genealogical_comparison map is correct:
-				unsigned int expected_genealogical_comparisons_size = 5;
-				unsigned int genealogical_comparisons_size = (unsigned int) wit.get_genealogical_comparisons().size();
-				if (genealogical_comparisons_size != expected_genealogical_comparisons_size) {
-					u_test.msg += "Expected genealogical_comparisons.size() == " + to_string(expected_genealogical_comparisons_size) + ", got " + to_string(genealogical_comparisons_size) + "\n";
+				//With local search, row R should be swapped out for row P:
+				Roaring ls_solution_rows = ls_scs.get_greedy_solution(true);
+				expected_cost = 2;
+				cost = ls_scs.bound(ls_solution_rows);
+				if (cost != expected_cost) {
+					u_test.msg += "Expected greedy_solution.cost == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
 				}
-				//Check that the size of the potential ancestors list is correct:
-				unsigned int expected_potential_ancestor_ids_size = 0;
-				unsigned int potential_ancestor_ids_size = (unsigned int) wit.get_potential_ancestor_ids().size();
-				if (potential_ancestor_ids_size != expected_potential_ancestor_ids_size) {
-					u_test.msg += "Expected potential_ancestor_ids.size() == " + to_string(expected_potential_ancestor_ids_size) + ", got " + to_string(potential_ancestor_ids_size) + "\n";
+				if (ls_solution_rows.contains(2)) {
+					u_test.msg += "Expected greedy_solution_rows.contains(2) == false, got true\n";
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1038,9 +1280,9 @@ void autotest::run() {
 			mod_test.units.push_back(u_test);
 		}
 		/**
-		 * Unit witness_constructor_2
+		 * Unit set_cover_solver_branch_on_column
 		 */
-		current_unit = "witness_constructor_2";
+		current_unit = "set_cover_solver_branch_on_column";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1049,50 +1291,24 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				//Construct a new witness with genealogical relationships to one other witness using the copy constructor:
-				list<genealogical_comparison> comps = list<genealogical_comparison>();
-				genealogical_comparison comp_A;
-				comp_A.primary_wit = "B";
-				comp_A.secondary_wit = "A";
-				comp_A.extant = Roaring::bitmapOf(3, 0, 1, 2);
-				comp_A.agreements = Roaring::bitmapOf(2, 0, 1);
-				comp_A.prior = Roaring::bitmapOf(0);
-				comp_A.posterior = Roaring::bitmapOf(1, 2);
-				comp_A.norel = Roaring::bitmapOf(0);
-				comp_A.unclear = Roaring::bitmapOf(0);
-				comp_A.explained = Roaring::bitmapOf(3, 0, 1, 2);
-				comp_A.cost = 1;
-				comps.push_back(comp_A);
-				genealogical_comparison comp_B;
-				comp_B.primary_wit = "B";
-				comp_B.secondary_wit = "B";
-				comp_B.extant = Roaring::bitmapOf(4, 0, 1, 2, 3);
-				comp_B.agreements = Roaring::bitmapOf(4, 0, 1, 2, 3);
-				comp_B.prior = Roaring::bitmapOf(0);
-				comp_B.posterior = Roaring::bitmapOf(0);
-				comp_B.norel = Roaring::bitmapOf(0);
-				comp_B.unclear = Roaring::bitmapOf(0);
-				comp_B.explained = Roaring::bitmapOf(4, 0, 1, 2, 3);
-				comp_B.cost = 0;
-				comps.push_back(comp_B);
-				witness wit = witness("B", comps);
-				//Check that the ID is correct:
-				string expected_id = "B";
-				string id = wit.get_id();
-				if (id != expected_id) {
-					u_test.msg += "Expected witness ID to be " + expected_id + ", got " + id + "\n";
-				}
-				//Check that the size of the genealogical_comparison map is correct:
-				unsigned int expected_genealogical_comparisons_size = 2;
-				unsigned int genealogical_comparisons_size = (unsigned int) wit.get_genealogical_comparisons().size();
-				if (genealogical_comparisons_size != expected_genealogical_comparisons_size) {
-					u_test.msg += "Expected genealogical_comparisons.size() == " + to_string(expected_genealogical_comparisons_size) + ", got " + to_string(genealogical_comparisons_size) + "\n";
-				}
-				//Check that the size of the potential ancestors list is correct:
-				unsigned int expected_potential_ancestor_ids_size = 1;
-				unsigned int potential_ancestor_ids_size = (unsigned int) wit.get_potential_ancestor_ids().size();
-				if (potential_ancestor_ids_size != expected_potential_ancestor_ids_size) {
-					u_test.msg += "Expected potential_ancestor_ids.size() == " + to_string(expected_potential_ancestor_ids_size) + ", got " + to_string(potential_ancestor_ids_size) + "\n";
+				//Column 1 is only covered by row D, so the first branch should be on that row:
+				Roaring accepted = Roaring();
+				Roaring remaining = Roaring();
+				remaining.addRange(0, rows.size());
+				stack<branch_and_bound_node> nodes = stack<branch_and_bound_node>();
+				scs.branch_on_column(accepted, remaining, nodes);
+				if (nodes.size() != 1) {
+					u_test.msg += "Expected nodes.size() == 1, got " + to_string(nodes.size()) + "\n";
+				}
+				else if (nodes.top().row != 2) {
+					u_test.msg += "Expected nodes.top().row == 2, got " + to_string(nodes.top().row) + "\n";
+				}
+				//If row D is rejected, then no solution remains, so there should be nothing to branch on:
+				remaining.remove(2);
+				nodes = stack<branch_and_bound_node>();
+				scs.branch_on_column(accepted, remaining, nodes);
+				if (!nodes.empty()) {
+					u_test.msg += "Expected nodes.empty() == true, got false\n";
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1104,9 +1320,9 @@ void autotest::run() {
 			mod_test.units.push_back(u_test);
 		}
 		/**
-		 * Unit witness_get_genealogical_comparison_for_witness_1
+		 * Unit set_cover_solver_meet_in_the_middle
 		 */
-		current_unit = "witness_get_genealogical_comparison_for_witness_1";
+		current_unit = "set_cover_solver_meet_in_the_middle";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1115,55 +1331,23 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				witness wit = witness("B", app);
-				genealogical_comparison comp = wit.get_genealogical_comparison_for_witness("D");
-				//Check that B's mutually extant passages with D are correct:
-				Roaring expected_extant = Roaring::bitmapOf(4, 0, 1, 2, 3);
-				Roaring extant = comp.extant;
-				if ((extant ^ expected_extant).cardinality() != 0) {
-					u_test.msg += "Expected extant passages bitmap for B relative to D == " + expected_extant.toString() + ", got " + extant.toString() + "\n";
+				//The meet-in-the-middle backend should find the same minimum-cost solutions as branch and bound:
+				list<set_cover_solution> mitm_solutions = list<set_cover_solution>();
+				bool used = scs.meet_in_the_middle(mitm_solutions);
+				list<set_cover_solution> bnb_solutions = list<set_cover_solution>();
+				scs.branch_and_bound(bnb_solutions);
+				if (!used) {
+					u_test.msg += "Expected scs.meet_in_the_middle(mitm_solutions) == true, got false\n";
 				}
-				//Check that B's agreements with D are correct:
-				Roaring expected_agreements = Roaring::bitmapOf(0);
-				Roaring agreements = comp.agreements;
-				if ((agreements ^ expected_agreements).cardinality() != 0) {
-					u_test.msg += "Expected agreements bitmap for B relative to D == " + expected_agreements.toString() + ", got " + agreements.toString() + "\n";
-				}
-				//Check that B's prior readings relative to D are correct:
-				Roaring expected_prior = Roaring::bitmapOf(2, 0, 1);
-				Roaring prior = comp.prior;
-				if ((prior ^ expected_prior).cardinality() != 0) {
-					u_test.msg += "Expected prior readings bitmap for B relative to D == " + expected_prior.toString() + ", got " + prior.toString() + "\n";
-				}
-				//Check that B's posterior readings relative to D are correct:
-				Roaring expected_posterior = Roaring::bitmapOf(0);
-				Roaring posterior = comp.posterior;
-				if ((posterior ^ expected_posterior).cardinality() != 0) {
-					u_test.msg += "Expected posterior readings bitmap for B relative to D == " + expected_posterior.toString() + ", got " + posterior.toString() + "\n";
-				}
-				//Check that B's readings unrelated to those of D are correct:
-				Roaring expected_norel = Roaring::bitmapOf(1, 2);
-				Roaring norel = comp.norel;
-				if ((norel ^ expected_norel).cardinality() != 0) {
-					u_test.msg += "Expected norel readings bitmap for B relative to D == " + expected_norel.toString() + ", got " + norel.toString() + "\n";
-				}
-				//Check that B's readings with an unclear relationship to those of D are correct:
-				Roaring expected_unclear = Roaring::bitmapOf(1, 3);
-				Roaring unclear = comp.unclear;
-				if ((unclear ^ expected_unclear).cardinality() != 0) {
-					u_test.msg += "Expected unclear readings bitmap for B relative to D == " + expected_unclear.toString() + ", got " + unclear.toString() + "\n";
-				}
-				//Check that B's explained readings by D are correct:
-				Roaring expected_explained_readings = Roaring::bitmapOf(0);
-				Roaring explained_readings = comp.explained;
-				if ((explained_readings ^ expected_explained_readings).cardinality() != 0) {
-					u_test.msg += "Expected explained readings bitmap for B relative to D == " + expected_explained_readings.toString() + ", got " + explained_readings.toString() + "\n";
+				else if (mitm_solutions.size() != bnb_solutions.size()) {
+					u_test.msg += "Expected mitm_solutions.size() == " + to_string(bnb_solutions.size()) + ", got " + to_string(mitm_solutions.size()) + "\n";
 				}
-				//Check that the genealogical cost of B relative to D is correct:
-				float expected_cost = 0;
-				float cost = comp.cost;
-				if (cost != expected_cost) {
-					u_test.msg += "Expected genealogical cost for B relative to D == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
+				else {
+					float expected_cost = bnb_solutions.front().cost;
+					float cost = mitm_solutions.front().cost;
+					if (cost != expected_cost) {
+						u_test.msg += "Expected mitm_solutions.front().cost == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
+					}
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1175,9 +1359,9 @@ void autotest::run() {
 			mod_test.units.push_back(u_test);
 		}
 		/**
-		 * Unit witness_get_genealogical_comparison_for_witness_2
+		 * Unit set_cover_solver_get_stats
 		 */
-		current_unit = "witness_get_genealogical_comparison_for_witness_2";
+		current_unit = "set_cover_solver_get_stats";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1186,55 +1370,71 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				witness wit = witness("E", app);
-				genealogical_comparison comp = wit.get_genealogical_comparison_for_witness("A");
-				//Check that E's mutually extant passages with A are correct:
-				Roaring expected_extant = Roaring::bitmapOf(3, 0, 1, 2);
-				Roaring extant = comp.extant;
-				if ((extant ^ expected_extant).cardinality() != 0) {
-					u_test.msg += "Expected extant passages bitmap for E relative to A == " + expected_extant.toString() + ", got " + extant.toString() + "\n";
+				//Solve the problem and check that the statistics reflect its reduction:
+				set_cover_solver stats_scs = set_cover_solver(rows, target);
+				list<set_cover_solution> solutions = list<set_cover_solution>();
+				stats_scs.solve(solutions);
+				set_cover_solver_stats stats = stats_scs.get_stats();
+				unsigned int expected_rows = 3;
+				if (stats.rows != expected_rows) {
+					u_test.msg += "Expected stats.rows == " + to_string(expected_rows) + ", got " + to_string(stats.rows) + "\n";
+				}
+				unsigned int expected_unique_rows = 1;
+				if (stats.unique_rows != expected_unique_rows) {
+					u_test.msg += "Expected stats.unique_rows == " + to_string(expected_unique_rows) + ", got " + to_string(stats.unique_rows) + "\n";
+				}
+				unsigned int expected_subproblem_rows = 2;
+				if (stats.subproblem_rows != expected_subproblem_rows) {
+					u_test.msg += "Expected stats.subproblem_rows == " + to_string(expected_subproblem_rows) + ", got " + to_string(stats.subproblem_rows) + "\n";
+				}
+				if (stats.solutions_found != solutions.size()) {
+					u_test.msg += "Expected stats.solutions_found == " + to_string(solutions.size()) + ", got " + to_string(stats.solutions_found) + "\n";
+				}
+				//The JSON dump should include these statistics:
+				stringstream ss;
+				stats_scs.stats_to_json(ss);
+				string json = ss.str();
+				if (json.find("\"subproblem_rows\":2") == string::npos) {
+					u_test.msg += "Expected stats JSON to contain \"subproblem_rows\":2, got " + json + "\n";
 				}
-				//Check that E's agreements with A are correct:
-				Roaring expected_agreements = Roaring::bitmapOf(0);
-				Roaring agreements = comp.agreements;
-				if ((agreements ^ expected_agreements).cardinality() != 0) {
-					u_test.msg += "Expected agreements bitmap for E relative to A == " + expected_agreements.toString() + ", got " + agreements.toString() + "\n";
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
 				}
-				//Check that E's prior readings relative to A are correct:
-				Roaring expected_prior = Roaring::bitmapOf(0);
-				Roaring prior = comp.prior;
-				if ((prior ^ expected_prior).cardinality() != 0) {
-					u_test.msg += "Expected prior readings bitmap for E relative to A == " + expected_prior.toString() + ", got " + prior.toString() + "\n";
-				}
-				//Check that E's posterior readings relative to A are correct:
-				Roaring expected_posterior = Roaring::bitmapOf(3, 0, 1, 2);
-				Roaring posterior = comp.posterior;
-				if ((posterior ^ expected_posterior).cardinality() != 0) {
-					u_test.msg += "Expected posterior readings bitmap for E relative to A == " + expected_posterior.toString() + ", got " + posterior.toString() + "\n";
-				}
-				//Check that E's readings unrelated to those of A are correct:
-				Roaring expected_norel = Roaring::bitmapOf(0);
-				Roaring norel = comp.norel;
-				if ((norel ^ expected_norel).cardinality() != 0) {
-					u_test.msg += "Expected norel readings bitmap for E relative to A == " + expected_norel.toString() + ", got " + norel.toString() + "\n";
-				}
-				//Check that E's readings with an unclear relationship to those of A are correct:
-				Roaring expected_unclear = Roaring::bitmapOf(0);
-				Roaring unclear = comp.unclear;
-				if ((unclear ^ expected_unclear).cardinality() != 0) {
-					u_test.msg += "Expected unclear readings bitmap for E relative to A == " + expected_unclear.toString() + ", got " + unclear.toString() + "\n";
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit set_cover_solver_solution_enumerator
+		 */
+		current_unit = "set_cover_solver_solution_enumerator";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Enumerate all solutions within a fixed upper bound of 6:
+				set_cover_solution_enumerator enumerator = set_cover_solution_enumerator(rows, target, 6);
+				set_cover_solution solution;
+				unsigned int expected_n_solutions = 3;
+				unsigned int n_solutions = 0;
+				while (enumerator.next(solution)) {
+					n_solutions++;
+					if (solution.cost > 6) {
+						u_test.msg += "Expected solution.cost <= 6, got " + to_string(solution.cost) + "\n";
+					}
 				}
-				//Check that E's explained readings by A are correct:
-				Roaring expected_explained_readings = Roaring::bitmapOf(3, 0, 1, 2);
-				Roaring explained_readings = comp.explained;
-				if ((explained_readings ^ expected_explained_readings).cardinality() != 0) {
-					u_test.msg += "Expected explained readings bitmap for E relative to A == " + expected_explained_readings.toString() + ", got " + explained_readings.toString() + "\n";
+				if (n_solutions != expected_n_solutions) {
+					u_test.msg += "Expected " + to_string(expected_n_solutions) + " enumerated solutions, got " + to_string(n_solutions) + "\n";
 				}
-				//Check that the genealogical cost of E relative to A is correct:
-				float expected_cost = 4;
-				float cost = comp.cost;
-				if (cost != expected_cost) {
-					u_test.msg += "Expected genealogical cost for E relative to A == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
+				//The enumerator should yield no more solutions once it is exhausted:
+				if (enumerator.next(solution)) {
+					u_test.msg += "Expected enumerator.next() == false after exhaustion, got true\n";
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1246,9 +1446,9 @@ void autotest::run() {
 			mod_test.units.push_back(u_test);
 		}
 		/**
-		 * Unit witness_get_genealogical_comparison_for_witness_3
+		 * Unit set_cover_solver_solve_cheapest
 		 */
-		current_unit = "witness_get_genealogical_comparison_for_witness_3";
+		current_unit = "set_cover_solver_solve_cheapest";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1257,19 +1457,26 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				witness wit = witness("E", app, true);
-				genealogical_comparison comp = wit.get_genealogical_comparison_for_witness("A");
-				//Check that E's explained readings by A are correct:
-				Roaring expected_explained_readings = Roaring::bitmapOf(2, 0, 2);
-				Roaring explained_readings = comp.explained;
-				if ((explained_readings ^ expected_explained_readings).cardinality() != 0) {
-					u_test.msg += "Using classic calculations, expected explained readings bitmap for E relative to A == " + expected_explained_readings.toString() + ", got " + explained_readings.toString() + "\n";
+				//Get the two cheapest of the three solutions within a fixed upper bound of 6:
+				set_cover_solver bounded_scs = set_cover_solver(rows, target, 6);
+				list<set_cover_solution> solutions = list<set_cover_solution>();
+				bounded_scs.solve_cheapest(solutions, 2);
+				unsigned int expected_n_solutions = 2;
+				if (solutions.size() != expected_n_solutions) {
+					u_test.msg += "Expected solutions.size() == " + to_string(expected_n_solutions) + ", got " + to_string(solutions.size()) + "\n";
 				}
-				//Check that the genealogical cost of E relative to A is correct:
-				float expected_cost = 3;
-				float cost = comp.cost;
-				if (cost != expected_cost) {
-					u_test.msg += "Using classic calculations, expected genealogical cost for E relative to A == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
+				else {
+					//The solutions should be sorted by cost:
+					float expected_first_cost = 3;
+					float first_cost = solutions.front().cost;
+					if (first_cost != expected_first_cost) {
+						u_test.msg += "Expected solutions.front().cost == " + to_string(expected_first_cost) + ", got " + to_string(first_cost) + "\n";
+					}
+					float expected_last_cost = 4;
+					float last_cost = solutions.back().cost;
+					if (last_cost != expected_last_cost) {
+						u_test.msg += "Expected solutions.back().cost == " + to_string(expected_last_cost) + ", got " + to_string(last_cost) + "\n";
+					}
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1281,9 +1488,9 @@ void autotest::run() {
 			mod_test.units.push_back(u_test);
 		}
 		/**
-		 * Unit witness_get_substemmata
+		 * Unit set_cover_solver_solve_cheapest_unbounded
 		 */
-		current_unit = "witness_get_substemmata";
+		current_unit = "set_cover_solver_solve_cheapest_unbounded";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1292,37 +1499,32 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				//Check if a witness has the expected number of minimum-cost substemmata:
-				witness wit = witness("C", app);
-				list<set_cover_solution> substemmata = wit.get_substemmata();
-				unsigned int expected_substemmata_size = 1;
-				unsigned int substemmata_size = (unsigned int) substemmata.size();
-				if (substemmata_size != expected_substemmata_size) {
-					u_test.msg += "Expected substemmata.size() == " + to_string(expected_substemmata_size) + ", got " + to_string(substemmata_size) + "\n";
-				} else {
-					//Check if a witness's minimum-cost substemma consists of the correct number of ancestors:
-					set_cover_solution substemma = substemmata.front();
-					unsigned int expected_substemma_rows_size = 1;
-					unsigned int substemma_rows_size = (unsigned int) substemma.rows.size();
-					if (substemma_rows_size != expected_substemma_rows_size) {
-						u_test.msg += "Expected substemma.rows.size() == " + to_string(expected_substemma_rows_size) + ", got " + to_string(substemma_rows_size) + "\n";
-					} else {
-						//Check if the ancestors are correct:
-						string expected_substemma_row_id = "B";
-						string substemma_row_id = substemma.rows.front().id;
-						if (substemma_row_id != expected_substemma_row_id) {
-							u_test.msg += "Expected substemma.rows.front().id == {" + expected_substemma_row_id + "}, got {" + substemma_row_id + "}\n";
-						}
-					}
-					float expected_substemma_cost = 2;
-					float substemma_cost = substemma.cost;
-					if (substemma_cost != expected_substemma_cost) {
-						u_test.msg += "Expected substemma.cost == " + to_string(expected_substemma_cost) + ", got " + to_string(substemma_cost) + "\n";
+				//Without an upper bound, asking for more solutions than exist should return every solution:
+				set_cover_solver unbounded_scs = set_cover_solver(rows, target, numeric_limits<float>::infinity());
+				list<set_cover_solution> solutions = list<set_cover_solution>();
+				unbounded_scs.solve_cheapest(solutions, 4);
+				unsigned int expected_n_solutions = 3;
+				if (solutions.size() != expected_n_solutions) {
+					u_test.msg += "Expected solutions.size() == " + to_string(expected_n_solutions) + ", got " + to_string(solutions.size()) + "\n";
+				}
+				else {
+					float expected_last_cost = 6;
+					float last_cost = solutions.back().cost;
+					if (last_cost != expected_last_cost) {
+						u_test.msg += "Expected solutions.back().cost == " + to_string(expected_last_cost) + ", got " + to_string(last_cost) + "\n";
 					}
-					unsigned int expected_substemma_agreements = 2;
-					unsigned int substemma_agreements = substemma.agreements;
-					if (substemma_agreements != expected_substemma_agreements) {
-						u_test.msg += "Expected substemma.agreements == " + to_string(expected_substemma_agreements) + ", got " + to_string(substemma_agreements) + "\n";
+				}
+				//Asking for just the cheapest solution should tighten the bound and still return the minimum-cost solution:
+				unbounded_scs.solve_cheapest(solutions, 1);
+				expected_n_solutions = 1;
+				if (solutions.size() != expected_n_solutions) {
+					u_test.msg += "Expected solutions.size() == " + to_string(expected_n_solutions) + ", got " + to_string(solutions.size()) + "\n";
+				}
+				else {
+					float expected_cost = 3;
+					float cost = solutions.front().cost;
+					if (cost != expected_cost) {
+						u_test.msg += "Expected solutions.front().cost == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
 					}
 				}
 				if (u_test.msg.empty()) {
@@ -1335,9 +1537,9 @@ void autotest::run() {
 			mod_test.units.push_back(u_test);
 		}
 		/**
-		 * Unit witness_get_substemmata_single_solution
+		 * Unit set_cover_solver_fixed_upper_bound_rounding
 		 */
-		current_unit = "witness_get_substemmata_single_solution";
+		current_unit = "set_cover_solver_fixed_upper_bound_rounding";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1346,38 +1548,34 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				//Check if a witness has the expected number of minimum-cost substemmata:
-				witness wit = witness("C", app);
-				list<set_cover_solution> substemmata = wit.get_substemmata(0, true);
-				unsigned int expected_substemmata_size = 1;
-				unsigned int substemmata_size = (unsigned int) substemmata.size();
-				if (substemmata_size != expected_substemmata_size) {
-					u_test.msg += "Expected substemmata.size() == " + to_string(expected_substemmata_size) + ", got " + to_string(substemmata_size) + "\n";
-				} else {
-					//Check if a witness's minimum-cost substemma consists of the correct number of ancestors:
-					set_cover_solution substemma = substemmata.front();
-					unsigned int expected_substemma_rows_size = 1;
-					unsigned int substemma_rows_size = (unsigned int) substemma.rows.size();
-					if (substemma_rows_size != expected_substemma_rows_size) {
-						u_test.msg += "Expected substemma.rows.size() == " + to_string(expected_substemma_rows_size) + ", got " + to_string(substemma_rows_size) + "\n";
-					} else {
-						//Check if the ancestors are correct:
-						string expected_substemma_row_id = "B";
-						string substemma_row_id = substemma.rows.front().id;
-						if (substemma_row_id != expected_substemma_row_id) {
-							u_test.msg += "Expected substemma.rows.front().id == {" + expected_substemma_row_id + "}, got {" + substemma_row_id + "}\n";
-						}
-					}
-					float expected_substemma_cost = 2;
-					float substemma_cost = substemma.cost;
-					if (substemma_cost != expected_substemma_cost) {
-						u_test.msg += "Expected substemma.cost == " + to_string(expected_substemma_cost) + ", got " + to_string(substemma_cost) + "\n";
-					}
-					unsigned int expected_substemma_agreements = 2;
-					unsigned int substemma_agreements = substemma.agreements;
-					if (substemma_agreements != expected_substemma_agreements) {
-						u_test.msg += "Expected substemma.agreements == " + to_string(expected_substemma_agreements) + ", got " + to_string(substemma_agreements) + "\n";
-					}
+				//Set up a problem with one unique coverage row and two interchangeable rows for the remaining column:
+				vector<set_cover_row> rounding_rows = vector<set_cover_row>();
+				set_cover_row row_u;
+				row_u.id = "U";
+				row_u.agreements = Roaring::bitmapOf(1, 0);
+				row_u.explained = Roaring::bitmapOf(1, 0);
+				row_u.cost = 0.35f;
+				rounding_rows.push_back(row_u);
+				set_cover_row row_v;
+				row_v.id = "V";
+				row_v.agreements = Roaring::bitmapOf(1, 1);
+				row_v.explained = Roaring::bitmapOf(1, 1);
+				row_v.cost = 0.6f;
+				rounding_rows.push_back(row_v);
+				set_cover_row row_w;
+				row_w.id = "W";
+				row_w.agreements = Roaring::bitmapOf(1, 1);
+				row_w.explained = Roaring::bitmapOf(1, 1);
+				row_w.cost = 0.6f;
+				rounding_rows.push_back(row_w);
+				//The fixed upper bound is just below the float sum of the costs, but the subproblem's upper bound still admits both solutions:
+				float rounding_ub = nextafterf(row_u.cost + row_v.cost, 0);
+				set_cover_solver rounding_scs = set_cover_solver(rounding_rows, Roaring::bitmapOf(2, 0, 1), rounding_ub);
+				list<set_cover_solution> solutions = list<set_cover_solution>();
+				rounding_scs.solve(solutions);
+				unsigned int expected_n_solutions = 2;
+				if (solutions.size() != expected_n_solutions) {
+					u_test.msg += "Expected solutions.size() == " + to_string(expected_n_solutions) + ", got " + to_string(solutions.size()) + "\n";
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1391,9 +1589,9 @@ void autotest::run() {
 		lib_test.modules.push_back(mod_test);
 	}
 	/**
-	 * Module textual_flow
+	 * Module witness
 	 */
-	current_module = "textual_flow";
+	current_module = "witness";
 	if (target_module.empty() || target_module == current_module) {
 		//Initialize a container for module-wide test results:
 		module_test mod_test;
@@ -1407,19 +1605,1171 @@ void autotest::run() {
 		pugi::xml_node tei_node = doc.child("TEI");
 		bool merge_splits = false;
 		set<string> trivial_reading_types = set<string>({"defective", "orthographic"});
-		set<string> dropped_reading_types = set<string>();
+		set<string> dropped_reading_types = set<string>({"ambiguous"});
 		list<string> ignored_suffixes = list<string>({"*", "T"});
 		apparatus app = apparatus(tei_node, merge_splits, trivial_reading_types, dropped_reading_types, ignored_suffixes);
-		variation_unit vu = app.get_variation_units()[3];
-		list<witness> witnesses = list<witness>();
-		for (string wit_id : app.get_list_wit()) {
-			witness wit = witness(wit_id, app);
-			witnesses.push_back(wit);
+		/**
+		 * Unit witness_constructor_1
+		 */
+		current_unit = "witness_constructor_1";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Construct a new witness with genealogical relationships to all other witnesses:
+				witness wit = witness("A", app);
+				//Check that the ID is correct:
+				string expected_id = "A";
+				string id = wit.get_id();
+				if (id != expected_id) {
+					u_test.msg += "Expected witness ID to be " + expected_id + ", got " + id + "\n";
+				}
+				//Check that the size of the genealogical_comparison map is correct:
+				unsigned int expected_genealogical_comparisons_size = 5;
+				unsigned int genealogical_comparisons_size = (unsigned int) wit.get_genealogical_comparisons().size();
+				if (genealogical_comparisons_size != expected_genealogical_comparisons_size) {
+					u_test.msg += "Expected genealogical_comparisons.size() == " + to_string(expected_genealogical_comparisons_size) + ", got " + to_string(genealogical_comparisons_size) + "\n";
+				}
+				//Check that the size of the potential ancestors list is correct:
+				unsigned int expected_potential_ancestor_ids_size = 0;
+				unsigned int potential_ancestor_ids_size = (unsigned int) wit.get_potential_ancestor_ids().size();
+				if (potential_ancestor_ids_size != expected_potential_ancestor_ids_size) {
+					u_test.msg += "Expected potential_ancestor_ids.size() == " + to_string(expected_potential_ancestor_ids_size) + ", got " + to_string(potential_ancestor_ids_size) + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_constructor_2
+		 */
+		current_unit = "witness_constructor_2";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Construct a new witness with genealogical relationships to one other witness using the copy constructor:
+				list<genealogical_comparison> comps = list<genealogical_comparison>();
+				genealogical_comparison comp_A;
+				comp_A.primary_wit = "B";
+				comp_A.secondary_wit = "A";
+				comp_A.extant = Roaring::bitmapOf(3, 0, 1, 2);
+				comp_A.agreements = Roaring::bitmapOf(2, 0, 1);
+				comp_A.prior = Roaring::bitmapOf(0);
+				comp_A.posterior = Roaring::bitmapOf(1, 2);
+				comp_A.norel = Roaring::bitmapOf(0);
+				comp_A.unclear = Roaring::bitmapOf(0);
+				comp_A.explained = Roaring::bitmapOf(3, 0, 1, 2);
+				comp_A.cost = 1;
+				comps.push_back(comp_A);
+				genealogical_comparison comp_B;
+				comp_B.primary_wit = "B";
+				comp_B.secondary_wit = "B";
+				comp_B.extant = Roaring::bitmapOf(4, 0, 1, 2, 3);
+				comp_B.agreements = Roaring::bitmapOf(4, 0, 1, 2, 3);
+				comp_B.prior = Roaring::bitmapOf(0);
+				comp_B.posterior = Roaring::bitmapOf(0);
+				comp_B.norel = Roaring::bitmapOf(0);
+				comp_B.unclear = Roaring::bitmapOf(0);
+				comp_B.explained = Roaring::bitmapOf(4, 0, 1, 2, 3);
+				comp_B.cost = 0;
+				comps.push_back(comp_B);
+				witness wit = witness("B", comps);
+				//Check that the ID is correct:
+				string expected_id = "B";
+				string id = wit.get_id();
+				if (id != expected_id) {
+					u_test.msg += "Expected witness ID to be " + expected_id + ", got " + id + "\n";
+				}
+				//Check that the size of the genealogical_comparison map is correct:
+				unsigned int expected_genealogical_comparisons_size = 2;
+				unsigned int genealogical_comparisons_size = (unsigned int) wit.get_genealogical_comparisons().size();
+				if (genealogical_comparisons_size != expected_genealogical_comparisons_size) {
+					u_test.msg += "Expected genealogical_comparisons.size() == " + to_string(expected_genealogical_comparisons_size) + ", got " + to_string(genealogical_comparisons_size) + "\n";
+				}
+				//Check that the size of the potential ancestors list is correct:
+				unsigned int expected_potential_ancestor_ids_size = 1;
+				unsigned int potential_ancestor_ids_size = (unsigned int) wit.get_potential_ancestor_ids().size();
+				if (potential_ancestor_ids_size != expected_potential_ancestor_ids_size) {
+					u_test.msg += "Expected potential_ancestor_ids.size() == " + to_string(expected_potential_ancestor_ids_size) + ", got " + to_string(potential_ancestor_ids_size) + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_get_genealogical_comparison_for_witness_1
+		 */
+		current_unit = "witness_get_genealogical_comparison_for_witness_1";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				witness wit = witness("B", app);
+				genealogical_comparison comp = wit.get_genealogical_comparison_for_witness("D");
+				//Check that B's mutually extant passages with D are correct:
+				Roaring expected_extant = Roaring::bitmapOf(4, 0, 1, 2, 3);
+				Roaring extant = comp.extant;
+				if ((extant ^ expected_extant).cardinality() != 0) {
+					u_test.msg += "Expected extant passages bitmap for B relative to D == " + expected_extant.toString() + ", got " + extant.toString() + "\n";
+				}
+				//Check that B's agreements with D are correct:
+				Roaring expected_agreements = Roaring::bitmapOf(0);
+				Roaring agreements = comp.agreements;
+				if ((agreements ^ expected_agreements).cardinality() != 0) {
+					u_test.msg += "Expected agreements bitmap for B relative to D == " + expected_agreements.toString() + ", got " + agreements.toString() + "\n";
+				}
+				//Check that B's prior readings relative to D are correct:
+				Roaring expected_prior = Roaring::bitmapOf(2, 0, 1);
+				Roaring prior = comp.prior;
+				if ((prior ^ expected_prior).cardinality() != 0) {
+					u_test.msg += "Expected prior readings bitmap for B relative to D == " + expected_prior.toString() + ", got " + prior.toString() + "\n";
+				}
+				//Check that B's posterior readings relative to D are correct:
+				Roaring expected_posterior = Roaring::bitmapOf(0);
+				Roaring posterior = comp.posterior;
+				if ((posterior ^ expected_posterior).cardinality() != 0) {
+					u_test.msg += "Expected posterior readings bitmap for B relative to D == " + expected_posterior.toString() + ", got " + posterior.toString() + "\n";
+				}
+				//Check that B's readings unrelated to those of D are correct:
+				Roaring expected_norel = Roaring::bitmapOf(1, 2);
+				Roaring norel = comp.norel;
+				if ((norel ^ expected_norel).cardinality() != 0) {
+					u_test.msg += "Expected norel readings bitmap for B relative to D == " + expected_norel.toString() + ", got " + norel.toString() + "\n";
+				}
+				//Check that B's readings with an unclear relationship to those of D are correct:
+				Roaring expected_unclear = Roaring::bitmapOf(1, 3);
+				Roaring unclear = comp.unclear;
+				if ((unclear ^ expected_unclear).cardinality() != 0) {
+					u_test.msg += "Expected unclear readings bitmap for B relative to D == " + expected_unclear.toString() + ", got " + unclear.toString() + "\n";
+				}
+				//Check that B's explained readings by D are correct:
+				Roaring expected_explained_readings = Roaring::bitmapOf(0);
+				Roaring explained_readings = comp.explained;
+				if ((explained_readings ^ expected_explained_readings).cardinality() != 0) {
+					u_test.msg += "Expected explained readings bitmap for B relative to D == " + expected_explained_readings.toString() + ", got " + explained_readings.toString() + "\n";
+				}
+				//Check that the genealogical cost of B relative to D is correct:
+				float expected_cost = 0;
+				float cost = comp.cost;
+				if (cost != expected_cost) {
+					u_test.msg += "Expected genealogical cost for B relative to D == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_get_genealogical_comparison_for_witness_2
+		 */
+		current_unit = "witness_get_genealogical_comparison_for_witness_2";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				witness wit = witness("E", app);
+				genealogical_comparison comp = wit.get_genealogical_comparison_for_witness("A");
+				//Check that E's mutually extant passages with A are correct:
+				Roaring expected_extant = Roaring::bitmapOf(3, 0, 1, 2);
+				Roaring extant = comp.extant;
+				if ((extant ^ expected_extant).cardinality() != 0) {
+					u_test.msg += "Expected extant passages bitmap for E relative to A == " + expected_extant.toString() + ", got " + extant.toString() + "\n";
+				}
+				//Check that E's agreements with A are correct:
+				Roaring expected_agreements = Roaring::bitmapOf(0);
+				Roaring agreements = comp.agreements;
+				if ((agreements ^ expected_agreements).cardinality() != 0) {
+					u_test.msg += "Expected agreements bitmap for E relative to A == " + expected_agreements.toString() + ", got " + agreements.toString() + "\n";
+				}
+				//Check that E's prior readings relative to A are correct:
+				Roaring expected_prior = Roaring::bitmapOf(0);
+				Roaring prior = comp.prior;
+				if ((prior ^ expected_prior).cardinality() != 0) {
+					u_test.msg += "Expected prior readings bitmap for E relative to A == " + expected_prior.toString() + ", got " + prior.toString() + "\n";
+				}
+				//Check that E's posterior readings relative to A are correct:
+				Roaring expected_posterior = Roaring::bitmapOf(3, 0, 1, 2);
+				Roaring posterior = comp.posterior;
+				if ((posterior ^ expected_posterior).cardinality() != 0) {
+					u_test.msg += "Expected posterior readings bitmap for E relative to A == " + expected_posterior.toString() + ", got " + posterior.toString() + "\n";
+				}
+				//Check that E's readings unrelated to those of A are correct:
+				Roaring expected_norel = Roaring::bitmapOf(0);
+				Roaring norel = comp.norel;
+				if ((norel ^ expected_norel).cardinality() != 0) {
+					u_test.msg += "Expected norel readings bitmap for E relative to A == " + expected_norel.toString() + ", got " + norel.toString() + "\n";
+				}
+				//Check that E's readings with an unclear relationship to those of A are correct:
+				Roaring expected_unclear = Roaring::bitmapOf(0);
+				Roaring unclear = comp.unclear;
+				if ((unclear ^ expected_unclear).cardinality() != 0) {
+					u_test.msg += "Expected unclear readings bitmap for E relative to A == " + expected_unclear.toString() + ", got " + unclear.toString() + "\n";
+				}
+				//Check that E's explained readings by A are correct:
+				Roaring expected_explained_readings = Roaring::bitmapOf(3, 0, 1, 2);
+				Roaring explained_readings = comp.explained;
+				if ((explained_readings ^ expected_explained_readings).cardinality() != 0) {
+					u_test.msg += "Expected explained readings bitmap for E relative to A == " + expected_explained_readings.toString() + ", got " + explained_readings.toString() + "\n";
+				}
+				//Check that the genealogical cost of E relative to A is correct:
+				float expected_cost = 4;
+				float cost = comp.cost;
+				if (cost != expected_cost) {
+					u_test.msg += "Expected genealogical cost for E relative to A == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_get_genealogical_comparison_for_witness_3
+		 */
+		current_unit = "witness_get_genealogical_comparison_for_witness_3";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				witness wit = witness("E", app, true);
+				genealogical_comparison comp = wit.get_genealogical_comparison_for_witness("A");
+				//Check that E's explained readings by A are correct:
+				Roaring expected_explained_readings = Roaring::bitmapOf(2, 0, 2);
+				Roaring explained_readings = comp.explained;
+				if ((explained_readings ^ expected_explained_readings).cardinality() != 0) {
+					u_test.msg += "Using classic calculations, expected explained readings bitmap for E relative to A == " + expected_explained_readings.toString() + ", got " + explained_readings.toString() + "\n";
+				}
+				//Check that the genealogical cost of E relative to A is correct:
+				float expected_cost = 3;
+				float cost = comp.cost;
+				if (cost != expected_cost) {
+					u_test.msg += "Using classic calculations, expected genealogical cost for E relative to A == " + to_string(expected_cost) + ", got " + to_string(cost) + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_get_substemmata
+		 */
+		current_unit = "witness_get_substemmata";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Check if a witness has the expected number of minimum-cost substemmata:
+				witness wit = witness("C", app);
+				list<set_cover_solution> substemmata = wit.get_substemmata();
+				unsigned int expected_substemmata_size = 1;
+				unsigned int substemmata_size = (unsigned int) substemmata.size();
+				if (substemmata_size != expected_substemmata_size) {
+					u_test.msg += "Expected substemmata.size() == " + to_string(expected_substemmata_size) + ", got " + to_string(substemmata_size) + "\n";
+				} else {
+					//Check if a witness's minimum-cost substemma consists of the correct number of ancestors:
+					set_cover_solution substemma = substemmata.front();
+					unsigned int expected_substemma_rows_size = 1;
+					unsigned int substemma_rows_size = (unsigned int) substemma.rows.size();
+					if (substemma_rows_size != expected_substemma_rows_size) {
+						u_test.msg += "Expected substemma.rows.size() == " + to_string(expected_substemma_rows_size) + ", got " + to_string(substemma_rows_size) + "\n";
+					} else {
+						//Check if the ancestors are correct:
+						string expected_substemma_row_id = "B";
+						string substemma_row_id = substemma.rows.front().id;
+						if (substemma_row_id != expected_substemma_row_id) {
+							u_test.msg += "Expected substemma.rows.front().id == {" + expected_substemma_row_id + "}, got {" + substemma_row_id + "}\n";
+						}
+					}
+					float expected_substemma_cost = 2;
+					float substemma_cost = substemma.cost;
+					if (substemma_cost != expected_substemma_cost) {
+						u_test.msg += "Expected substemma.cost == " + to_string(expected_substemma_cost) + ", got " + to_string(substemma_cost) + "\n";
+					}
+					unsigned int expected_substemma_agreements = 2;
+					unsigned int substemma_agreements = substemma.agreements;
+					if (substemma_agreements != expected_substemma_agreements) {
+						u_test.msg += "Expected substemma.agreements == " + to_string(expected_substemma_agreements) + ", got " + to_string(substemma_agreements) + "\n";
+					}
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_get_substemmata_single_solution
+		 */
+		current_unit = "witness_get_substemmata_single_solution";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Check if a witness has the expected number of minimum-cost substemmata:
+				witness wit = witness("C", app);
+				list<set_cover_solution> substemmata = wit.get_substemmata(0, true);
+				unsigned int expected_substemmata_size = 1;
+				unsigned int substemmata_size = (unsigned int) substemmata.size();
+				if (substemmata_size != expected_substemmata_size) {
+					u_test.msg += "Expected substemmata.size() == " + to_string(expected_substemmata_size) + ", got " + to_string(substemmata_size) + "\n";
+				} else {
+					//Check if a witness's minimum-cost substemma consists of the correct number of ancestors:
+					set_cover_solution substemma = substemmata.front();
+					unsigned int expected_substemma_rows_size = 1;
+					unsigned int substemma_rows_size = (unsigned int) substemma.rows.size();
+					if (substemma_rows_size != expected_substemma_rows_size) {
+						u_test.msg += "Expected substemma.rows.size() == " + to_string(expected_substemma_rows_size) + ", got " + to_string(substemma_rows_size) + "\n";
+					} else {
+						//Check if the ancestors are correct:
+						string expected_substemma_row_id = "B";
+						string substemma_row_id = substemma.rows.front().id;
+						if (substemma_row_id != expected_substemma_row_id) {
+							u_test.msg += "Expected substemma.rows.front().id == {" + expected_substemma_row_id + "}, got {" + substemma_row_id + "}\n";
+						}
+					}
+					float expected_substemma_cost = 2;
+					float substemma_cost = substemma.cost;
+					if (substemma_cost != expected_substemma_cost) {
+						u_test.msg += "Expected substemma.cost == " + to_string(expected_substemma_cost) + ", got " + to_string(substemma_cost) + "\n";
+					}
+					unsigned int expected_substemma_agreements = 2;
+					unsigned int substemma_agreements = substemma.agreements;
+					if (substemma_agreements != expected_substemma_agreements) {
+						u_test.msg += "Expected substemma.agreements == " + to_string(expected_substemma_agreements) + ", got " + to_string(substemma_agreements) + "\n";
+					}
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_comparison_matrix
+		 */
+		current_unit = "witness_comparison_matrix";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				list<witness> witnesses = list<witness>();
+				for (string wit_id : app.get_list_wit()) {
+					witnesses.push_back(witness(wit_id, app));
+				}
+				comparison_matrix cm = comparison_matrix(witnesses, 2);
+				//Every entry off the diagonal should match the corresponding row of the primary witness's compare witnesses table:
+				unsigned int primary_ind = 0;
+				for (const witness & wit : witnesses) {
+					compare_witnesses_table cwt = compare_witnesses_table(wit, app.get_list_wit(), set<string>());
+					compare_witnesses_table_row diagonal = cm.get_entry(primary_ind, primary_ind);
+					if (diagonal.pass != cwt.get_primary_extant()) {
+						u_test.msg += "Expected PASS == " + to_string(cwt.get_primary_extant()) + " on the diagonal for " + wit.get_id() + ", got " + to_string(diagonal.pass) + "\n";
+					}
+					for (const compare_witnesses_table_row & row : cwt.get_rows()) {
+						vector<string> ids = cm.get_ids();
+						unsigned int secondary_ind = (unsigned int) (find(ids.begin(), ids.end(), row.id) - ids.begin());
+						compare_witnesses_table_row entry = cm.get_entry(primary_ind, secondary_ind);
+						if (entry.dir != row.dir || entry.nr != row.nr || entry.pass != row.pass || entry.eq != row.eq || entry.perc != row.perc || entry.prior != row.prior || entry.posterior != row.posterior || entry.norel != row.norel || entry.uncl != row.uncl || entry.expl != row.expl || entry.cost != row.cost) {
+							u_test.msg += "Expected the comparison matrix entry for " + wit.get_id() + " and " + row.id + " to match its compare witnesses table row, but it did not\n";
+						}
+					}
+					primary_ind++;
+				}
+				//The binary export should read back as the same matrix:
+				stringstream ss;
+				cm.to_binary(ss);
+				comparison_matrix read_cm = comparison_matrix(ss);
+				if (read_cm.get_ids() != cm.get_ids()) {
+					u_test.msg += "Expected the comparison matrix read from its binary export to have the same witness IDs, but it did not\n";
+				}
+				else {
+					for (unsigned int i = 0; i < cm.size(); i++) {
+						for (unsigned int j = 0; j < cm.size(); j++) {
+							compare_witnesses_table_row expected_entry = cm.get_entry(i, j);
+							compare_witnesses_table_row entry = read_cm.get_entry(i, j);
+							if (entry.dir != expected_entry.dir || entry.nr != expected_entry.nr || entry.pass != expected_entry.pass || entry.eq != expected_entry.eq || entry.perc != expected_entry.perc || entry.prior != expected_entry.prior || entry.posterior != expected_entry.posterior || entry.norel != expected_entry.norel || entry.uncl != expected_entry.uncl || entry.expl != expected_entry.expl || entry.cost != expected_entry.cost) {
+								u_test.msg += "Expected the comparison matrix read from its binary export to have the same entry at (" + to_string(i) + ", " + to_string(j) + "), but it did not\n";
+							}
+						}
+					}
+				}
+				//Data that is not a comparison matrix should be rejected:
+				stringstream bad_ss("not a comparison matrix");
+				bool exception_thrown = false;
+				try {
+					comparison_matrix bad_cm = comparison_matrix(bad_ss);
+				}
+				catch (const runtime_error & e) {
+					exception_thrown = true;
+				}
+				if (!exception_thrown) {
+					u_test.msg += "Expected reading a comparison matrix from invalid data to throw an exception, but it did not\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_comparison_matrix_to_npy
+		 */
+		current_unit = "witness_comparison_matrix_to_npy";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				list<witness> witnesses = list<witness>();
+				for (string wit_id : app.get_list_wit()) {
+					witnesses.push_back(witness(wit_id, app));
+				}
+				comparison_matrix cm = comparison_matrix(witnesses);
+				unsigned int n = cm.size();
+				stringstream ss;
+				cm.to_npy(ss, "eq");
+				string npy = ss.str();
+				//The file should start with the magic string and version 1.0, and its header should be padded so that the data starts at a multiple of 64 bytes:
+				if (npy.compare(0, 8, string("\x93NUMPY\x01\x00", 8)) != 0) {
+					u_test.msg += "Expected the .npy output to start with the magic string for version 1.0, but it did not\n";
+				}
+				unsigned int header_size = (unsigned char) npy[8] + 256 * (unsigned char) npy[9];
+				string header = npy.substr(10, header_size);
+				if ((10 + header_size) % 64 != 0 || header.back() != '\n') {
+					u_test.msg += "Expected the .npy header to end with a newline at a multiple of 64 bytes, got a header of " + to_string(header_size) + " bytes\n";
+				}
+				string expected_shape = "'shape': (" + to_string(n) + ", " + to_string(n) + ")";
+				if (header.find("'descr': '<i4'") == string::npos || header.find("'fortran_order': False") == string::npos || header.find(expected_shape) == string::npos) {
+					u_test.msg += "Expected the .npy header to describe a " + to_string(n) + " x " + to_string(n) + " matrix of 32-bit integers in C order, got " + header + "\n";
+				}
+				//The data should hold the agreements in row-major order:
+				if (npy.size() != 10 + header_size + 4 * n * n) {
+					u_test.msg += "Expected the .npy output to hold " + to_string(n * n) + " 32-bit values after its header, got " + to_string(npy.size() - 10 - header_size) + " bytes\n";
+				}
+				else {
+					for (unsigned int i = 0; i < n; i++) {
+						for (unsigned int j = 0; j < n; j++) {
+							unsigned int pos = 10 + header_size + 4 * (i * n + j);
+							int value = (unsigned char) npy[pos] | (unsigned char) npy[pos + 1] << 8 | (unsigned char) npy[pos + 2] << 16 | (unsigned char) npy[pos + 3] << 24;
+							int expected_value = cm.get_entry(i, j).eq;
+							if (value != expected_value) {
+								u_test.msg += "Expected the .npy value at (" + to_string(i) + ", " + to_string(j) + ") to be " + to_string(expected_value) + ", got " + to_string(value) + "\n";
+							}
+						}
+					}
+				}
+				//The sidecar list should have one witness ID per line:
+				stringstream ids_ss;
+				cm.ids_to_txt(ids_ss);
+				string expected_ids = "";
+				for (const string & id : cm.get_ids()) {
+					expected_ids += id + "\n";
+				}
+				if (ids_ss.str() != expected_ids) {
+					u_test.msg += "Expected the witness ID list to be " + expected_ids + ", got " + ids_ss.str() + "\n";
+				}
+				//A column that does not exist should be rejected:
+				bool exception_thrown = false;
+				try {
+					stringstream bad_ss;
+					cm.to_npy(bad_ss, "bogus");
+				}
+				catch (const runtime_error & e) {
+					exception_thrown = true;
+				}
+				if (!exception_thrown) {
+					u_test.msg += "Expected writing a column that does not exist to throw an exception, but it did not\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_comparison_matrix_tables
+		 */
+		current_unit = "witness_comparison_matrix_tables";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				list<witness> witnesses = list<witness>();
+				for (string wit_id : app.get_list_wit()) {
+					witnesses.push_back(witness(wit_id, app));
+				}
+				comparison_matrix cm = comparison_matrix(witnesses);
+				//Every table built in a batch should match the table built from its primary witness:
+				vector<compare_witnesses_table> tables = cm.get_compare_witnesses_tables(set<string>(), 0, 3);
+				set<string> filter_wits = set<string>({"A", "B", "C", "D"});
+				unsigned int top_k = 2;
+				vector<compare_witnesses_table> top_tables = cm.get_compare_witnesses_tables(filter_wits, top_k, 3);
+				if (tables.size() != witnesses.size() || top_tables.size() != witnesses.size()) {
+					u_test.msg += "Expected " + to_string(witnesses.size()) + " tables, got " + to_string(tables.size()) + " and " + to_string(top_tables.size()) + "\n";
+				}
+				else {
+					unsigned int primary_ind = 0;
+					for (const witness & wit : witnesses) {
+						stringstream expected_ss;
+						compare_witnesses_table(wit, app.get_list_wit(), set<string>()).to_fixed_width(expected_ss);
+						stringstream ss;
+						tables[primary_ind].to_fixed_width(ss);
+						if (ss.str() != expected_ss.str()) {
+							u_test.msg += "Expected the batch table for " + wit.get_id() + " to be\n" + expected_ss.str() + "got\n" + ss.str();
+						}
+						//With a filter and top-k truncation, the table should hold the first rows of the filtered table:
+						compare_witnesses_table filtered_cwt = compare_witnesses_table(wit, app.get_list_wit(), filter_wits);
+						list<compare_witnesses_table_row> expected_rows = filtered_cwt.get_rows();
+						if (expected_rows.size() > top_k) {
+							expected_rows.resize(top_k);
+						}
+						stringstream expected_top_ss;
+						compare_witnesses_table(filtered_cwt.get_id(), filtered_cwt.get_primary_extant(), expected_rows).to_fixed_width(expected_top_ss);
+						stringstream top_ss;
+						top_tables[primary_ind].to_fixed_width(top_ss);
+						if (top_ss.str() != expected_top_ss.str()) {
+							u_test.msg += "Expected the filtered top-" + to_string(top_k) + " batch table for " + wit.get_id() + " to be\n" + expected_top_ss.str() + "got\n" + top_ss.str();
+						}
+						primary_ind++;
+					}
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_find_relatives_wide_table
+		 */
+		current_unit = "witness_find_relatives_wide_table";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				vector<variation_unit> vus = app.get_variation_units();
+				witness wit = witness("E", app);
+				find_relatives_wide_table wide_table = find_relatives_wide_table(wit, vus, app.get_list_wit(), set<string>());
+				if (wide_table.get_labels().size() != vus.size()) {
+					u_test.msg += "Expected " + to_string(vus.size()) + " reading columns, got " + to_string(wide_table.get_labels().size()) + "\n";
+				}
+				else {
+					//The table for each variation unit should match the find relatives table constructed for it directly, with and without a reading filter:
+					for (unsigned int vu_ind = 0; vu_ind < vus.size(); vu_ind++) {
+						for (const set<string> & filter_rdgs : {set<string>(), set<string>({"a"})}) {
+							stringstream expected_ss;
+							find_relatives_table(wit, vus[vu_ind], app.get_list_wit(), filter_rdgs).to_json(expected_ss);
+							stringstream ss;
+							wide_table.get_table(vu_ind, filter_rdgs).to_json(ss);
+							if (ss.str() != expected_ss.str()) {
+								u_test.msg += "Expected the find relatives table for " + vus[vu_ind].get_label() + " to be " + expected_ss.str() + ", got " + ss.str() + "\n";
+							}
+						}
+					}
+					//Each row should hold one reading per variation unit, and the rows should be ranked as in the compare witnesses table:
+					list<compare_witnesses_table_row> expected_rows = compare_witnesses_table(wit, app.get_list_wit(), set<string>()).get_rows();
+					list<find_relatives_wide_table_row> rows = wide_table.get_rows();
+					if (rows.size() != expected_rows.size()) {
+						u_test.msg += "Expected " + to_string(expected_rows.size()) + " rows, got " + to_string(rows.size()) + "\n";
+					}
+					else {
+						list<compare_witnesses_table_row>::const_iterator expected_it = expected_rows.begin();
+						for (const find_relatives_wide_table_row & row : rows) {
+							if (row.comparison.id != expected_it->id || row.comparison.nr != expected_it->nr || row.rdgs.size() != vus.size()) {
+								u_test.msg += "Expected the row for " + expected_it->id + " with " + to_string(vus.size()) + " readings, got the row for " + row.comparison.id + " with " + to_string(row.rdgs.size()) + " readings\n";
+							}
+							expected_it++;
+						}
+					}
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit witness_enumerate_relationships_table
+		 */
+		current_unit = "witness_enumerate_relationships_table";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				vector<string> variation_unit_ids = vector<string>();
+				for (const variation_unit & vu : app.get_variation_units()) {
+					variation_unit_ids.push_back(vu.get_id());
+				}
+				witness wit = witness("E", app);
+				const genealogical_comparison & comp = wit.get_genealogical_comparison_ref("A");
+				enumerate_relationships_table table = enumerate_relationships_table(comp, variation_unit_ids);
+				//The table refers to its arguments, so it should not be constructible from temporaries:
+				if (is_constructible<enumerate_relationships_table, genealogical_comparison, const vector<string> &>::value || is_constructible<enumerate_relationships_table, const genealogical_comparison &, vector<string>>::value) {
+					u_test.msg += "Expected enumerate_relationships_table not to be constructible from temporaries, but it was\n";
+				}
+				//Each list of passages should match the variation units selected from the corresponding bitmap, in order:
+				auto expected_passages = [&](const Roaring & passages) {
+					list<string> vu_ids = list<string>();
+					for (uint32_t i = 0; i < passages.cardinality(); i++) {
+						uint32_t vu_ind;
+						passages.select(i, &vu_ind);
+						vu_ids.push_back(variation_unit_ids[vu_ind]);
+					}
+					return vu_ids;
+				};
+				if (table.get_extant() != expected_passages(comp.extant) || table.get_agreements() != expected_passages(comp.agreements) || table.get_prior() != expected_passages(comp.prior) || table.get_posterior() != expected_passages(comp.posterior)
+					|| table.get_norel() != expected_passages(comp.norel) || table.get_unclear() != expected_passages(comp.unclear) || table.get_explained() != expected_passages(comp.explained)) {
+					u_test.msg += "Expected the table's lists of passages to match the variation units in the comparison's bitmaps, but they did not\n";
+				}
+				//The code mode should have one row per extant passage, with each code's bits matching the bitmaps:
+				stringstream ss;
+				table.codes_to_csv(ss);
+				string expected_csv = "Genealogical relationships between E and A\nVU,CODE\n";
+				for (Roaring::const_iterator it = comp.extant.begin(); it != comp.extant.end(); it++) {
+					unsigned int code = RELATIONSHIP_EXTANT;
+					code |= comp.agreements.contains(*it) ? RELATIONSHIP_AGREE : 0;
+					code |= comp.prior.contains(*it) ? RELATIONSHIP_PRIOR : 0;
+					code |= comp.posterior.contains(*it) ? RELATIONSHIP_POSTERIOR : 0;
+					code |= comp.norel.contains(*it) ? RELATIONSHIP_NOREL : 0;
+					code |= comp.unclear.contains(*it) ? RELATIONSHIP_UNCLEAR : 0;
+					code |= comp.explained.contains(*it) ? RELATIONSHIP_EXPLAINED : 0;
+					expected_csv += variation_unit_ids[*it] + "," + to_string(code) + "\n";
+				}
+				expected_csv += "\n";
+				if (ss.str() != expected_csv) {
+					u_test.msg += "Expected the relationship codes to be\n" + expected_csv + "got\n" + ss.str();
+				}
+				//A default-constructed table should enumerate no passages:
+				enumerate_relationships_table empty_table = enumerate_relationships_table();
+				stringstream empty_ss;
+				empty_table.codes_to_json(empty_ss);
+				if (!empty_table.get_extant().empty() || empty_ss.str() != "{\"primary_wit\":\"\",\"secondary_wit\":\"\",\"rows\":[]}") {
+					u_test.msg += "Expected a default-constructed table to enumerate no passages, got " + empty_ss.str() + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		lib_test.modules.push_back(mod_test);
+	}
+	/**
+	 * Module textual_flow
+	 */
+	current_module = "textual_flow";
+	if (target_module.empty() || target_module == current_module) {
+		//Initialize a container for module-wide test results:
+		module_test mod_test;
+		mod_test.name = current_module;
+		mod_test.units = list<unit_test>();
+		//Then proceed for each unit test:
+		string current_unit;
+		//Do pre-test work:
+		pugi::xml_document doc;
+		doc.load_file(TEST_XML.c_str());
+		pugi::xml_node tei_node = doc.child("TEI");
+		bool merge_splits = false;
+		set<string> trivial_reading_types = set<string>({"defective", "orthographic"});
+		set<string> dropped_reading_types = set<string>();
+		list<string> ignored_suffixes = list<string>({"*", "T"});
+		apparatus app = apparatus(tei_node, merge_splits, trivial_reading_types, dropped_reading_types, ignored_suffixes);
+		variation_unit vu = app.get_variation_units()[3];
+		list<witness> witnesses = list<witness>();
+		for (string wit_id : app.get_list_wit()) {
+			witness wit = witness(wit_id, app);
+			witnesses.push_back(wit);
+		}
+		/**
+		 * Unit textual_flow_constructor_1
+		 */
+		current_unit = "textual_flow_constructor_1";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Construct a textual flow instance with a connectivity of 2:
+				textual_flow tf = textual_flow(vu, witnesses, 2);
+				//Make sure its label matches that of the variation unit:
+				string expected_label = vu.get_label();
+				string label = tf.get_label();
+				if (label != expected_label) {
+					u_test.msg += "Expected label == " + expected_label + ", got " + label + "\n";
+				}
+				//Make sure its readings list is the same length as the variation unit's readings list:
+				unsigned int expected_n_readings = (unsigned int) vu.get_readings().size();
+				if (tf.get_readings().size() != expected_n_readings) {
+					u_test.msg += "Expected readings.size() == " + to_string(expected_n_readings) + ", got " + to_string(tf.get_readings().size()) + "\n";
+				}
+				//Make sure its connectivity value is the specified amount:
+				int expected_connectivity = 2;
+				if (tf.get_connectivity() != expected_connectivity) {
+					u_test.msg += "Expected connectivity == " + to_string(expected_connectivity) + ", got " + to_string(tf.get_connectivity()) + "\n";
+				}
+				//Check that the diagram has the correct number of vertices:
+				unsigned int expected_n_vertices = 5;
+				unsigned int expected_n_edges = 9;
+				if (tf.get_vertices().size() != expected_n_vertices) {
+					u_test.msg += "Expected vertices.size() == " + to_string(expected_n_vertices) + ", got " + to_string(tf.get_vertices().size()) + "\n";
+				}
+				if (tf.get_edges().size() != expected_n_edges) {
+					u_test.msg += "Expected edges.size() == " + to_string(expected_n_edges) + ", got " + to_string(tf.get_edges().size()) + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit textual_flow_constructor_2
+		 */
+		current_unit = "textual_flow_constructor_2";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Construct a textual flow instance without a specified connectivity:
+				textual_flow tf = textual_flow(vu, witnesses);
+				//Make sure its label matches that of the variation unit:
+				string expected_label = vu.get_label();
+				string label = tf.get_label();
+				if (label != expected_label) {
+					u_test.msg += "Expected label == " + expected_label + ", got " + label + "\n";
+				}
+				//Make sure its readings list is the same length as the variation unit's readings list:
+				unsigned int expected_n_readings = (unsigned int) vu.get_readings().size();
+				if (tf.get_readings().size() != expected_n_readings) {
+					u_test.msg += "Expected readings.size() == " + to_string(expected_n_readings) + ", got " + to_string(tf.get_readings().size()) + "\n";
+				}
+				//Make sure its connectivity value is the same as that of the variation unit:
+				int expected_connectivity = vu.get_connectivity();
+				if (tf.get_connectivity() != expected_connectivity) {
+					u_test.msg += "Expected connectivity == " + to_string(expected_connectivity) + ", got " + to_string(tf.get_connectivity()) + "\n";
+				}
+				//Check that the diagram has the correct number of vertices:
+				unsigned int expected_n_vertices = 5;
+				unsigned int expected_n_edges = 9;
+				if (tf.get_vertices().size() != expected_n_vertices) {
+					u_test.msg += "Expected vertices.size() == " + to_string(expected_n_vertices) + ", got " + to_string(tf.get_vertices().size()) + "\n";
+				}
+				if (tf.get_edges().size() != expected_n_edges) {
+					u_test.msg += "Expected edges.size() == " + to_string(expected_n_edges) + ", got " + to_string(tf.get_edges().size()) + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit textual_flow_builder
+		 */
+		current_unit = "textual_flow_builder";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Construct textual flow instances for all variation units in one pass:
+				textual_flow_builder tfb = textual_flow_builder(witnesses);
+				vector<variation_unit> vus = app.get_variation_units();
+				vector<textual_flow> tfs = tfb.get_textual_flows(vus);
+				if (tfs.size() != vus.size()) {
+					u_test.msg += "Expected textual_flows.size() == " + to_string(vus.size()) + ", got " + to_string(tfs.size()) + "\n";
+				}
+				//Make sure each one matches the textual flow instance constructed directly from its variation unit:
+				for (unsigned int i = 0; i < tfs.size() && i < vus.size(); i++) {
+					textual_flow expected_tf = textual_flow(vus[i], witnesses);
+					list<textual_flow_vertex> expected_vertices = expected_tf.get_vertices();
+					list<textual_flow_vertex> vertices = tfs[i].get_vertices();
+					list<textual_flow_edge> expected_edges = expected_tf.get_edges();
+					list<textual_flow_edge> edges = tfs[i].get_edges();
+					if (tfs[i].get_label() != expected_tf.get_label() || tfs[i].get_connectivity() != expected_tf.get_connectivity()) {
+						u_test.msg += "Expected label and connectivity of " + expected_tf.get_label() + " to match\n";
+					}
+					if (vertices.size() != expected_vertices.size() || !equal(vertices.begin(), vertices.end(), expected_vertices.begin(), [](const textual_flow_vertex & v1, const textual_flow_vertex & v2) {
+						return v1.id == v2.id && v1.rdg == v2.rdg;
+					})) {
+						u_test.msg += "Expected vertices of " + expected_tf.get_label() + " to match\n";
+					}
+					if (edges.size() != expected_edges.size() || !equal(edges.begin(), edges.end(), expected_edges.begin(), [](const textual_flow_edge & e1, const textual_flow_edge & e2) {
+						return e1.ancestor == e2.ancestor && e1.descendant == e2.descendant && e1.type == e2.type && e1.connectivity == e2.connectivity && e1.strength == e2.strength;
+					})) {
+						u_test.msg += "Expected edges of " + expected_tf.get_label() + " to match\n";
+					}
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit textual_flow_builder_threads
+		 */
+		current_unit = "textual_flow_builder_threads";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Serializing all textual flow diagrams with several threads should give the same output as with one:
+				vector<variation_unit> vus = app.get_variation_units();
+				textual_flow_builder tfb = textual_flow_builder(witnesses, 1);
+				stringstream expected_dot;
+				tfb.textual_flows_to_dot(expected_dot, vus);
+				stringstream expected_json;
+				tfb.textual_flows_to_json(expected_json, vus);
+				tfb.set_threads(3);
+				stringstream dot;
+				tfb.textual_flows_to_dot(dot, vus);
+				stringstream json;
+				tfb.textual_flows_to_json(json, vus);
+				if (dot.str() != expected_dot.str()) {
+					u_test.msg += "Expected .dot output with 3 threads to match .dot output with 1 thread\n";
+				}
+				if (json.str() != expected_json.str()) {
+					u_test.msg += "Expected JSON output with 3 threads to match JSON output with 1 thread\n";
+				}
+				//The output should consist of one diagram for each variation unit, in order:
+				stringstream first_dot;
+				textual_flow(vus[0], witnesses).textual_flow_to_dot(first_dot);
+				if (dot.str().compare(0, first_dot.str().size(), first_dot.str()) != 0) {
+					u_test.msg += "Expected .dot output to begin with the diagram for " + vus[0].get_label() + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit textual_flow_builder_ndjson
+		 */
+		current_unit = "textual_flow_builder_ndjson";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Exporting all records with several threads should give the same output as with one:
+				vector<variation_unit> vus = app.get_variation_units();
+				textual_flow_builder tfb = textual_flow_builder(witnesses, 1);
+				stringstream expected_ndjson;
+				tfb.textual_flows_to_ndjson(expected_ndjson, vus, true, true);
+				tfb.set_threads(3);
+				stringstream ndjson;
+				tfb.textual_flows_to_ndjson(ndjson, vus, true, true);
+				if (ndjson.str() != expected_ndjson.str()) {
+					u_test.msg += "Expected NDJSON output with 3 threads to match NDJSON output with 1 thread\n";
+				}
+				//The output should consist of one line for each variation unit, in order, each holding the unit's local stemma and diagrams:
+				string line;
+				unsigned int vu_ind = 0;
+				while (getline(ndjson, line)) {
+					if (vu_ind >= vus.size()) {
+						u_test.msg += "Expected " + to_string(vus.size()) + " NDJSON records, got more\n";
+						break;
+					}
+					const variation_unit & vu = vus[vu_ind];
+					textual_flow tf = textual_flow(vu, witnesses);
+					stringstream expected_record;
+					json_writer writer(expected_record);
+					writer.begin_object();
+					writer.key("id");
+					writer.value(vu.get_id());
+					writer.key("label");
+					writer.value(vu.get_label());
+					writer.key("local_stemma");
+					vu.get_local_stemma().to_json(writer);
+					writer.key("textual_flow");
+					tf.textual_flow_to_json(writer);
+					writer.key("coherence_in_attestations");
+					tf.coherence_in_all_attestations_to_json(writer);
+					writer.key("coherence_in_variant_passages");
+					tf.coherence_in_variant_passages_to_json(writer);
+					writer.end_object();
+					writer.flush();
+					if (line != expected_record.str()) {
+						u_test.msg += "Expected NDJSON record " + to_string(vu_ind) + " to be " + expected_record.str() + ", got " + line + "\n";
+					}
+					vu_ind++;
+				}
+				if (vu_ind != vus.size()) {
+					u_test.msg += "Expected " + to_string(vus.size()) + " NDJSON records, got " + to_string(vu_ind) + "\n";
+				}
+				//Without the optional flags, the records should leave out the coherence diagrams:
+				stringstream minimal_ndjson;
+				tfb.textual_flows_to_ndjson(minimal_ndjson, vus);
+				if (minimal_ndjson.str().find("coherence_in_") != string::npos) {
+					u_test.msg += "Expected NDJSON records without optional diagrams to leave them out, but they did not\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit textual_flow_builder_sweep
+		 */
+		current_unit = "textual_flow_builder_sweep";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//A sweep over several connectivity limits should give the same textual flows as constructing each one separately:
+				textual_flow_builder tfb = textual_flow_builder(witnesses);
+				vector<variation_unit> vus = app.get_variation_units();
+				vector<int> connectivities = vector<int>({1, 2, 5, numeric_limits<int>::max()});
+				vector<vector<textual_flow>> sweeps = tfb.get_textual_flow_sweeps(vus, connectivities);
+				for (unsigned int i = 0; i < vus.size(); i++) {
+					for (unsigned int j = 0; j < connectivities.size(); j++) {
+						textual_flow expected_tf = textual_flow(vus[i], witnesses, connectivities[j]);
+						list<textual_flow_edge> expected_edges = expected_tf.get_edges();
+						list<textual_flow_edge> edges = sweeps[i][j].get_edges();
+						if (sweeps[i][j].get_connectivity() != connectivities[j] || sweeps[i][j].get_vertices().size() != expected_tf.get_vertices().size()) {
+							u_test.msg += "Expected connectivity and vertices of " + expected_tf.get_label() + " at connectivity " + to_string(connectivities[j]) + " to match\n";
+						}
+						if (edges.size() != expected_edges.size() || !equal(edges.begin(), edges.end(), expected_edges.begin(), [](const textual_flow_edge & e1, const textual_flow_edge & e2) {
+							return e1.ancestor == e2.ancestor && e1.descendant == e2.descendant && e1.type == e2.type && e1.connectivity == e2.connectivity;
+						})) {
+							u_test.msg += "Expected edges of " + expected_tf.get_label() + " at connectivity " + to_string(connectivities[j]) + " to match\n";
+						}
+					}
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit textual_flow_coherence_metrics_table
+		 */
+		current_unit = "textual_flow_coherence_metrics_table";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Compute coherence metrics for all variation units, with one row per variation unit:
+				textual_flow_builder tfb = textual_flow_builder(witnesses, 2);
+				vector<variation_unit> vus = app.get_variation_units();
+				coherence_metrics_table cmt = coherence_metrics_table(tfb, vus);
+				list<coherence_metrics_table_row> rows = cmt.get_rows();
+				if (rows.size() != vus.size()) {
+					u_test.msg += "Expected rows.size() == " + to_string(vus.size()) + ", got " + to_string(rows.size()) + "\n";
+				}
+				//Make sure the metrics for each variation unit agree with its textual flow diagram:
+				unsigned int vu_ind = 0;
+				for (coherence_metrics_table_row row : rows) {
+					textual_flow expected_tf = textual_flow(vus[vu_ind], witnesses);
+					int expected_n_edges = 0;
+					int expected_max_con = -1;
+					for (textual_flow_edge e : expected_tf.get_edges()) {
+						expected_n_edges += e.type == flow_type::EQUAL ? 0 : 1;
+						expected_max_con = max(expected_max_con, e.connectivity);
+					}
+					if (row.label != expected_tf.get_label() || row.change + row.loss != expected_n_edges || row.max_con != expected_max_con) {
+						u_test.msg += "Expected CHANGE + LOSS == " + to_string(expected_n_edges) + " and MAXCON == " + to_string(expected_max_con) + " for " + expected_tf.get_label() + ", got " + to_string(row.change + row.loss) + " and " + to_string(row.max_con) + "\n";
+					}
+					//Every reading with at least one witness must have at least one root:
+					for (reading_coherence rc : row.rdgs) {
+						if (rc.wits > 0 && (rc.roots < 1 || rc.roots > rc.wits)) {
+							u_test.msg += "Expected 1 <= roots <= " + to_string(rc.wits) + " for reading " + rc.rdg + " of " + row.label + ", got " + to_string(rc.roots) + "\n";
+						}
+					}
+					vu_ind++;
+				}
+				//Then compute them for a subset of the witnesses without the first one, whose edges can start at ancestors outside of the subset,
+				//and make sure the witnesses and roots of each reading agree with the readings of the ancestors:
+				list<witness> subset_witnesses = list<witness>(next(witnesses.begin()), witnesses.end());
+				textual_flow_builder subset_tfb = textual_flow_builder(subset_witnesses, 2);
+				list<coherence_metrics_table_row> subset_rows = coherence_metrics_table(subset_tfb, vus).get_rows();
+				bool outside_ancestor_found = false;
+				vu_ind = 0;
+				for (coherence_metrics_table_row row : subset_rows) {
+					unordered_map<string, string> reading_support = vus[vu_ind].get_reading_support();
+					map<string, int> expected_wits = map<string, int>();
+					map<string, int> expected_roots = map<string, int>();
+					set<string> processed_descendants = set<string>();
+					list<textual_flow_edge> edges = subset_tfb.get_textual_flow(vus[vu_ind]).get_edges();
+					for (const textual_flow_vertex & v : subset_tfb.get_textual_flow(vus[vu_ind]).get_vertices()) {
+						if (v.rdg.empty()) {
+							continue;
+						}
+						expected_wits[v.rdg]++;
+						bool root = true;
+						for (const textual_flow_edge & e : edges) {
+							if (e.descendant == v.id) {
+								root = reading_support.find(e.ancestor) == reading_support.end() || reading_support.at(e.ancestor) != v.rdg;
+								break;
+							}
+						}
+						expected_roots[v.rdg] += root ? 1 : 0;
+					}
+					for (const textual_flow_edge & e : edges) {
+						outside_ancestor_found = outside_ancestor_found || e.ancestor == witnesses.front().get_id();
+					}
+					for (reading_coherence rc : row.rdgs) {
+						if (rc.wits != expected_wits[rc.rdg] || rc.roots != expected_roots[rc.rdg]) {
+							u_test.msg += "Expected " + to_string(expected_wits[rc.rdg]) + " witnesses and " + to_string(expected_roots[rc.rdg]) + " roots for reading " + rc.rdg + " of " + row.label + " in the subset, got " + to_string(rc.wits) + " and " + to_string(rc.roots) + "\n";
+						}
+					}
+					vu_ind++;
+				}
+				if (!outside_ancestor_found) {
+					u_test.msg += "Expected an edge from " + witnesses.front().get_id() + " to a witness in the subset\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
 		}
+		//Do more pre-test work:
+		textual_flow tf = textual_flow(vu, witnesses);
 		/**
-		 * Unit textual_flow_constructor_1
+		 * Unit test textual_flow_textual_flow_to_dot
 		 */
-		current_unit = "textual_flow_constructor_1";
+		current_unit = "textual_flow_textual_flow_to_dot";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1428,32 +2778,12 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				//Construct a textual flow instance with a connectivity of 2:
-				textual_flow tf = textual_flow(vu, witnesses, 2);
-				//Make sure its label matches that of the variation unit:
-				string expected_label = vu.get_label();
-				string label = tf.get_label();
-				if (label != expected_label) {
-					u_test.msg += "Expected label == " + expected_label + ", got " + label + "\n";
-				}
-				//Make sure its readings list is the same length as the variation unit's readings list:
-				unsigned int expected_n_readings = (unsigned int) vu.get_readings().size();
-				if (tf.get_readings().size() != expected_n_readings) {
-					u_test.msg += "Expected readings.size() == " + to_string(expected_n_readings) + ", got " + to_string(tf.get_readings().size()) + "\n";
-				}
-				//Make sure its connectivity value is the specified amount:
-				int expected_connectivity = 2;
-				if (tf.get_connectivity() != expected_connectivity) {
-					u_test.msg += "Expected connectivity == " + to_string(expected_connectivity) + ", got " + to_string(tf.get_connectivity()) + "\n";
-				}
-				//Check that the diagram has the correct number of vertices:
-				unsigned int expected_n_vertices = 5;
-				unsigned int expected_n_edges = 9;
-				if (tf.get_vertices().size() != expected_n_vertices) {
-					u_test.msg += "Expected vertices.size() == " + to_string(expected_n_vertices) + ", got " + to_string(tf.get_vertices().size()) + "\n";
-				}
-				if (tf.get_edges().size() != expected_n_edges) {
-					u_test.msg += "Expected edges.size() == " + to_string(expected_n_edges) + ", got " + to_string(tf.get_edges().size()) + "\n";
+				//Test .dot serialization of complete textual flow graph:
+				stringstream ss;
+				tf.textual_flow_to_dot(ss, false);
+				string out = ss.str();
+				if (out.empty()) {
+					u_test.msg += "The .dot serialization was empty.\n";
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1465,9 +2795,9 @@ void autotest::run() {
 			mod_test.units.push_back(u_test);
 		}
 		/**
-		 * Unit textual_flow_constructor_2
+		 * Unit test textual_flow_builder_outside_ancestors_to_dot
 		 */
-		current_unit = "textual_flow_constructor_2";
+		current_unit = "textual_flow_builder_outside_ancestors_to_dot";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1476,32 +2806,34 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				//Construct a textual flow instance without a specified connectivity:
-				textual_flow tf = textual_flow(vu, witnesses);
-				//Make sure its label matches that of the variation unit:
-				string expected_label = vu.get_label();
-				string label = tf.get_label();
-				if (label != expected_label) {
-					u_test.msg += "Expected label == " + expected_label + ", got " + label + "\n";
-				}
-				//Make sure its readings list is the same length as the variation unit's readings list:
-				unsigned int expected_n_readings = (unsigned int) vu.get_readings().size();
-				if (tf.get_readings().size() != expected_n_readings) {
-					u_test.msg += "Expected readings.size() == " + to_string(expected_n_readings) + ", got " + to_string(tf.get_readings().size()) + "\n";
-				}
-				//Make sure its connectivity value is the same as that of the variation unit:
-				int expected_connectivity = vu.get_connectivity();
-				if (tf.get_connectivity() != expected_connectivity) {
-					u_test.msg += "Expected connectivity == " + to_string(expected_connectivity) + ", got " + to_string(tf.get_connectivity()) + "\n";
-				}
-				//Check that the diagram has the correct number of vertices:
-				unsigned int expected_n_vertices = 5;
-				unsigned int expected_n_edges = 9;
-				if (tf.get_vertices().size() != expected_n_vertices) {
-					u_test.msg += "Expected vertices.size() == " + to_string(expected_n_vertices) + ", got " + to_string(tf.get_vertices().size()) + "\n";
-				}
-				if (tf.get_edges().size() != expected_n_edges) {
-					u_test.msg += "Expected edges.size() == " + to_string(expected_n_edges) + ", got " + to_string(tf.get_edges().size()) + "\n";
+				//For a builder constructed from a subset of the witnesses without the first one, edges can start at ancestors outside of the subset;
+				//make sure every edge of every diagram starts and ends at a node declared earlier in the same graph:
+				list<witness> subset_witnesses = list<witness>(next(witnesses.begin()), witnesses.end());
+				textual_flow_builder subset_tfb = textual_flow_builder(subset_witnesses);
+				for (const variation_unit & subset_vu : app.get_variation_units()) {
+					textual_flow subset_tf = subset_tfb.get_textual_flow(subset_vu);
+					stringstream subset_ss;
+					subset_tf.textual_flow_to_dot(subset_ss, false);
+					subset_tf.coherence_in_all_attestations_to_dot(subset_ss, false);
+					subset_tf.coherence_in_variant_passages_to_dot(subset_ss, false);
+					set<string> declared_nodes = set<string>();
+					string line;
+					while (getline(subset_ss, line)) {
+						size_t start = line.find_first_not_of('\t');
+						if (line.compare(start, 7, "digraph") == 0) {
+							declared_nodes.clear();
+						}
+						else if (line.find(" [label=") != string::npos && line.find(" -> ") == string::npos) {
+							declared_nodes.insert(line.substr(start, line.find(" [label=") - start));
+						}
+						else if (line.find(" -> ") != string::npos) {
+							string ancestor = line.substr(start, line.find(" -> ") - start);
+							string descendant = line.substr(line.find(" -> ") + 4, line.find(" [") - line.find(" -> ") - 4);
+							if (declared_nodes.find(ancestor) == declared_nodes.end() || declared_nodes.find(descendant) == declared_nodes.end()) {
+								u_test.msg += "Expected both ends of the edge " + ancestor + " -> " + descendant + " in a diagram for " + subset_vu.get_label() + " to be declared as nodes\n";
+							}
+						}
+					}
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1512,12 +2844,10 @@ void autotest::run() {
 			}
 			mod_test.units.push_back(u_test);
 		}
-		//Do more pre-test work:
-		textual_flow tf = textual_flow(vu, witnesses);
 		/**
-		 * Unit test textual_flow_textual_flow_diagram_to_dot
+		 * Unit test textual_flow_textual_flow_to_json
 		 */
-		current_unit = "textual_flow_textual_flow_diagram_to_dot";
+		current_unit = "textual_flow_textual_flow_to_json";
 		if (target_test.empty() || target_test == current_unit) {
 			//Initialize a container for module-wide test results:
 			unit_test u_test;
@@ -1526,12 +2856,25 @@ void autotest::run() {
 			u_test.msg = "";
 			//Run the test:
 			try {
-				//Test .dot serialization of complete textual flow graph:
+				//Test JSON serialization of complete textual flow graph:
 				stringstream ss;
-				tf.textual_flow_to_dot(ss, false);
+				tf.textual_flow_to_json(ss);
 				string out = ss.str();
-				if (out.empty()) {
-					u_test.msg += "The .dot serialization was empty.\n";
+				if (out.empty() || out.front() != '{' || out.back() != '}') {
+					u_test.msg += "Expected the JSON serialization to be an object, got " + out + "\n";
+				}
+				//No object or array should end with a comma:
+				if (out.find(",}") != string::npos || out.find(",]") != string::npos) {
+					u_test.msg += "Expected no trailing commas in the JSON serialization, got " + out + "\n";
+				}
+				//There should be one object with a reading for each vertex:
+				unsigned int expected_n_vertices = (unsigned int) tf.get_vertices().size();
+				unsigned int n_vertices = 0;
+				for (size_t pos = out.find("\"rdg\":"); pos != string::npos; pos = out.find("\"rdg\":", pos + 1)) {
+					n_vertices++;
+				}
+				if (n_vertices != expected_n_vertices) {
+					u_test.msg += "Expected " + to_string(expected_n_vertices) + " vertices in the JSON serialization, got " + to_string(n_vertices) + "\n";
 				}
 				if (u_test.msg.empty()) {
 					u_test.passed = true;
@@ -1570,6 +2913,46 @@ void autotest::run() {
 			}
 			mod_test.units.push_back(u_test);
 		}
+		/**
+		 * Unit test textual_flow_coherence_in_all_attestations_to_dot
+		 */
+		current_unit = "textual_flow_coherence_in_all_attestations_to_dot";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//The combined .dot serialization should consist of the coherence in attestations graphs of all readings, in order:
+				stringstream expected_ss;
+				for (string rdg : tf.get_readings()) {
+					tf.coherence_in_attestations_to_dot(expected_ss, rdg, false);
+				}
+				stringstream ss;
+				tf.coherence_in_all_attestations_to_dot(ss, false);
+				if (ss.str() != expected_ss.str()) {
+					u_test.msg += "Expected the combined .dot serialization to match the serializations for each reading\n";
+				}
+				//Serializing to separate streams should write only the readings with streams:
+				stringstream expected_b_ss;
+				tf.coherence_in_attestations_to_dot(expected_b_ss, "b", false);
+				stringstream b_ss;
+				map<string, ostream *> outs = map<string, ostream *>({{"b", &b_ss}});
+				tf.coherence_in_all_attestations_to_dot(outs, false);
+				if (b_ss.str() != expected_b_ss.str()) {
+					u_test.msg += "Expected the .dot serialization for reading b to match\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
 		/**
 		 * Unit test textual_flow_coherence_in_variant_passages_to_dot
 		 */
@@ -1698,6 +3081,332 @@ void autotest::run() {
 			}
 			mod_test.units.push_back(u_test);
 		}
+		//Do more pre-test work:
+		//Construct a small global stemma with a redundant edge (A -> C) and a cycle (C -> D -> C):
+		list<global_stemma_vertex> graph_vertices = list<global_stemma_vertex>();
+		for (string graph_id : list<string>({"A", "B", "C", "D", "E"})) {
+			global_stemma_vertex v;
+			v.id = graph_id;
+			graph_vertices.push_back(v);
+		}
+		list<global_stemma_edge> graph_edges = list<global_stemma_edge>();
+		for (pair<string, string> graph_edge : list<pair<string, string>>({{"A", "B"}, {"B", "C"}, {"A", "C"}, {"C", "D"}, {"D", "C"}, {"D", "E"}})) {
+			global_stemma_edge e;
+			e.ancestor = graph_edge.first;
+			e.descendant = graph_edge.second;
+			e.length = 1;
+			e.strength = 1;
+			graph_edges.push_back(e);
+		}
+		global_stemma graph = global_stemma(graph_vertices, graph_edges);
+		/**
+		 * Unit global_stemma_cycles
+		 */
+		current_unit = "global_stemma_cycles";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//The global stemma for the test apparatus should be acyclic:
+				if (!gs.is_acyclic()) {
+					u_test.msg += "Expected is_acyclic() == true for the test apparatus's global stemma, got false\n";
+				}
+				//The small global stemma should have one cycle, consisting of C and D:
+				list<list<string>> cycles = graph.get_cycles();
+				list<list<string>> expected_cycles = list<list<string>>({{"C", "D"}});
+				if (cycles != expected_cycles) {
+					u_test.msg += "Expected get_cycles() to return the single cycle {C, D}, got " + to_string(cycles.size()) + " cycles\n";
+				}
+				if (graph.is_acyclic()) {
+					u_test.msg += "Expected is_acyclic() == false, got true\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit global_stemma_transitive_reduction
+		 */
+		current_unit = "global_stemma_transitive_reduction";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//The transitive reduction of the small global stemma should drop only the redundant edge A -> C:
+				list<global_stemma_edge> edges = graph.get_transitive_reduction().get_edges();
+				list<string> edge_strings = list<string>();
+				for (const global_stemma_edge & e : edges) {
+					edge_strings.push_back(e.ancestor + " -> " + e.descendant);
+				}
+				list<string> expected_edge_strings = list<string>({"A -> B", "B -> C", "C -> D", "D -> C", "D -> E"});
+				if (edge_strings != expected_edge_strings) {
+					u_test.msg += "Expected get_transitive_reduction().get_edges().size() == " + to_string(expected_edge_strings.size()) + " with A -> C removed, got " + to_string(edge_strings.size()) + "\n";
+				}
+				//The test apparatus's global stemma has no redundant edges:
+				if (gs.get_transitive_reduction().get_edges().size() != gs.get_edges().size()) {
+					u_test.msg += "Expected the transitive reduction of the test apparatus's global stemma to keep all " + to_string(gs.get_edges().size()) + " edges, got " + to_string(gs.get_transitive_reduction().get_edges().size()) + "\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit global_stemma_generations
+		 */
+		current_unit = "global_stemma_generations";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//The vertices on the cycle should share a generation, one after that of their latest ancestor:
+				unordered_map<string, unsigned int> generations = graph.get_generations();
+				map<string, unsigned int> expected_generations = map<string, unsigned int>({{"A", 0}, {"B", 1}, {"C", 2}, {"D", 2}, {"E", 3}});
+				for (pair<string, unsigned int> kv : expected_generations) {
+					if (generations.at(kv.first) != kv.second) {
+						u_test.msg += "Expected get_generations().at(\"" + kv.first + "\") == " + to_string(kv.second) + ", got " + to_string(generations.at(kv.first)) + "\n";
+					}
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit global_stemma_pipeline
+		 */
+		current_unit = "global_stemma_pipeline";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Run the whole pipeline on two threads and check that it agrees with the serial construction:
+				global_stemma_pipeline gsp = global_stemma_pipeline(app, false, 2);
+				list<witness> pipeline_witnesses = gsp.get_witnesses();
+				if (pipeline_witnesses.size() != witnesses.size()) {
+					u_test.msg += "Expected get_witnesses().size() == " + to_string(witnesses.size()) + ", got " + to_string(pipeline_witnesses.size()) + "\n";
+				}
+				if (gsp.get_solver_stats().size() != witnesses.size()) {
+					u_test.msg += "Expected get_solver_stats().size() == " + to_string(witnesses.size()) + ", got " + to_string(gsp.get_solver_stats().size()) + "\n";
+				}
+				list<global_stemma_edge> expected_edges = gs.get_edges();
+				list<global_stemma_edge> edges = gsp.get_global_stemma().get_edges();
+				if (gsp.get_global_stemma().get_vertices().size() != gs.get_vertices().size()) {
+					u_test.msg += "Expected get_global_stemma().get_vertices().size() == " + to_string(gs.get_vertices().size()) + ", got " + to_string(gsp.get_global_stemma().get_vertices().size()) + "\n";
+				}
+				if (edges.size() != expected_edges.size()) {
+					u_test.msg += "Expected get_global_stemma().get_edges().size() == " + to_string(expected_edges.size()) + ", got " + to_string(edges.size()) + "\n";
+				}
+				else {
+					list<global_stemma_edge>::const_iterator it = edges.begin();
+					for (const global_stemma_edge & expected_edge : expected_edges) {
+						if (it->ancestor != expected_edge.ancestor || it->descendant != expected_edge.descendant) {
+							u_test.msg += "Expected edge " + expected_edge.ancestor + " -> " + expected_edge.descendant + ", got " + it->ancestor + " -> " + it->descendant + "\n";
+						}
+						it++;
+					}
+				}
+				global_stemma_pipeline_timing timing = gsp.get_timing();
+				if (timing.total_time < timing.witnesses_time + timing.substemmata_time + timing.stemma_time - 1e-6) {
+					u_test.msg += "Expected get_timing().total_time to be at least the sum of the stage times\n";
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit global_stemma_pipeline_checkpoint
+		 */
+		current_unit = "global_stemma_pipeline_checkpoint";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				string checkpoint_path = "global_stemma_pipeline_checkpoint.tsv";
+				remove(checkpoint_path.c_str());
+				list<global_stemma_edge> expected_edges = global_stemma_pipeline(app).get_global_stemma().get_edges();
+				//Run the pipeline with a new checkpoint, which should solve every witness and record it:
+				global_stemma_pipeline first_run = global_stemma_pipeline(app, checkpoint_path, false, 2);
+				if (first_run.get_n_resumed() != 0) {
+					u_test.msg += "Expected get_n_resumed() == 0 for a new checkpoint, got " + to_string(first_run.get_n_resumed()) + "\n";
+				}
+				//Then simulate a run that was killed after solving two witnesses, while it was writing the third:
+				ifstream in(checkpoint_path);
+				vector<string> lines = vector<string>();
+				string line;
+				while (getline(in, line)) {
+					lines.push_back(line);
+				}
+				in.close();
+				if (lines.size() != witnesses.size() + 1) {
+					u_test.msg += "Expected the checkpoint file to have " + to_string(witnesses.size() + 1) + " lines, got " + to_string(lines.size()) + "\n";
+				}
+				else {
+					ofstream out(checkpoint_path, ios::out | ios::trunc);
+					out << lines[0] << "\n" << lines[1] << "\n" << lines[2] << "\n" << lines[3].substr(0, 1);
+					out.close();
+					//Resuming from the truncated checkpoint should skip the two solved witnesses and give the same global stemma:
+					global_stemma_pipeline resumed_run = global_stemma_pipeline(app, checkpoint_path, false, 2);
+					unsigned int expected_n_resumed = 2;
+					if (resumed_run.get_n_resumed() != expected_n_resumed) {
+						u_test.msg += "Expected get_n_resumed() == " + to_string(expected_n_resumed) + " for the truncated checkpoint, got " + to_string(resumed_run.get_n_resumed()) + "\n";
+					}
+					list<global_stemma_edge> edges = resumed_run.get_global_stemma().get_edges();
+					if (edges.size() != expected_edges.size()) {
+						u_test.msg += "Expected get_edges().size() == " + to_string(expected_edges.size()) + " after resuming, got " + to_string(edges.size()) + "\n";
+					}
+					else {
+						list<global_stemma_edge>::const_iterator it = edges.begin();
+						for (const global_stemma_edge & expected_edge : expected_edges) {
+							if (it->ancestor != expected_edge.ancestor || it->descendant != expected_edge.descendant) {
+								u_test.msg += "Expected edge " + expected_edge.ancestor + " -> " + expected_edge.descendant + " after resuming, got " + it->ancestor + " -> " + it->descendant + "\n";
+							}
+							it++;
+						}
+					}
+					//The checkpoint should now contain every witness:
+					substemma_checkpoint checkpoint(checkpoint_path, substemma_checkpoint::get_key(app, false));
+					if (checkpoint.size() != witnesses.size()) {
+						u_test.msg += "Expected the resumed checkpoint to contain " + to_string(witnesses.size()) + " witnesses, got " + to_string(checkpoint.size()) + "\n";
+					}
+				}
+				//A checkpoint killed while writing its header should be overwritten rather than rejected, both now and on the next start:
+				string key = substemma_checkpoint::get_key(app, false);
+				ofstream partial_out(checkpoint_path, ios::out | ios::trunc);
+				partial_out << "open-cbgm substemma check";
+				partial_out.close();
+				try {
+					substemma_checkpoint restarted_checkpoint(checkpoint_path, key);
+					substemma_checkpoint reopened_checkpoint(checkpoint_path, key);
+					if (reopened_checkpoint.size() != 0) {
+						u_test.msg += "Expected a checkpoint with a cut-off header to be recreated empty, got " + to_string(reopened_checkpoint.size()) + " witnesses\n";
+					}
+				}
+				catch (const runtime_error & e) {
+					u_test.msg += "Expected a checkpoint with a cut-off header to be recreated, got the error " + string(e.what()) + "\n";
+				}
+				//A checkpoint written with different options should be rejected:
+				bool rejected = false;
+				try {
+					global_stemma_pipeline classic_run = global_stemma_pipeline(app, checkpoint_path, true, 2);
+				}
+				catch (const runtime_error &) {
+					rejected = true;
+				}
+				if (!rejected) {
+					u_test.msg += "Expected a runtime_error for a checkpoint written with different options\n";
+				}
+				remove(checkpoint_path.c_str());
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
+		/**
+		 * Unit global_stemma_update
+		 */
+		current_unit = "global_stemma_update";
+		if (target_test.empty() || target_test == current_unit) {
+			//Initialize a container for module-wide test results:
+			unit_test u_test;
+			u_test.name = current_unit;
+			u_test.passed = false;
+			u_test.msg = "";
+			//Run the test:
+			try {
+				//Treat an apparatus without trivial readings as an edit of the original one (in which the local stemma of the third variation unit changes),
+				//and check that updating the global stemma with every variation unit marked as changed agrees with building it from scratch:
+				apparatus edited_app = apparatus(tei_node, merge_splits, set<string>(), dropped_reading_types, ignored_suffixes);
+				global_stemma_pipeline gsp = global_stemma_pipeline(app);
+				list<witness> updated_witnesses = gsp.get_witnesses();
+				global_stemma updated_gs = gsp.get_global_stemma();
+				set<unsigned int> vu_inds = set<unsigned int>();
+				for (unsigned int vu_ind = 0; vu_ind < app.get_variation_units().size(); vu_ind++) {
+					vu_inds.insert(vu_ind);
+				}
+				list<string> updated_ids = updated_gs.update(updated_witnesses, app, edited_app, vu_inds, false, 2);
+				list<string> expected_updated_ids = list<string>({"C", "E"});
+				if (updated_ids != expected_updated_ids) {
+					u_test.msg += "Expected update to optimize the substemmata of " + to_string(expected_updated_ids.size()) + " witnesses, got " + to_string(updated_ids.size()) + "\n";
+				}
+				list<global_stemma_edge> expected_edges = global_stemma_pipeline(edited_app).get_global_stemma().get_edges();
+				list<global_stemma_edge> edges = updated_gs.get_edges();
+				if (edges.size() != expected_edges.size()) {
+					u_test.msg += "Expected get_edges().size() == " + to_string(expected_edges.size()) + ", got " + to_string(edges.size()) + "\n";
+				}
+				else {
+					list<global_stemma_edge>::const_iterator it = edges.begin();
+					for (const global_stemma_edge & expected_edge : expected_edges) {
+						if (it->ancestor != expected_edge.ancestor || it->descendant != expected_edge.descendant || it->length != expected_edge.length || it->strength != expected_edge.strength) {
+							u_test.msg += "Expected edge " + expected_edge.ancestor + " -> " + expected_edge.descendant + " with length " + to_string(expected_edge.length) + ", got " + it->ancestor + " -> " + it->descendant + " with length " + to_string(it->length) + "\n";
+						}
+						it++;
+					}
+				}
+				//Then revert the edit, and check that the costs of the genealogical comparisons are exactly those of the original witnesses:
+				updated_gs.update(updated_witnesses, edited_app, app, vu_inds, false, 2);
+				list<witness> original_witnesses = gsp.get_witnesses();
+				list<witness>::const_iterator wit_it = updated_witnesses.begin();
+				for (const witness & original_wit : original_witnesses) {
+					for (const pair<const string, genealogical_comparison> & kv : original_wit.get_genealogical_comparisons()) {
+						float cost = wit_it->get_genealogical_comparison_ref(kv.first).cost;
+						if (cost != kv.second.cost) {
+							u_test.msg += "Expected the cost of the comparison of " + original_wit.get_id() + " to " + kv.first + " to be " + to_string(kv.second.cost) + " after reverting the edit, got " + to_string(cost) + "\n";
+						}
+					}
+					wit_it++;
+				}
+				if (u_test.msg.empty()) {
+					u_test.passed = true;
+				}
+			}
+			catch (const exception & e) {
+				u_test.msg += string(e.what()) + "\n";
+			}
+			mod_test.units.push_back(u_test);
+		}
 		lib_test.modules.push_back(mod_test);
 	}
 }
@@ -1764,14 +3473,14 @@ int main(int argc, char* argv[]) {
 	});
 	//Initialize the map of unit tests, keyed by parent module name:
 	map<string, list<string>> tests_by_module = map<string, list<string>>({
-		{"common", {"common_read_xml"}},
+		{"common", {"common_read_xml", "common_dense_bitset", "common_parallel_for", "common_json_writer", "common_dot_writer"}},
 		{"local_stemma", {"local_stemma_constructor_1", "local_stemma_constructor_2", "local_stemma_path_exists", "local_stemma_get_path", "local_stemma_common_ancestor_exists", "local_stemma_readings_agree", "local_stemma_to_dot"}},
 		{"variation_unit", {"variation_unit_constructor_1", "variation_unit_constructor_2", "variation_unit_constructor_3", "variation_unit_constructor_4", "variation_unit_get_base_siglum"}},
 		{"apparatus", {"apparatus_constructor", "apparatus_get_extant_passages_for_witness"}},
-		{"set_cover_solver", {"set_cover_solver_constructor", "set_cover_solver_get_unique_rows", "set_cover_solver_get_greedy_solution"}},
-		{"witness", {"witness_constructor_1", "witness_constructor_2", "witness_get_genealogical_comparison_for_witness_1", "witness_get_genealogical_comparison_for_witness_2", "witness_get_genealogical_comparison_for_witness_3", "witness_get_substemmata", "witness_get_substemmata_single_solution"}},
-		{"textual_flow", {"textual_flow_constructor_1", "textual_flow_constructor_2", "textual_flow_textual_flow_to_dot", "textual_flow_coherence_in_attestations_to_dot", "textual_flow_coherence_in_variant_passages_to_dot"}},
-		{"global_stemma", {"global_stemma_constructor", "global_stemma_to_dot"}}
+		{"set_cover_solver", {"set_cover_solver_constructor", "set_cover_solver_get_unique_rows", "set_cover_solver_get_greedy_solution", "set_cover_solver_get_greedy_solution_local_search", "set_cover_solver_branch_on_column", "set_cover_solver_meet_in_the_middle", "set_cover_solver_get_stats", "set_cover_solver_solution_enumerator", "set_cover_solver_solve_cheapest", "set_cover_solver_solve_cheapest_unbounded", "set_cover_solver_fixed_upper_bound_rounding"}},
+		{"witness", {"witness_constructor_1", "witness_constructor_2", "witness_get_genealogical_comparison_for_witness_1", "witness_get_genealogical_comparison_for_witness_2", "witness_get_genealogical_comparison_for_witness_3", "witness_get_substemmata", "witness_get_substemmata_single_solution", "witness_comparison_matrix", "witness_comparison_matrix_to_npy", "witness_comparison_matrix_tables", "witness_find_relatives_wide_table", "witness_enumerate_relationships_table"}},
+		{"textual_flow", {"textual_flow_constructor_1", "textual_flow_constructor_2", "textual_flow_builder", "textual_flow_builder_threads", "textual_flow_builder_ndjson", "textual_flow_builder_sweep", "textual_flow_coherence_metrics_table", "textual_flow_textual_flow_to_dot", "textual_flow_builder_outside_ancestors_to_dot", "textual_flow_textual_flow_to_json", "textual_flow_coherence_in_attestations_to_dot", "textual_flow_coherence_in_all_attestations_to_dot", "textual_flow_coherence_in_variant_passages_to_dot"}},
+		{"global_stemma", {"global_stemma_constructor", "global_stemma_to_dot", "global_stemma_cycles", "global_stemma_transitive_reduction", "global_stemma_generations", "global_stemma_pipeline", "global_stemma_pipeline_checkpoint", "global_stemma_update"}}
 	});
 	//Initialize an autotest instance with these containers:
 	autotest at = autotest(modules, tests_by_module);
@@ -0,0 +1 @@
+#define EXAMPLES_DIR "/root/repo/examples"